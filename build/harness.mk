@@ -1,6 +1,8 @@
 TEST_SRC = \
 	$(SRC)/Computer/FlyingComputer.cpp \
 	$(SRC)/Replay/IGCParser.cpp \
+	$(SRC)/Replay/IGCFixArray.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/Replay/IgcReplay.cpp \
 	$(SRC)/Replay/TaskAutoPilot.cpp \
 	$(SRC)/Replay/AircraftSim.cpp \
@@ -11,6 +11,7 @@ HOT_SOURCES = \
 	$(SRC)/Terrain/RasterMap.cpp \
 	$(SRC)/Terrain/HeightMatrix.cpp \
 	$(SRC)/Terrain/RasterRenderer.cpp \
+	$(SRC)/Terrain/SlopeShading.cpp \
 	$(SRC)/Terrain/RasterTile.cpp \
 	$(SRC)/Projection.cpp \
 	$(SRC)/Geo/GeoClip.cpp \
@@ -20,6 +21,7 @@ HOT_SOURCES = \
 	$(ENGINE_SRC_DIR)/Navigation/ConvexHull/GrahamScan.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/ConvexHull/PolygonInterior.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/Flat/FlatRay.cpp \
+	$(ENGINE_SRC_DIR)/Navigation/SearchPolygon.cpp \
 	$(ENGINE_SRC_DIR)/Route/ReachFan.cpp \
 	$(ENGINE_SRC_DIR)/Route/RoutePolar.cpp \
 	$(ENGINE_SRC_DIR)/Task/Tasks/PathSolvers/ContestDijkstra.cpp \
@@ -11,6 +11,7 @@ TASK_SRC	:=\
 	$(ENGINE_SRC_DIR)/Airspace/AirspaceCircle.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/AirspacePolygon.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/Airspaces.cpp \
+	$(ENGINE_SRC_DIR)/Airspace/AirspaceCandidateSet.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/AirspaceIntersectSort.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/AirspaceNearestSort.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/AirspaceSoonestSort.cpp \
@@ -31,6 +32,7 @@ TASK_SRC	:=\
 	$(ENGINE_SRC_DIR)/Navigation/GeoPoint.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/SearchPoint.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/SearchPointVector.cpp \
+	$(ENGINE_SRC_DIR)/Navigation/SearchPolygon.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/TracePoint.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/TaskProjection.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/ConvexHull/GrahamScan.cpp \
@@ -145,7 +147,8 @@ TASK_SRC	:=\
 	$(ENGINE_SRC_DIR)/Util/Serialiser.cpp \
 	$(ENGINE_SRC_DIR)/Util/Deserialiser.cpp \
 	$(ENGINE_SRC_DIR)/Util/DataNodeXML.cpp \
-	$(ENGINE_SRC_DIR)/Util/DataNode.cpp
+	$(ENGINE_SRC_DIR)/Util/DataNode.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp
 
 
 ENGINE_CORE_LIBS = $(TARGET_OUTPUT_DIR)/task.a
@@ -56,6 +56,8 @@ TEST_NAMES = \
 	TestOverwritingRingBuffer \
 	TestDateTime \
 	TestMathTables \
+	TestSlopeShading \
+	TestThreadPool \
 	TestAngle TestUnits TestEarth TestSunEphemeris \
 	TestValidity TestUTM TestProfile \
 	TestRadixTree TestGeoBounds TestGeoClip \
@@ -65,6 +67,8 @@ TEST_NAMES = \
 	TestColorRamp TestGeoPoint TestDiffFilter \
 	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
 	test_replay_task TestProjection TestFlatPoint TestFlatLine TestFlatGeoPoint \
+	TestSearchPolygon TestAirspacePolygon TestAirspaceCandidateSet \
+	TestOLCTriangle TestTraceThinning \
 	TestPlanes \
 	TestTaskPoint \
 	TestTaskWaypoint \
@@ -86,6 +90,8 @@ $(TARGET_BIN_DIR)/TestOverwritingRingBuffer$(TARGET_EXEEXT): $(TEST_OVERWRITING_
 
 TEST_IGC_PARSER_SOURCES = \
 	$(SRC)/Replay/IGCParser.cpp \
+	$(SRC)/Replay/IGCFixArray.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestIGCParser.cpp
 TEST_IGC_PARSER_OBJS = $(call SRC_TO_OBJ,$(TEST_IGC_PARSER_SOURCES))
@@ -109,6 +115,7 @@ $(TARGET_BIN_DIR)/TestMETARParser$(TARGET_EXEEXT): $(TEST_METAR_PARSER_OBJS) $(T
 
 TEST_AIRSPACE_PARSER_SOURCES = \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Units/Units.cpp \
 	$(SRC)/Operation.cpp \
 	$(TEST_SRC_DIR)/FakeDialogs.cpp \
@@ -179,6 +186,7 @@ $(TARGET_BIN_DIR)/TestZeroFinder$(TARGET_EXEEXT): $(TEST_ZEROFINDER_OBJS) $(TEST
 
 TEST_TASKPOINT_SOURCES = \
 	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/GeoPoint.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/Aircraft.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/Geometry/GeoVector.cpp \
@@ -193,6 +201,7 @@ $(TARGET_BIN_DIR)/TestTaskPoint$(TARGET_EXEEXT): $(TEST_TASKPOINT_OBJS) $(TEST_T
 TEST_TASKWAYPOINT_SOURCES = \
 	$(SRC)/Util/UTF8.cpp \
 	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/GeoPoint.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/Aircraft.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/Geometry/GeoVector.cpp \
@@ -210,13 +219,16 @@ TEST_TROUTE_SOURCES = \
 	$(SRC)/Engine/Util/DataNodeXML.cpp \
 	$(SRC)/xmlParser.cpp \
 	$(SRC)/Terrain/RasterTile.cpp \
+	$(SRC)/Terrain/RasterTileStore.cpp \
 	$(SRC)/Terrain/RasterMap.cpp \
 	$(SRC)/Terrain/RasterBuffer.cpp \
 	$(SRC)/Terrain/RasterProjection.cpp \
 	$(SRC)/Geo/GeoClip.cpp \
 	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/OS/PathName.cpp \
 	$(SRC)/Engine/Math/Earth.cpp \
+	$(SRC)/Engine/Util/PerfCounters.cpp \
 	$(SRC)/Operation.cpp \
 	$(TEST_SRC_DIR)/test_troute.cpp
 TEST_TROUTE_OBJS = $(call SRC_TO_OBJ,$(TEST_TROUTE_SOURCES))
@@ -235,13 +247,16 @@ TEST_REACH_SOURCES = \
 	$(SRC)/Engine/Util/DataNodeXML.cpp \
 	$(SRC)/xmlParser.cpp \
 	$(SRC)/Terrain/RasterTile.cpp \
+	$(SRC)/Terrain/RasterTileStore.cpp \
 	$(SRC)/Terrain/RasterMap.cpp \
 	$(SRC)/Terrain/RasterBuffer.cpp \
 	$(SRC)/Terrain/RasterProjection.cpp \
 	$(SRC)/Geo/GeoClip.cpp \
 	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/OS/PathName.cpp \
 	$(SRC)/Engine/Math/Earth.cpp \
+	$(SRC)/Engine/Util/PerfCounters.cpp \
 	$(SRC)/Operation.cpp \
 	$(TEST_SRC_DIR)/test_reach.cpp
 TEST_REACH_OBJS = $(call SRC_TO_OBJ,$(TEST_REACH_SOURCES))
@@ -260,13 +275,16 @@ TEST_ROUTE_SOURCES = \
 	$(SRC)/Engine/Util/DataNodeXML.cpp \
 	$(SRC)/xmlParser.cpp \
 	$(SRC)/Terrain/RasterTile.cpp \
+	$(SRC)/Terrain/RasterTileStore.cpp \
 	$(SRC)/Terrain/RasterMap.cpp \
 	$(SRC)/Terrain/RasterBuffer.cpp \
 	$(SRC)/Terrain/RasterProjection.cpp \
 	$(SRC)/Geo/GeoClip.cpp \
 	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/OS/PathName.cpp \
 	$(SRC)/Engine/Math/Earth.cpp \
+	$(SRC)/Engine/Util/PerfCounters.cpp \
 	$(SRC)/Operation.cpp \
 	$(TEST_SRC_DIR)/test_route.cpp
 TEST_ROUTE_OBJS = $(call SRC_TO_OBJ,$(TEST_ROUTE_SOURCES))
@@ -311,6 +329,31 @@ $(TARGET_BIN_DIR)/test_load_task$(TARGET_EXEEXT): $(TEST_LOAD_TASK_OBJS) $(TEST_
 	@$(NQ)echo "  LINK    $@"
 	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
 
+TEST_SLOPE_SHADING_SOURCES = \
+	$(SRC)/Terrain/SlopeShading.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestSlopeShading.cpp
+TEST_SLOPE_SHADING_OBJS = $(call SRC_TO_OBJ,$(TEST_SLOPE_SHADING_SOURCES))
+TEST_SLOPE_SHADING_LDADD = $(MATH_LIBS)
+$(TARGET_BIN_DIR)/TestSlopeShading$(TARGET_EXEEXT): $(TEST_SLOPE_SHADING_OBJS) $(TEST_SLOPE_SHADING_LDADD) | $(TARGET_BIN_DIR)/dirstamp
+	@$(NQ)echo "  LINK    $@"
+	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
+
+TEST_THREAD_POOL_SOURCES = \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/Thread/ThreadPool.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Thread/Debug.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestThreadPool.cpp
+TEST_THREAD_POOL_OBJS = $(call SRC_TO_OBJ,$(TEST_THREAD_POOL_SOURCES))
+TEST_THREAD_POOL_LDADD = $(MATH_LIBS)
+$(TARGET_BIN_DIR)/TestThreadPool$(TARGET_EXEEXT): $(TEST_THREAD_POOL_OBJS) $(TEST_THREAD_POOL_LDADD) | $(TARGET_BIN_DIR)/dirstamp
+	@$(NQ)echo "  LINK    $@"
+	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
+
 TEST_ANGLE_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestAngle.cpp
@@ -416,6 +459,7 @@ TEST_GLIDE_POLAR_SOURCES = \
 	$(ENGINE_SRC_DIR)/GlideSolvers/GlideResult.cpp \
 	$(ENGINE_SRC_DIR)/GlideSolvers/GlideState.cpp \
 	$(ENGINE_SRC_DIR)/GlideSolvers/MacCready.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/GeoPoint.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/Geometry/GeoVector.cpp \
@@ -441,6 +485,7 @@ $(TARGET_BIN_DIR)/TestFileUtil$(TARGET_EXEEXT): $(TEST_FILE_UTIL_OBJS) $(TEST_FI
 
 TEST_GEO_POINT_SOURCES = \
 	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/GeoPoint.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestGeoPoint.cpp
@@ -491,11 +536,51 @@ $(TARGET_BIN_DIR)/TestFlatLine$(TARGET_EXEEXT): $(TEST_FLAT_LINE_OBJS) $(TEST_FL
 	@$(NQ)echo "  LINK    $@"
 	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
 
+TEST_SEARCH_POLYGON_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestSearchPolygon.cpp
+TEST_SEARCH_POLYGON_OBJS = $(call SRC_TO_OBJ,$(TEST_SEARCH_POLYGON_SOURCES))
+TEST_SEARCH_POLYGON_LDADD = $(ENGINE_LIBS) $(UTIL_LIBS) $(MATH_LIBS)
+$(TARGET_BIN_DIR)/TestSearchPolygon$(TARGET_EXEEXT): $(TEST_SEARCH_POLYGON_OBJS) $(TEST_SEARCH_POLYGON_LDADD) | $(TARGET_BIN_DIR)/dirstamp
+	@$(NQ)echo "  LINK    $@"
+	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
+
+TEST_AIRSPACE_POLYGON_SOURCES = \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Units/Units.cpp \
+	$(SRC)/Operation.cpp \
+	$(TEST_SRC_DIR)/FakeDialogs.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAirspacePolygon.cpp
+TEST_AIRSPACE_POLYGON_OBJS = $(call SRC_TO_OBJ,$(TEST_AIRSPACE_POLYGON_SOURCES))
+TEST_AIRSPACE_POLYGON_LDADD = \
+	$(FAKE_LIBS) \
+	$(ENGINE_LIBS) \
+	$(IO_LIBS) \
+	$(ZZIP_LIBS) \
+	$(MATH_LIBS) \
+	$(UTIL_LIBS)
+$(TARGET_BIN_DIR)/TestAirspacePolygon$(TARGET_EXEEXT): $(TEST_AIRSPACE_POLYGON_OBJS) $(TEST_AIRSPACE_POLYGON_LDADD) | $(TARGET_BIN_DIR)/dirstamp
+	@$(NQ)echo "  LINK    $@"
+	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
+
+TEST_AIRSPACE_CANDIDATE_SET_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAirspaceCandidateSet.cpp
+TEST_AIRSPACE_CANDIDATE_SET_OBJS = $(call SRC_TO_OBJ,$(TEST_AIRSPACE_CANDIDATE_SET_SOURCES))
+TEST_AIRSPACE_CANDIDATE_SET_LDADD = $(ENGINE_LIBS) $(UTIL_LIBS) $(MATH_LIBS)
+$(TARGET_BIN_DIR)/TestAirspaceCandidateSet$(TARGET_EXEEXT): $(TEST_AIRSPACE_CANDIDATE_SET_OBJS) $(TEST_AIRSPACE_CANDIDATE_SET_LDADD) | $(TARGET_BIN_DIR)/dirstamp
+	@$(NQ)echo "  LINK    $@"
+	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
+
 TEST_THERMALBASE_SOURCES = \
 	$(SRC)/ThermalBase.cpp \
 	$(SRC)/Poco/RWLock.cpp \
 	$(SRC)/Thread/Mutex.cpp \
 	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestThermalBase.cpp \
 	$(TEST_SRC_DIR)/FakeTerrain.cpp
@@ -507,6 +592,7 @@ $(TARGET_BIN_DIR)/TestThermalBase$(TARGET_EXEEXT): $(TEST_THERMALBASE_OBJS) $(TE
 
 TEST_EARTH_SOURCES = \
 	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestEarth.cpp
 TEST_EARTH_OBJS = $(call SRC_TO_OBJ,$(TEST_EARTH_SOURCES))
@@ -575,6 +661,7 @@ TEST_LOGGER_SOURCES = \
 	$(SRC)/Math/Angle.cpp \
 	$(SRC)/Util/UTF8.cpp \
 	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(ENGINE_SRC_DIR)/Atmosphere/Pressure.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/Aircraft.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/GeoPoint.cpp \
@@ -626,6 +713,7 @@ TEST_DRIVER_SOURCES = \
 	$(SRC)/Util/StringUtil.cpp \
 	$(SRC)/Operation.cpp \
 	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(ENGINE_SRC_DIR)/Atmosphere/Pressure.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/GeoPoint.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/Aircraft.cpp \
@@ -653,6 +741,8 @@ TEST_WAY_POINT_FILE_SOURCES = \
 	$(SRC)/Thread/Mutex.cpp \
 	$(SRC)/Geo/UTM.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/ParsedWaypoints.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
 	$(SRC)/Waypoint/WaypointReaderSeeYou.cpp \
@@ -663,6 +753,7 @@ TEST_WAY_POINT_FILE_SOURCES = \
 	$(SRC)/Operation.cpp \
 	$(SRC)/RadioFrequency.cpp \
 	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/GeoPoint.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/TaskProjection.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/Flat/FlatGeoPoint.cpp \
@@ -695,6 +786,35 @@ $(TARGET_BIN_DIR)/TestTrace$(TARGET_EXEEXT): $(TEST_TRACE_OBJS) $(TEST_TRACE_LDA
 	@$(NQ)echo "  LINK    $@"
 	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
 
+TEST_TRACE_THINNING_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(SRC)/Math/fixed.cpp \
+	$(SRC)/Math/Angle.cpp \
+	$(SRC)/Math/FastMath.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/TestTraceThinning.cpp
+TEST_TRACE_THINNING_OBJS = $(call SRC_TO_OBJ,$(TEST_TRACE_THINNING_SOURCES))
+TEST_TRACE_THINNING_LDADD = $(UTIL_LIBS) $(MATH_LIBS) $(ENGINE_LIBS)
+$(TARGET_BIN_DIR)/TestTraceThinning$(TARGET_EXEEXT): $(TEST_TRACE_THINNING_OBJS) $(TEST_TRACE_THINNING_LDADD) | $(TARGET_BIN_DIR)/dirstamp
+	@$(NQ)echo "  LINK    $@"
+	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
+
+TEST_OLC_TRIANGLE_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(SRC)/Math/fixed.cpp \
+	$(SRC)/Math/Angle.cpp \
+	$(SRC)/Math/FastMath.cpp \
+	$(SRC)/Replay/IGCParser.cpp \
+	$(SRC)/Util/StringUtil.cpp \
+	$(SRC)/Util/UTF8.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/TestOLCTriangle.cpp
+TEST_OLC_TRIANGLE_OBJS = $(call SRC_TO_OBJ,$(TEST_OLC_TRIANGLE_SOURCES))
+TEST_OLC_TRIANGLE_LDADD = $(UTIL_LIBS) $(MATH_LIBS) $(IO_LIBS) $(ENGINE_LIBS)
+$(TARGET_BIN_DIR)/TestOLCTriangle$(TARGET_EXEEXT): $(TEST_OLC_TRIANGLE_OBJS) $(TEST_OLC_TRIANGLE_LDADD) | $(TARGET_BIN_DIR)/dirstamp
+	@$(NQ)echo "  LINK    $@"
+	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
+
 FLIGHT_TABLE_SOURCES = \
 	$(SRC)/OS/FileUtil.cpp \
 	$(SRC)/Math/fixed.cpp \
@@ -704,6 +824,7 @@ FLIGHT_TABLE_SOURCES = \
 	$(SRC)/Util/UTF8.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/GeoPoint.cpp \
 	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(TEST_SRC_DIR)/FlightTable.cpp
 FLIGHT_TABLE_OBJS = $(call SRC_TO_OBJ,$(FLIGHT_TABLE_SOURCES))
 FLIGHT_TABLE_LDADD = $(UTIL_LIBS) $(MATH_LIBS) $(IO_LIBS)
@@ -724,7 +845,10 @@ DEBUG_PROGRAM_NAMES = \
 	TestTrace \
 	FlightTable \
 	TestOLC \
+	BenchmarkTriangle \
 	BenchmarkProjection \
+	BenchmarkAirspaces \
+	BenchmarkTerrain \
 	DumpTextFile DumpTextZip WriteTextFile RunTextWriter \
 	RunXMLParser \
 	ReadMO \
@@ -747,7 +871,7 @@ DEBUG_PROGRAM_NAMES = \
 	RunRenderOZ \
 	RunProgressWindow \
 	RunJobDialog \
-	RunAnalysis \
+	RunAnalysis RunBatchAnalysis \
 	RunAirspaceWarningDialog \
 	TestNotify \
 	DebugDisplay
@@ -775,6 +899,8 @@ DEBUG_REPLAY_SOURCES = \
 	$(SRC)/Device/Parser.cpp \
 	$(SRC)/Device/Internal.cpp \
 	$(SRC)/Replay/IGCParser.cpp \
+	$(SRC)/Replay/IGCFixArray.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/Units/Units.cpp \
 	$(SRC)/SettingsComputer.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
@@ -804,6 +930,7 @@ DEBUG_REPLAY_SOURCES = \
 	$(SRC)/Engine/Util/DiffFilter.cpp \
 	$(SRC)/Engine/Util/ZeroFinder.cpp \
 	$(SRC)/Engine/Math/Earth.cpp \
+	$(SRC)/Engine/Util/PerfCounters.cpp \
 	$(SRC)/Engine/Atmosphere/Pressure.cpp \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/Engine/Navigation/GeoPoint.cpp \
@@ -840,6 +967,33 @@ $(TARGET_BIN_DIR)/BenchmarkProjection$(TARGET_EXEEXT): $(BENCHMARK_PROJECTION_OB
 	@$(NQ)echo "  LINK    $@"
 	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
 
+BENCHMARK_TERRAIN_SOURCES = \
+	$(SRC)/Terrain/RasterTile.cpp \
+	$(SRC)/Terrain/RasterTileStore.cpp \
+	$(SRC)/Terrain/RasterMap.cpp \
+	$(SRC)/Terrain/RasterBuffer.cpp \
+	$(SRC)/Terrain/RasterProjection.cpp \
+	$(SRC)/Geo/GeoClip.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(SRC)/Engine/Math/Earth.cpp \
+	$(SRC)/Engine/Util/PerfCounters.cpp \
+	$(SRC)/Operation.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTerrain.cpp
+BENCHMARK_TERRAIN_OBJS = $(call SRC_TO_OBJ,$(BENCHMARK_TERRAIN_SOURCES))
+BENCHMARK_TERRAIN_LDADD = \
+	$(ENGINE_CORE_LIBS) \
+	$(IO_LIBS) \
+	$(MATH_LIBS) \
+	$(UTIL_LIBS) \
+	$(JASPER_LIBS) \
+	$(ZZIP_LIBS) \
+	$(COMPAT_LIBS)
+$(TARGET_BIN_DIR)/BenchmarkTerrain$(TARGET_EXEEXT): $(BENCHMARK_TERRAIN_OBJS) $(BENCHMARK_TERRAIN_LDADD) | $(TARGET_BIN_DIR)/dirstamp
+	@$(NQ)echo "  LINK    $@"
+	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) $(ZZIP_LDLIBS) -o $@
+
 DUMP_TEXT_FILE_SOURCES = \
 	$(SRC)/Util/UTF8.cpp \
 	$(TEST_SRC_DIR)/DumpTextFile.cpp
@@ -1070,6 +1224,7 @@ LOAD_TOPOGRAPHY_SOURCES = \
 	$(SRC)/Units/Units.cpp \
 	$(SRC)/Screen/Layout.cpp \
 	$(SRC)/Engine/Math/Earth.cpp \
+	$(SRC)/Engine/Util/PerfCounters.cpp \
 	$(SRC)/Operation.cpp \
 	$(SRC)/Util/UTF8.cpp \
 	$(TEST_SRC_DIR)/LoadTopography.cpp
@@ -1089,11 +1244,14 @@ $(LOAD_TOPOGRAPHY_BIN): $(LOAD_TOPOGRAPHY_OBJS) $(LOAD_TOPOGRAPHY_LDADD) | $(TAR
 
 LOAD_TERRAIN_SOURCES = \
 	$(SRC)/Terrain/RasterTile.cpp \
+	$(SRC)/Terrain/RasterTileStore.cpp \
 	$(SRC)/Terrain/RasterBuffer.cpp \
 	$(SRC)/Terrain/RasterProjection.cpp \
 	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/OS/PathName.cpp \
 	$(SRC)/Engine/Math/Earth.cpp \
+	$(SRC)/Engine/Util/PerfCounters.cpp \
 	$(SRC)/Operation.cpp \
 	$(SRC)/Util/UTF8.cpp \
 	$(TEST_SRC_DIR)/LoadTerrain.cpp
@@ -1112,6 +1270,7 @@ $(LOAD_TERRAIN_BIN): $(LOAD_TERRAIN_OBJS) $(LOAD_TERRAIN_LDADD) | $(TARGET_BIN_D
 
 RUN_HEIGHT_MATRIX_SOURCES = \
 	$(SRC)/Terrain/RasterTile.cpp \
+	$(SRC)/Terrain/RasterTileStore.cpp \
 	$(SRC)/Terrain/RasterBuffer.cpp \
 	$(SRC)/Terrain/RasterProjection.cpp \
 	$(SRC)/Terrain/RasterMap.cpp \
@@ -1119,9 +1278,15 @@ RUN_HEIGHT_MATRIX_SOURCES = \
 	$(SRC)/Geo/GeoClip.cpp \
 	$(SRC)/Projection.cpp \
 	$(SRC)/WindowProjection.cpp \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/Thread/ThreadPool.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Thread/Debug.cpp \
 	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/OS/PathName.cpp \
 	$(SRC)/Engine/Math/Earth.cpp \
+	$(SRC)/Engine/Util/PerfCounters.cpp \
 	$(SRC)/Operation.cpp \
 	$(SRC)/Util/UTF8.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/GeoPoint.cpp \
@@ -1157,6 +1322,7 @@ $(TARGET_BIN_DIR)/RunInputParser$(TARGET_EXEEXT): $(RUN_INPUT_PARSER_OBJS) $(RUN
 RUN_WAY_POINT_PARSER_SOURCES = \
 	$(SRC)/Geo/UTM.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/ParsedWaypoints.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
 	$(SRC)/Waypoint/WaypointReaderFS.cpp \
@@ -1207,6 +1373,26 @@ $(TARGET_BIN_DIR)/RunAirspaceParser$(TARGET_EXEEXT): $(RUN_AIRSPACE_PARSER_OBJS)
 	@$(NQ)echo "  LINK    $@"
 	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
 
+BENCHMARK_AIRSPACES_SOURCES = \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Units/Units.cpp \
+	$(SRC)/Operation.cpp \
+	$(TEST_SRC_DIR)/FakeDialogs.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAirspaces.cpp
+BENCHMARK_AIRSPACES_OBJS = $(call SRC_TO_OBJ,$(BENCHMARK_AIRSPACES_SOURCES))
+BENCHMARK_AIRSPACES_LDADD = \
+	$(FAKE_LIBS) \
+	$(ENGINE_LIBS) \
+	$(IO_LIBS) \
+	$(ZZIP_LIBS) \
+	$(MATH_LIBS) \
+	$(UTIL_LIBS)
+$(TARGET_BIN_DIR)/BenchmarkAirspaces$(TARGET_EXEEXT): $(BENCHMARK_AIRSPACES_OBJS) $(BENCHMARK_AIRSPACES_LDADD) | $(TARGET_BIN_DIR)/dirstamp
+	@$(NQ)echo "  LINK    $@"
+	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
+
 READ_PORT_SOURCES = \
 	$(SRC)/Device/Port.cpp \
 	$(SRC)/Thread/Thread.cpp \
@@ -1281,6 +1467,7 @@ RUN_DEVICE_DRIVER_SOURCES = \
 	$(SRC)/OS/Clock.cpp \
 	$(SRC)/Operation.cpp \
 	$(ENGINE_SRC_DIR)/Math/Earth.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(ENGINE_SRC_DIR)/Atmosphere/Pressure.cpp \
 	$(TEST_SRC_DIR)/FakeMessage.cpp \
 	$(TEST_SRC_DIR)/FakeProfile.cpp \
@@ -1523,6 +1710,7 @@ TEST_OLC_SOURCES = \
 	$(ENGINE_SRC_DIR)/Navigation/TracePoint.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/Flat/FlatGeoPoint.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/Flat/FlatRay.cpp \
+	$(ENGINE_SRC_DIR)/Navigation/Flat/FlatBoundingBox.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/TaskProjection.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/ConvexHull/GrahamScan.cpp \
 	$(ENGINE_SRC_DIR)/Navigation/ConvexHull/PolygonInterior.cpp \
@@ -1531,6 +1719,7 @@ TEST_OLC_SOURCES = \
 	$(ENGINE_SRC_DIR)/Contest/ContestSolvers/Contests.cpp \
 	$(ENGINE_SRC_DIR)/Contest/ContestSolvers/AbstractContest.cpp \
 	$(ENGINE_SRC_DIR)/Contest/ContestSolvers/ContestDijkstra.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
 	$(ENGINE_SRC_DIR)/Contest/ContestSolvers/OLCLeague.cpp \
 	$(ENGINE_SRC_DIR)/Contest/ContestSolvers/OLCSprint.cpp \
 	$(ENGINE_SRC_DIR)/Contest/ContestSolvers/OLCClassic.cpp \
@@ -1553,6 +1742,36 @@ $(TARGET_BIN_DIR)/TestOLC$(TARGET_EXEEXT): $(TEST_OLC_OBJS) $(TEST_OLC_LDADD) |
 	@$(NQ)echo "  LINK    $@"
 	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
 
+BENCHMARK_TRIANGLE_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/Math/fixed.cpp \
+	$(SRC)/Math/Angle.cpp \
+	$(SRC)/Math/FastMath.cpp \
+	$(SRC)/Replay/IGCParser.cpp \
+	$(SRC)/Util/StringUtil.cpp \
+	$(SRC)/Util/UTF8.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(ENGINE_SRC_DIR)/Navigation/SearchPoint.cpp \
+	$(ENGINE_SRC_DIR)/Navigation/TracePoint.cpp \
+	$(ENGINE_SRC_DIR)/Navigation/Flat/FlatGeoPoint.cpp \
+	$(ENGINE_SRC_DIR)/Navigation/Flat/FlatRay.cpp \
+	$(ENGINE_SRC_DIR)/Navigation/Flat/FlatBoundingBox.cpp \
+	$(ENGINE_SRC_DIR)/Navigation/TaskProjection.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(ENGINE_SRC_DIR)/Contest/ContestSolvers/AbstractContest.cpp \
+	$(ENGINE_SRC_DIR)/Contest/ContestSolvers/ContestDijkstra.cpp \
+	$(ENGINE_SRC_DIR)/Util/PerfCounters.cpp \
+	$(ENGINE_SRC_DIR)/Contest/ContestSolvers/OLCTriangle.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTriangle.cpp
+BENCHMARK_TRIANGLE_OBJS = $(call SRC_TO_OBJ,$(BENCHMARK_TRIANGLE_SOURCES))
+BENCHMARK_TRIANGLE_LDADD = $(UTIL_LIBS) $(MATH_LIBS) \
+	$(DRIVER_LIBS) \
+	$(DEBUG_REPLAY_LDADD)
+$(TARGET_BIN_DIR)/BenchmarkTriangle$(TARGET_EXEEXT): $(BENCHMARK_TRIANGLE_OBJS) $(BENCHMARK_TRIANGLE_LDADD) | $(TARGET_BIN_DIR)/dirstamp
+	@$(NQ)echo "  LINK    $@"
+	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) -o $@
+
 RUN_CANVAS_SOURCES = \
 	$(SRC)/Screen/Layout.cpp \
 	$(SRC)/Thread/Debug.cpp \
@@ -1597,6 +1816,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Airspace/AirspaceRendererSettings.cpp \
 	$(SRC)/LocalPath.cpp \
 	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/OS/PathName.cpp \
 	$(SRC)/Projection.cpp \
 	$(SRC)/WindowProjection.cpp \
@@ -1629,11 +1849,14 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Terrain/RasterBuffer.cpp \
 	$(SRC)/Terrain/RasterProjection.cpp \
 	$(SRC)/Terrain/RasterTile.cpp \
+	$(SRC)/Terrain/RasterTileStore.cpp \
 	$(SRC)/Terrain/RasterMap.cpp \
 	$(SRC)/Terrain/RasterTerrain.cpp \
+	$(SRC)/Terrain/TerrainLoader.cpp \
 	$(SRC)/Terrain/RasterWeather.cpp \
 	$(SRC)/Terrain/HeightMatrix.cpp \
 	$(SRC)/Terrain/RasterRenderer.cpp \
+	$(SRC)/Terrain/SlopeShading.cpp \
 	$(SRC)/Terrain/TerrainRenderer.cpp \
 	$(SRC)/Terrain/TerrainSettings.cpp \
 	$(SRC)/Terrain/WeatherTerrainRenderer.cpp \
@@ -1661,6 +1884,10 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Task/RoutePlannerGlue.cpp \
 	$(SRC)/Thread/Debug.cpp \
 	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/Thread/SuspensibleThread.cpp \
+	$(SRC)/Thread/WorkerThread.cpp \
+	$(SRC)/Thread/ThreadPool.cpp \
 	$(SRC)/Thread/Notify.cpp \
 	$(SRC)/Topography/TopographyFile.cpp \
 	$(SRC)/Topography/TopographyStore.cpp \
@@ -1676,8 +1903,10 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Profile/Earth.cpp \
 	$(SRC)/Geo/UTM.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/ParsedWaypoints.cpp \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
 	$(SRC)/Waypoint/WaypointReaderFS.cpp \
 	$(SRC)/Waypoint/WaypointReaderWinPilot.cpp \
@@ -1905,6 +2134,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/FLARM/State.cpp \
 	$(SRC)/OS/PathName.cpp \
 	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/FileMapping.cpp \
 	$(SRC)/OS/Clock.cpp \
 	$(SRC)/GestureManager.cpp \
 	$(SRC)/UtilsFile.cpp \
@@ -1954,6 +2184,9 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Thread/Debug.cpp \
 	$(SRC)/Thread/Mutex.cpp \
 	$(SRC)/Thread/Notify.cpp \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/Thread/SuspensibleThread.cpp \
+	$(SRC)/Thread/WorkerThread.cpp \
 	$(SRC)/Poco/RWLock.cpp \
 	$(SRC)/Profile/Profile.cpp \
 	$(SRC)/Profile/ProfileKeys.cpp \
@@ -1961,6 +2194,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Terrain/RasterBuffer.cpp \
 	$(SRC)/Terrain/RasterProjection.cpp \
 	$(SRC)/Terrain/RasterTile.cpp \
+	$(SRC)/Terrain/RasterTileStore.cpp \
 	$(SRC)/Terrain/RasterMap.cpp \
 	$(SRC)/Terrain/RasterTerrain.cpp \
 	$(SRC)/Terrain/TerrainSettings.cpp \
@@ -1982,6 +2216,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Computer/CirclingComputer.cpp \
 	$(SRC)/Computer/WindComputer.cpp \
 	$(SRC)/Computer/ContestComputer.cpp \
+	$(SRC)/Computer/ContestThread.cpp \
 	$(SRC)/Computer/TraceComputer.cpp \
 	$(SRC)/Computer/WarningComputer.cpp \
 	$(SRC)/Computer/GlideComputer.cpp \
@@ -1993,6 +2228,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Computer/GlideComputerInterface.cpp \
 	$(SRC)/SettingsComputer.cpp \
 	$(SRC)/Replay/IGCParser.cpp \
+	$(SRC)/Replay/IGCFixArray.cpp \
 	$(SRC)/SettingsMap.cpp \
 	$(SRC)/InterfaceBlackboard.cpp \
 	$(SRC)/Audio/VegaVoice.cpp \
@@ -2001,6 +2237,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
 	$(SRC)/Airspace/AirspaceGlue.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
 	$(SRC)/Airspace/AirspaceRendererSettings.cpp \
@@ -2048,6 +2285,114 @@ $(RUN_ANALYSIS_BIN): $(RUN_ANALYSIS_OBJS) $(RUN_ANALYSIS_LDADD) | $(TARGET_BIN_D
 	@$(NQ)echo "  LINK    $@"
 	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) $(PROFILE_LDLIBS) $(ZZIP_LDLIBS) -o $@
 
+RUN_BATCH_ANALYSIS_SOURCES = \
+	$(SRC)/DateTime.cpp \
+	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/NMEA/MoreData.cpp \
+	$(SRC)/NMEA/Acceleration.cpp \
+	$(SRC)/NMEA/ExternalSettings.cpp \
+	$(SRC)/NMEA/Derived.cpp \
+	$(SRC)/NMEA/VarioInfo.cpp \
+	$(SRC)/NMEA/ClimbInfo.cpp \
+	$(SRC)/NMEA/CirclingInfo.cpp \
+	$(SRC)/NMEA/ThermalBand.cpp \
+	$(SRC)/NMEA/ThermalLocator.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/NMEA/ClimbHistory.cpp \
+	$(SRC)/FLARM/State.cpp \
+	$(SRC)/OS/PathName.cpp \
+	$(SRC)/OS/FileUtil.cpp \
+	$(SRC)/OS/FileMapping.cpp \
+	$(SRC)/OS/Clock.cpp \
+	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/ProtectedRoutePlanner.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Atmosphere/CuSonde.cpp \
+	$(SRC)/Wind/CirclingWind.cpp \
+	$(SRC)/Wind/WindStore.cpp \
+	$(SRC)/Wind/WindMeasurementList.cpp \
+	$(SRC)/Wind/WindEKF.cpp \
+	$(SRC)/Units/Units.cpp \
+	$(SRC)/Geo/GeoClip.cpp \
+	$(SRC)/Thread/Debug.cpp \
+	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/Thread/SuspensibleThread.cpp \
+	$(SRC)/Thread/WorkerThread.cpp \
+	$(SRC)/Thread/ThreadPool.cpp \
+	$(SRC)/Poco/RWLock.cpp \
+	$(SRC)/Profile/ProfileKeys.cpp \
+	$(SRC)/Terrain/RasterBuffer.cpp \
+	$(SRC)/Terrain/RasterProjection.cpp \
+	$(SRC)/Terrain/RasterTile.cpp \
+	$(SRC)/Terrain/RasterTileStore.cpp \
+	$(SRC)/Terrain/RasterMap.cpp \
+	$(SRC)/Terrain/RasterTerrain.cpp \
+	$(SRC)/Terrain/TerrainSettings.cpp \
+	$(SRC)/xmlParser.cpp \
+	$(SRC)/FlightStatistics.cpp \
+	$(SRC)/GlideRatio.cpp \
+	$(SRC)/AutoQNH.cpp \
+	$(SRC)/ThermalLocator.cpp \
+	$(SRC)/Computer/BasicComputer.cpp \
+	$(SRC)/Computer/FlyingComputer.cpp \
+	$(SRC)/Computer/CirclingComputer.cpp \
+	$(SRC)/Computer/WindComputer.cpp \
+	$(SRC)/Computer/ContestComputer.cpp \
+	$(SRC)/Computer/ContestThread.cpp \
+	$(SRC)/Computer/TraceComputer.cpp \
+	$(SRC)/Computer/WarningComputer.cpp \
+	$(SRC)/Computer/GlideComputer.cpp \
+	$(SRC)/Computer/GlideComputerBlackboard.cpp \
+	$(SRC)/Computer/GlideComputerTask.cpp \
+	$(SRC)/Computer/GlideComputerRoute.cpp \
+	$(SRC)/Computer/GlideComputerAirData.cpp \
+	$(SRC)/Computer/GlideComputerStats.cpp \
+	$(SRC)/Computer/GlideComputerInterface.cpp \
+	$(SRC)/SettingsComputer.cpp \
+	$(SRC)/Replay/IGCParser.cpp \
+	$(SRC)/Replay/IGCFixArray.cpp \
+	$(SRC)/Audio/VegaVoice.cpp \
+	$(SRC)/TeamCodeCalculation.cpp \
+	$(SRC)/Engine/Navigation/TraceHistory.cpp \
+	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
+	$(SRC)/Math/SunEphemeris.cpp \
+	$(SRC)/Compatibility/string.c \
+	$(SRC)/Operation.cpp \
+	$(SRC)/Device/Port.cpp \
+	$(SRC)/Device/NullPort.cpp \
+	$(SRC)/Device/Register.cpp \
+	$(SRC)/Device/Driver.cpp \
+	$(SRC)/Device/Internal.cpp \
+	$(SRC)/Device/Parser.cpp \
+	$(SRC)/NMEA/InputLine.cpp \
+	$(SRC)/NMEA/Checksum.cpp \
+	$(SRC)/FLARM/FlarmId.cpp \
+	$(SRC)/FLARM/Traffic.cpp \
+	$(TEST_SRC_DIR)/FakeAsset.cpp \
+	$(TEST_SRC_DIR)/FakeDialogs.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/FakeMessage.cpp \
+	$(TEST_SRC_DIR)/FakeGeoid.cpp \
+	$(TEST_SRC_DIR)/FakeProfile.cpp \
+	$(TEST_SRC_DIR)/DebugReplay.cpp \
+	$(TEST_SRC_DIR)/RunBatchAnalysis.cpp
+RUN_BATCH_ANALYSIS_OBJS = $(call SRC_TO_OBJ,$(RUN_BATCH_ANALYSIS_SOURCES))
+RUN_BATCH_ANALYSIS_LDADD = \
+	$(DRIVER_LIBS) \
+	$(ENGINE_LIBS) \
+	$(JASPER_LIBS) \
+	$(IO_LIBS) \
+	$(ZZIP_LIBS) \
+	$(UTIL_LIBS) \
+	$(MATH_LIBS)
+$(TARGET_BIN_DIR)/RunBatchAnalysis$(TARGET_EXEEXT): $(RUN_BATCH_ANALYSIS_OBJS) $(RUN_BATCH_ANALYSIS_LDADD) | $(TARGET_BIN_DIR)/dirstamp
+	@$(NQ)echo "  LINK    $@"
+	$(Q)$(LINK) $(LDFLAGS) $(TARGET_ARCH) $^ $(LDLIBS) $(ZZIP_LDLIBS) -o $@
+
 RUN_AIRSPACE_WARNING_DIALOG_SOURCES = \
 	$(SRC)/Poco/RWLock.cpp \
 	$(SRC)/xmlParser.cpp \
@@ -2130,6 +2475,8 @@ RUN_TASK_EDITOR_DIALOG_SOURCES = \
 	$(SRC)/Task/ProtectedTaskManager.cpp \
 	$(SRC)/Thread/Debug.cpp \
 	$(SRC)/Thread/Mutex.cpp \
+	$(SRC)/Thread/Thread.cpp \
+	$(SRC)/Thread/ThreadPool.cpp \
 	$(SRC)/LocalPath.cpp \
 	$(SRC)/OS/FileUtil.cpp \
 	$(SRC)/UtilsText.cpp \
@@ -2139,7 +2486,9 @@ RUN_TASK_EDITOR_DIALOG_SOURCES = \
 	$(SRC)/Units/UnitsFormatter.cpp \
 	$(SRC)/Geo/UTM.cpp \
 	$(SRC)/Waypoint/WaypointGlue.cpp \
+	$(SRC)/Waypoint/WaypointCache.cpp \
 	$(SRC)/Waypoint/WaypointReaderBase.cpp \
+	$(SRC)/Waypoint/ParsedWaypoints.cpp \
 	$(SRC)/Waypoint/WaypointReader.cpp \
 	$(SRC)/Waypoint/WaypointReaderOzi.cpp \
 	$(SRC)/Waypoint/WaypointReaderFS.cpp \
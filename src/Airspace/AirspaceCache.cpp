@@ -0,0 +1,227 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Airspace/AirspaceCache.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "IO/CacheBuffer.hpp"
+
+#include <stdint.h>
+
+struct AirspaceCacheHeader {
+  enum {
+    VERSION = 1,
+  };
+
+  uint32_t version;
+
+  /** Detects a cache file written by an incompatible build */
+  uint8_t tchar_size, fixed_size, altitude_size, activity_size;
+
+  /** The number of airspaces */
+  uint32_t count;
+
+  /** The size of the data following the header [bytes] */
+  uint32_t size;
+};
+
+/**
+ * The size of the smallest record written by WriteCachedAirspace(): a
+ * polygon without points and with empty strings.
+ */
+static const size_t MIN_CACHED_AIRSPACE_SIZE =
+  2 * sizeof(uint8_t) + 2 * sizeof(AirspaceAltitude) +
+  sizeof(AirspaceActivity) + 2 * sizeof(uint16_t) +
+  sizeof(uint32_t) + sizeof(uint8_t);
+
+static void
+MakeHeader(AirspaceCacheHeader &header)
+{
+  header.version = AirspaceCacheHeader::VERSION;
+  header.tchar_size = sizeof(TCHAR);
+  header.fixed_size = sizeof(fixed);
+  header.altitude_size = sizeof(AirspaceAltitude);
+  header.activity_size = sizeof(AirspaceActivity);
+}
+
+static void
+WriteCachedAirspace(CacheWriter &writer, const AbstractAirspace &airspace)
+{
+  writer.Write((uint8_t)airspace.shape);
+  writer.Write((uint8_t)airspace.GetType());
+  writer.Write(airspace.GetBase());
+  writer.Write(airspace.GetTop());
+  writer.Write(airspace.GetDays());
+  writer.WriteString(airspace.GetName());
+  writer.WriteString(airspace.GetRadioText());
+
+  switch (airspace.shape) {
+  case AbstractAirspace::CIRCLE: {
+    const AirspaceCircle &circle = (const AirspaceCircle &)airspace;
+    writer.Write(circle.GetCenter());
+    writer.Write(circle.GetRadius());
+    break;
+  }
+
+  case AbstractAirspace::POLYGON: {
+    const SearchPointVector &points = airspace.GetPoints();
+    const uint32_t n = points.size();
+    writer.Write(n);
+    writer.Write((uint8_t)airspace.IsConvex());
+    for (SearchPointVector::const_iterator i = points.begin();
+         i != points.end(); ++i)
+      writer.Write(i->get_location());
+    break;
+  }
+  }
+}
+
+static AbstractAirspace *
+ReadCachedAirspace(CacheReader &reader, SearchPointVector &border)
+{
+  uint8_t shape, type;
+  AirspaceAltitude base, top;
+  AirspaceActivity days;
+  tstring name, radio;
+  if (!reader.Read(shape) || !reader.Read(type) ||
+      type >= AIRSPACECLASSCOUNT ||
+      !reader.Read(base) || !reader.Read(top) || !reader.Read(days) ||
+      !reader.ReadString(name) || !reader.ReadString(radio))
+    return NULL;
+
+  AbstractAirspace *airspace;
+  switch (shape) {
+  case AbstractAirspace::CIRCLE: {
+    GeoPoint center;
+    fixed radius;
+    if (!reader.Read(center) || !reader.Read(radius))
+      return NULL;
+
+    airspace = new AirspaceCircle(center, radius);
+    break;
+  }
+
+  case AbstractAirspace::POLYGON: {
+    uint32_t n;
+    uint8_t is_convex;
+    if (!reader.Read(n) || !reader.Read(is_convex) ||
+        n > reader.GetRemaining() / sizeof(GeoPoint))
+      return NULL;
+
+    /* the border was closed and checked when it was parsed, no need
+       to do that again */
+    border.clear();
+    border.reserve(n);
+    for (unsigned i = 0; i < n; ++i) {
+      GeoPoint location;
+      reader.Read(location);
+      border.push_back(SearchPoint(location));
+    }
+
+    airspace = new AirspacePolygon(border, is_convex != 0);
+    break;
+  }
+
+  default:
+    return NULL;
+  }
+
+  airspace->SetProperties(name, (AirspaceClass)type, base, top);
+  airspace->SetRadio(radio);
+  airspace->SetDays(days);
+  return airspace;
+}
+
+bool
+SaveAirspaceCache(FILE *file,
+                  const std::vector<const AbstractAirspace *> &airspaces)
+{
+  std::vector<uint8_t> buffer;
+  CacheWriter writer(buffer);
+  for (std::vector<const AbstractAirspace *>::const_iterator i =
+         airspaces.begin(); i != airspaces.end(); ++i)
+    WriteCachedAirspace(writer, **i);
+
+  AirspaceCacheHeader header;
+  MakeHeader(header);
+  header.count = airspaces.size();
+  header.size = buffer.size();
+
+  return fwrite(&header, sizeof(header), 1, file) == 1 &&
+    (buffer.empty() ||
+     fwrite(&buffer[0], 1, buffer.size(), file) == buffer.size());
+}
+
+bool
+LoadAirspaceCache(FILE *file, Airspaces &airspaces)
+{
+  AirspaceCacheHeader header, expected;
+  MakeHeader(expected);
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      header.version != expected.version ||
+      header.tchar_size != expected.tchar_size ||
+      header.fixed_size != expected.fixed_size ||
+      header.altitude_size != expected.altitude_size ||
+      header.activity_size != expected.activity_size)
+    return false;
+
+  if (header.count == 0)
+    /* the airspace file was empty */
+    return header.size == 0;
+
+  /* don't trust the count with an allocation before the records have
+     been read */
+  if (header.count > header.size / MIN_CACHED_AIRSPACE_SIZE)
+    return false;
+
+  /* read everything at once */
+  std::vector<uint8_t> buffer(header.size);
+  if (fread(&buffer[0], 1, buffer.size(), file) != buffer.size())
+    return false;
+
+  CacheReader reader(buffer);
+  std::vector<AbstractAirspace *> result;
+  result.reserve(header.count);
+  SearchPointVector border;
+
+  for (unsigned i = 0; i < header.count; ++i) {
+    AbstractAirspace *airspace = ReadCachedAirspace(reader, border);
+    if (airspace == NULL)
+      break;
+
+    result.push_back(airspace);
+  }
+
+  if (result.size() != header.count || !reader.IsEnd()) {
+    for (std::vector<AbstractAirspace *>::const_iterator i = result.begin();
+         i != result.end(); ++i)
+      delete *i;
+    return false;
+  }
+
+  for (std::vector<AbstractAirspace *>::const_iterator i = result.begin();
+       i != result.end(); ++i)
+    airspaces.insert(*i);
+
+  return true;
+}
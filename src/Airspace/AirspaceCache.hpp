@@ -0,0 +1,52 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_AIRSPACE_CACHE_HPP
+#define XCSOAR_AIRSPACE_CACHE_HPP
+
+#include <vector>
+#include <stdio.h>
+
+class Airspaces;
+class AbstractAirspace;
+
+/**
+ * Writes finished airspaces (polygons, altitudes, classes, ...) to a
+ * binary cache file, which can be loaded much faster than the
+ * original OpenAir/TNP file can be parsed.
+ *
+ * The format depends on the build (e.g. size of TCHAR and #fixed) and
+ * is only meant for a cache file managed by #FileCache.
+ */
+bool
+SaveAirspaceCache(FILE *file,
+                  const std::vector<const AbstractAirspace *> &airspaces);
+
+/**
+ * Loads airspaces from a cache file created by SaveAirspaceCache()
+ * and inserts them into the database.  Nothing is inserted if the
+ * file is malformed or was written by an incompatible version.
+ */
+bool
+LoadAirspaceCache(FILE *file, Airspaces &airspaces);
+
+#endif
@@ -23,18 +23,118 @@ Copyright_License {
 
 #include "Airspace/AirspaceGlue.hpp"
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
+#include "Profile/Profile.hpp"
 #include "Profile/ProfileKeys.hpp"
 #include "Terrain/RasterTerrain.hpp"
 #include "Operation.hpp"
 #include "Language/Language.hpp"
 #include "LogFile.hpp"
-#include "IO/ConfiguredFile.hpp"
+#include "IO/FileCache.hpp"
+#include "IO/FileLineReader.hpp"
+#include "IO/ZipLineReader.hpp"
+#include "OS/FileUtil.hpp"
+
+#include <set>
+#include <windef.h> /* for MAX_PATH */
+
+static TLineReader *
+OpenAirspaceFile(const TCHAR *path, bool in_map_file)
+{
+  if (in_map_file) {
+    ZipLineReader *reader = new ZipLineReader(path, ConvertLineReader::AUTO);
+    if (reader->error()) {
+      delete reader;
+      return NULL;
+    }
+
+    return reader;
+  } else {
+    FileLineReader *reader = new FileLineReader(path, ConvertLineReader::AUTO);
+    if (reader->error()) {
+      delete reader;
+      return NULL;
+    }
+
+    return reader;
+  }
+}
+
+static void
+SaveAirspaceFileCache(FileCache &cache, const TCHAR *cache_name,
+                      const TCHAR *path,
+                      const std::vector<const AbstractAirspace *> &airspaces)
+{
+  FILE *file = cache.save(cache_name, path);
+  if (file == NULL)
+    return;
+
+  if (SaveAirspaceCache(file, airspaces))
+    cache.commit(cache_name, file);
+  else
+    cache.cancel(cache_name, file);
+}
+
+/**
+ * Loads the airspaces of one file into the database.  The parsed
+ * airspaces are stored in the cache, and the next time they are
+ * loaded from there, as long as the file has not been modified.
+ */
+static bool
+LoadAirspaceFile(Airspaces &airspaces, FileCache *cache,
+                 const TCHAR *cache_name,
+                 const TCHAR *path, bool in_map_file,
+                 OperationEnvironment &operation)
+{
+  if (cache != NULL) {
+    FILE *file = cache->load(cache_name, path);
+    if (file != NULL) {
+      const bool loaded = LoadAirspaceCache(file, airspaces);
+      fclose(file);
+      if (loaded)
+        return true;
+    }
+  }
+
+  TLineReader *reader = OpenAirspaceFile(path, in_map_file);
+  if (reader == NULL)
+    return false;
+
+  /* remember which airspaces were loaded before, to find the ones
+     which were added by this file */
+  std::set<const AbstractAirspace *> old_airspaces;
+  if (cache != NULL && !airspaces.empty()) {
+    airspaces.optimise();
+    for (Airspaces::AirspaceTree::const_iterator i = airspaces.begin();
+         i != airspaces.end(); ++i)
+      old_airspaces.insert(i->get_airspace());
+  }
+
+  AirspaceParser parser(airspaces);
+  const bool success = parser.Parse(*reader, operation);
+  delete reader;
+
+  if (success && cache != NULL && !airspaces.empty()) {
+    airspaces.optimise();
+
+    std::vector<const AbstractAirspace *> new_airspaces;
+    for (Airspaces::AirspaceTree::const_iterator i = airspaces.begin();
+         i != airspaces.end(); ++i)
+      if (old_airspaces.find(i->get_airspace()) == old_airspaces.end())
+        new_airspaces.push_back(i->get_airspace());
+
+    SaveAirspaceFileCache(*cache, cache_name, path, new_airspaces);
+  }
+
+  return success;
+}
 
 void
 ReadAirspace(Airspaces &airspaces,
              RasterTerrain *terrain,
              const AtmosphericPressure &press,
+             FileCache *cache,
              OperationEnvironment &operation)
 {
   LogStartUp(_T("ReadAirspace"));
@@ -42,30 +142,29 @@ ReadAirspace(Airspaces &airspaces,
 
   bool airspace_ok = false;
 
-  AirspaceParser parser(airspaces);
-
   // Read the airspace filenames from the registry
-  TLineReader *reader =
-    OpenConfiguredTextFile(szProfileAirspaceFile, _T("airspace.txt"),
-                           ConvertLineReader::AUTO);
-  if (reader != NULL) {
-    if (!parser.Parse(*reader, operation))
+  TCHAR path[MAX_PATH];
+  if (Profile::GetPath(szProfileAirspaceFile, path) && File::Exists(path)) {
+    if (!LoadAirspaceFile(airspaces, cache, _T("airspace"), path, false,
+                          operation))
+      LogStartUp(_T("No airspace file 1"));
+    else
+      airspace_ok =  true;
+  } else if (Profile::GetPath(szProfileMapFile, path)) {
+    _tcscat(path, _T("/airspace.txt"));
+    if (!LoadAirspaceFile(airspaces, cache, _T("airspace"), path, true,
+                          operation))
       LogStartUp(_T("No airspace file 1"));
     else
       airspace_ok =  true;
-
-    delete reader;
   }
 
-  reader = OpenConfiguredTextFile(szProfileAdditionalAirspaceFile,
-                                  ConvertLineReader::AUTO);
-  if (reader != NULL) {
-    if (!parser.Parse(*reader, operation))
+  if (Profile::GetPath(szProfileAdditionalAirspaceFile, path)) {
+    if (!LoadAirspaceFile(airspaces, cache, _T("airspace_additional"), path,
+                          false, operation))
       LogStartUp(_T("No airspace file 2"));
     else
       airspace_ok = true;
-
-    delete reader;
   }
 
   if (airspace_ok) {
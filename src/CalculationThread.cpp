@@ -28,13 +28,15 @@ Copyright_License {
 #include "DeviceBlackboard.hpp"
 #include "Components.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
+#include "PerfLog.hpp"
 
 /**
  * Constructor of the CalculationThread class
  * @param _glide_computer The GlideComputer used for the CalculationThread
  */
 CalculationThread::CalculationThread(GlideComputer &_glide_computer)
-  :WorkerThread(450, 100, 50), glide_computer(_glide_computer) {
+  :WorkerThread(450, 100, 50), glide_computer(_glide_computer),
+   basic_serial(0), idle_pending(false) {
 }
 
 void
@@ -51,22 +53,37 @@ CalculationThread::SetScreenDistanceMeters(fixed new_value)
   screen_distance_meters = new_value;
 }
 
+void
+CalculationThread::Run()
+{
+  PerfCounters::SetContext(PerfCounters::CONTEXT_CALCULATION);
+
+  WorkerThread::Run();
+}
+
 /**
  * Main loop of the CalculationThread
  */
 void
 CalculationThread::Tick()
 {
-  bool gps_updated;
+  bool basic_updated, gps_updated = false;
 
   // update and transfer master info to glide computer
   {
     ScopeLock protect(device_blackboard.mutex);
 
-    gps_updated = device_blackboard.Basic().location_available.Modified(glide_computer.Basic().location_available);
+    /* if the MergeThread has not produced new data since the last
+       iteration, there is nothing to copy and nothing to calculate */
+    basic_updated = device_blackboard.GetBasicSerial() != basic_serial;
+    if (basic_updated) {
+      basic_serial = device_blackboard.GetBasicSerial();
+
+      gps_updated = device_blackboard.Basic().location_available.Modified(glide_computer.Basic().location_available);
 
-    // Copy data from DeviceBlackboard to GlideComputerBlackboard
-    glide_computer.ReadBlackboard(device_blackboard.Basic());
+      // Copy data from DeviceBlackboard to GlideComputerBlackboard
+      glide_computer.ReadBlackboard(device_blackboard.Basic());
+    }
   }
 
   {
@@ -83,13 +100,16 @@ CalculationThread::Tick()
 
   if (gps_updated) {
     // perform idle call if time advanced and slow calculations need to be updated
+    ScopePerfTimer timer(PerfCounters::TIMER_GPS);
     do_idle |= glide_computer.ProcessGPS();
   }
 
   // values changed, so copy them back now: ONLY CALCULATED INFO
   // should be changed in DoCalculations, so we only need to write
-  // that one back (otherwise we may write over new data)
-  {
+  // that one back (otherwise we may write over new data); without
+  // new basic data, Expire() had nothing to do and ProcessGPS() was
+  // not called, so only the last ProcessIdle() may have changed it
+  if (basic_updated || idle_pending) {
     ScopeLock protect(device_blackboard.mutex);
     device_blackboard.ReadBlackboard(glide_computer.Calculated());
   }
@@ -102,6 +122,9 @@ CalculationThread::Tick()
 
   if (do_idle) {
     // do slow calculations last, to minimise latency
+    ScopePerfTimer timer(PerfCounters::TIMER_IDLE);
     glide_computer.ProcessIdle();
   }
+
+  idle_pending = do_idle;
 }
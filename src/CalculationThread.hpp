@@ -49,6 +49,19 @@ class CalculationThread : public WorkerThread {
   /** Pointer to the GlideComputer that should be used */
   GlideComputer &glide_computer;
 
+  /**
+   * The DeviceBlackboard::GetBasicSerial() value of the data which
+   * was last passed to the GlideComputer.
+   */
+  unsigned basic_serial;
+
+  /**
+   * Has the previous iteration called GlideComputer::ProcessIdle(),
+   * i.e. are there results which have not been copied back to the
+   * DeviceBlackboard yet?
+   */
+  bool idle_pending;
+
 public:
   CalculationThread(GlideComputer &_glide_computer);
 
@@ -64,6 +77,7 @@ public:
   }
 
 protected:
+  virtual void Run();
   virtual void Tick();
 };
 
@@ -69,6 +69,7 @@ Copyright_License {
 #include "StatusMessage.hpp"
 #include "MergeThread.hpp"
 #include "CalculationThread.hpp"
+#include "Computer/ContestThread.hpp"
 #include "Replay/Replay.hpp"
 #include "LocalPath.hpp"
 #include "IO/FileCache.hpp"
@@ -92,6 +93,7 @@ Copyright_License {
 #include "Weather/NOAAGlue.hpp"
 #include "Plane/PlaneGlue.hpp"
 #include "UIState.hpp"
+#include "PerfLog.hpp"
 
 #ifndef ENABLE_OPENGL
 #include "DrawThread.hpp"
@@ -109,6 +111,7 @@ DrawThread *draw_thread;
 
 MergeThread *merge_thread;
 CalculationThread *calculation_thread;
+ContestThread *contest_thread;
 
 Logger logger;
 Replay *replay;
@@ -373,7 +376,7 @@ XCSoarInterface::Startup()
   LoadConfiguredTopography(*topography, operation);
 
   // Read the waypoint files
-  WaypointGlue::LoadWaypoints(way_points, terrain, operation);
+  WaypointGlue::LoadWaypoints(way_points, terrain, file_cache, operation);
 
   // Read and parse the airfield info file
   WaypointDetails::ReadFileFromProfile(way_points, operation);
@@ -392,7 +395,7 @@ XCSoarInterface::Startup()
 
   // Reads the airspace files
   ReadAirspace(airspace_database, terrain, SettingsComputer().pressure,
-               operation);
+               file_cache, operation);
 
   const AircraftState aircraft_state =
     ToAircraftState(device_blackboard.Basic(), device_blackboard.Calculated());
@@ -475,6 +478,7 @@ XCSoarInterface::Startup()
   // Start calculation thread
   merge_thread->Start();
   calculation_thread->Start();
+  contest_thread->Start();
 
   globalRunningEvent.Signal();
 
@@ -530,6 +534,7 @@ XCSoarInterface::Shutdown(void)
   draw_thread->BeginStop();
 #endif
   calculation_thread->BeginStop();
+  contest_thread->BeginStop();
   merge_thread->BeginStop();
 
   // Wait for the calculations thread to finish
@@ -543,6 +548,11 @@ XCSoarInterface::Shutdown(void)
   delete calculation_thread;
   calculation_thread = NULL;
 
+  contest_thread->Join();
+  glide_computer->SetContestThread(NULL);
+  delete contest_thread;
+  contest_thread = NULL;
+
   //  Wait for the drawing thread to finish
 #ifndef ENABLE_OPENGL
   LogStartUp(_T("Waiting for draw thread"));
@@ -551,6 +561,8 @@ XCSoarInterface::Shutdown(void)
   delete draw_thread;
 #endif
 
+  LogPerfCounters();
+
   LogStartUp(_T("delete MapWindow"));
   main_window.Deinitialise();
 
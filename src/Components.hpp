@@ -33,6 +33,7 @@ class GlideComputer;
 class DrawThread;
 class MergeThread;
 class CalculationThread;
+class ContestThread;
 class Waypoints;
 class Airspaces;
 class ProtectedAirspaceWarningManager;
@@ -58,6 +59,7 @@ extern DrawThread *draw_thread;
 #endif
 extern MergeThread *merge_thread;
 extern CalculationThread *calculation_thread;
+extern ContestThread *contest_thread;
 
 extern Logger logger;
 
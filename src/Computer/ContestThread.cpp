@@ -0,0 +1,133 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ContestThread.hpp"
+#include "TraceComputer.hpp"
+#include "SettingsComputer.hpp"
+#include "PeriodClock.hpp"
+#include "PerfLog.hpp"
+
+/**
+ * The maximum duration of one Tick() [ms].  If the search is not
+ * finished by then, the thread yields and continues in the next
+ * Tick().
+ */
+#if !defined(_WIN32_WCE) && !defined(ANDROID)
+static const unsigned BUDGET = 200;
+#else
+static const unsigned BUDGET = 100;
+#endif
+
+ContestThread::ContestThread(const TraceComputer &_trace_computer)
+  :WorkerThread(500, 50),
+   trace_computer(_trace_computer),
+   enable(false), contest(OLC_Sprint), handicap(100), reset(false),
+   trace_serial(0),
+   contest_manager(OLC_Sprint, full, sprint)
+{
+  stats.reset();
+}
+
+void
+ContestThread::Update(const SETTINGS_COMPUTER &settings_computer)
+{
+  const TaskBehaviour &task = settings_computer.task;
+
+  mutex.Lock();
+  enable = task.enable_olc;
+  contest = task.contest;
+  handicap = task.contest_handicap;
+  mutex.Unlock();
+
+  if (task.enable_olc)
+    Trigger();
+}
+
+void
+ContestThread::Reset()
+{
+  ScopeLock protect(mutex);
+  reset = true;
+  stats.reset();
+}
+
+ContestStatistics
+ContestThread::GetStats() const
+{
+  ScopeLock protect(mutex);
+  return stats;
+}
+
+void
+ContestThread::Run()
+{
+  PerfCounters::SetContext(PerfCounters::CONTEXT_CONTEST);
+
+  WorkerThread::Run();
+}
+
+void
+ContestThread::Tick()
+{
+  mutex.Lock();
+  const bool _enable = enable, _reset = reset;
+  const Contests _contest = contest;
+  const unsigned _handicap = handicap;
+  reset = false;
+  mutex.Unlock();
+
+  if (_reset) {
+    contest_manager.Reset();
+
+    // force a full snapshot
+    trace_serial = 0;
+  }
+
+  if (!_enable)
+    return;
+
+  ScopePerfTimer timer(PerfCounters::TIMER_CONTEST);
+
+  PeriodClock clock;
+  clock.update();
+
+  trace_computer.LockedCopyTo(full, sprint, trace_serial);
+
+  contest_manager.SetHandicap(_handicap);
+  contest_manager.SetContest(_contest);
+
+  do {
+    contest_manager.UpdateIdle();
+  } while (contest_manager.IsBusy() && !clock.check(BUDGET) &&
+           !IsCommandPending());
+
+  mutex.Lock();
+  /* don't publish a result which was obtained before Reset() */
+  if (!reset)
+    stats = contest_manager.GetStats();
+  mutex.Unlock();
+
+  if (contest_manager.IsBusy())
+    /* out of time: continue in the next period */
+    Trigger();
+}
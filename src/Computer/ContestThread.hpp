@@ -0,0 +1,112 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CONTEST_THREAD_HPP
+#define XCSOAR_CONTEST_THREAD_HPP
+
+#include "Thread/WorkerThread.hpp"
+#include "Thread/Mutex.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Contest/ContestManager.hpp"
+
+struct SETTINGS_COMPUTER;
+class TraceComputer;
+
+/**
+ * Runs the contest optimiser in background, so a long flight does
+ * not delay the #CalculationThread.  The thread works on a private
+ * snapshot of the traces, which is refreshed only when the
+ * #TraceComputer has been modified, and each Tick() is limited to a
+ * fixed time budget.  The #CalculationThread picks up the latest
+ * result with GetStats() and publishes it through the blackboard.
+ */
+class ContestThread : public WorkerThread {
+  const TraceComputer &trace_computer;
+
+  /**
+   * This mutex protects #enable, #contest, #handicap, #reset and
+   * #stats.
+   */
+  mutable Mutex mutex;
+
+  bool enable;
+  Contests contest;
+  unsigned handicap;
+
+  /**
+   * Was Reset() called?  The solvers will be reset in the next
+   * Tick().
+   */
+  bool reset;
+
+  /**
+   * The most recent result, copied from #contest_manager after each
+   * Tick().
+   */
+  ContestStatistics stats;
+
+  /* the following attributes are only used inside the thread */
+
+  Trace full, sprint;
+
+  /**
+   * The TraceComputer serial of #full and #sprint.
+   */
+  unsigned trace_serial;
+
+  ContestManager contest_manager;
+
+public:
+  ContestThread(const TraceComputer &_trace_computer);
+
+  bool Start(bool suspended=false) {
+    if (!WorkerThread::Start(suspended))
+      return false;
+
+    SetLowPriority();
+    return true;
+  }
+
+  /**
+   * Copy the contest settings and wake up the thread.  Called by the
+   * #CalculationThread.
+   */
+  void Update(const SETTINGS_COMPUTER &settings_computer);
+
+  /**
+   * Discard all results, e.g. after the flight has been reset.
+   */
+  void Reset();
+
+  /**
+   * Returns a copy of the most recent result.
+   */
+  gcc_pure
+  ContestStatistics GetStats() const;
+
+protected:
+  virtual void Run();
+  virtual void Tick();
+};
+
+#endif
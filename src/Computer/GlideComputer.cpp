@@ -35,6 +35,7 @@ Copyright_License {
 #include "Logger/Logger.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "LocalTime.hpp"
+#include "PerfLog.hpp"
 
 static PeriodClock last_team_code_update;
 
@@ -141,13 +142,21 @@ GlideComputer::ProcessIdle(bool exhaustive)
 {
   // Log GPS fixes for internal usage
   // (snail trail, stats, olc, ...)
-  DoLogging();
+  {
+    ScopePerfTimer timer(PerfCounters::TIMER_LOGGING);
+    DoLogging();
+  }
 
-  GlideComputerTask::ProcessIdle(exhaustive);
+  {
+    ScopePerfTimer timer(PerfCounters::TIMER_TASK);
+    GlideComputerTask::ProcessIdle(exhaustive);
+  }
 
-  if (time_advanced())
+  if (time_advanced()) {
+    ScopePerfTimer timer(PerfCounters::TIMER_AIRSPACE_WARNING);
     warning_computer.Update(SettingsComputer(), Basic(), LastBasic(),
                             Calculated(), SetCalculated().airspace_warnings);
+  }
 }
 
 bool
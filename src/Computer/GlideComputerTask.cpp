@@ -26,6 +26,7 @@ Copyright_License {
 #include "Task/ProtectedTaskManager.hpp"
 #include "Terrain/RasterTerrain.hpp"
 #include "NMEA/Aircraft.hpp"
+#include "ContestThread.hpp"
 
 #include <algorithm>
 
@@ -38,7 +39,8 @@ GlideComputerTask::GlideComputerTask(ProtectedTaskManager &task,
                                      const Airspaces &airspace_database):
   m_task(task),
   route(airspace_database),
-  contest(trace.GetFull(), trace.GetSprint())
+  contest(trace.GetFull(), trace.GetSprint()),
+  contest_thread(NULL)
 {
   task.SetRoutePlanner(&route.GetRoutePlanner());
 }
@@ -55,6 +57,9 @@ GlideComputerTask::ResetFlight(const bool full)
   route.ResetFlight();
   trace.Reset();
   contest.Reset();
+
+  if (contest_thread != NULL)
+    contest_thread->Reset();
 }
 
 void
@@ -125,7 +130,11 @@ GlideComputerTask::ProcessIdle(bool exhaustive)
 
   if (exhaustive)
     contest.SolveExhaustive(SettingsComputer(), SetCalculated());
-  else
+  else if (contest_thread != NULL) {
+    contest_thread->Update(SettingsComputer());
+    if (SettingsComputer().task.enable_olc)
+      SetCalculated().contest_stats = contest_thread->GetStats();
+  } else
     contest.Solve(SettingsComputer(), SetCalculated());
 
   const AircraftState as = ToAircraftState(basic, Calculated());
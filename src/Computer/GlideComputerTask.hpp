@@ -31,6 +31,7 @@ Copyright_License {
 #include "ContestComputer.hpp"
 
 class ProtectedTaskManager;
+class ContestThread;
 
 class GlideComputerTask: 
   virtual public GlideComputerBlackboard 
@@ -43,6 +44,12 @@ class GlideComputerTask:
 
   ContestComputer contest;
 
+  /**
+   * If set, the incremental contest search is delegated to this
+   * thread, and ProcessIdle() only collects its results.
+   */
+  ContestThread *contest_thread;
+
 public:
   GlideComputerTask(ProtectedTaskManager& task,
                     const Airspaces &airspace_database);
@@ -59,6 +66,10 @@ public:
     return trace;
   }
 
+  void SetContestThread(ContestThread *_contest_thread) {
+    contest_thread = _contest_thread;
+  }
+
   void LockedCopyTraceTo(TracePointVector &v) const {
     trace.LockedCopyTo(v);
   }
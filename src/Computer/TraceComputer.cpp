@@ -23,11 +23,11 @@ Copyright_License {
 
 #include "TraceComputer.hpp"
 #include "SettingsComputer.hpp"
-#include "Engine/Navigation/Aircraft.hpp"
 
 TraceComputer::TraceComputer()
  :full(60),
-  sprint(0, 9000, 300)
+  sprint(0, 9000, 300),
+  serial(1), reset_serial(1)
 {
 }
 
@@ -36,9 +36,10 @@ TraceComputer::Reset()
 {
   mutex.Lock();
   full.clear();
+  sprint.clear();
+  reset_serial = ++serial;
   mutex.Unlock();
 
-  sprint.clear();
   last_time = fixed_zero;
 }
 
@@ -60,6 +61,44 @@ TraceComputer::LockedCopyTo(TracePointVector &v, unsigned min_time,
   mutex.Unlock();
 }
 
+bool
+TraceComputer::LockedCopyTo(Trace &full_r, Trace &sprint_r,
+                            unsigned &last_serial) const
+{
+  mutex.Lock();
+
+  if (serial == last_serial) {
+    mutex.Unlock();
+    return false;
+  }
+
+  if (last_serial < reset_serial || serial - last_serial > LOG_SIZE) {
+    full_r.CopyFrom(full);
+    sprint_r.CopyFrom(sprint);
+    last_serial = serial;
+    mutex.Unlock();
+    return true;
+  }
+
+  LogEntry entries[LOG_SIZE];
+  const unsigned n = serial - last_serial;
+  for (unsigned i = 0; i < n; ++i)
+    entries[i] = log[(last_serial + 1 + i) % LOG_SIZE];
+
+  last_serial = serial;
+  mutex.Unlock();
+
+  for (unsigned i = 0; i < n; ++i) {
+    full_r.append(entries[i].state);
+    if (entries[i].sprint)
+      sprint_r.append(entries[i].state);
+  }
+
+  full_r.optimise_if_old();
+  sprint_r.optimise_if_old();
+  return true;
+}
+
 void
 TraceComputer::Update(const SETTINGS_COMPUTER &settings_computer,
                       const AircraftState &state)
@@ -74,17 +113,22 @@ TraceComputer::Update(const SETTINGS_COMPUTER &settings_computer,
   if (!state.flying)
     return;
 
+  if (!settings_computer.task.enable_olc &&
+      !settings_computer.task.enable_trace)
+    return;
+
+  ScopeLock protect(mutex);
+
   // either olc or basic trace requires trace_full
-  if (settings_computer.task.enable_olc ||
-      settings_computer.task.enable_trace) {
-    mutex.Lock();
-    full.append(state);
-    mutex.Unlock();
-  }
+  full.append(state);
 
   // only olc requires trace_sprint
   if (settings_computer.task.enable_olc)
     sprint.append(state);
+
+  LogEntry &entry = log[++serial % LOG_SIZE];
+  entry.state = state;
+  entry.sprint = settings_computer.task.enable_olc;
 }
 
 void
@@ -94,12 +138,15 @@ TraceComputer::Idle(const SETTINGS_COMPUTER &settings_computer,
   if (!state.flying)
     return;
 
-  if (settings_computer.task.enable_olc ||
-      settings_computer.task.enable_trace) {
-    mutex.Lock();
-    full.optimise_if_old();
-    mutex.Unlock();
-  }
+  if (!settings_computer.task.enable_olc &&
+      !settings_computer.task.enable_trace)
+    return;
+
+  /* this doesn't modify #serial: the copies made by LockedCopyTo()
+     are thinned on their own */
+  ScopeLock protect(mutex);
+
+  full.optimise_if_old();
 
   if (settings_computer.task.enable_olc)
     sprint.optimise_if_old();
@@ -26,23 +26,61 @@ Copyright_License {
 
 #include "Thread/Mutex.hpp"
 #include "Engine/Trace/Trace.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
 
 struct SETTINGS_COMPUTER;
-struct AircraftState;
 
 /**
  * Record a trace of the current flight.
  */
 class TraceComputer {
+  enum {
+    /**
+     * The number of appended states remembered for incremental
+     * copies.  A caller which falls further behind gets a full copy.
+     */
+    LOG_SIZE = 64,
+  };
+
+  /**
+   * A state which was passed to Trace::append().
+   */
+  struct LogEntry {
+    AircraftState state;
+
+    /** was it appended to the sprint trace, too? */
+    bool sprint;
+  };
+
   /**
-   * This mutex protects trace_full: it must be locked while editing
-   * the trace, and while reading it from a thread other than the
-   * #CalculationThread.
+   * This mutex protects #full, #sprint, #serial, #reset_serial and
+   * #log: it must be locked while editing the traces, and while
+   * reading them from a thread other than the #CalculationThread.
    */
   mutable Mutex mutex;
 
   Trace full, sprint;
 
+  /**
+   * Incremented each time a state is appended, and by Reset().  This
+   * lets LockedCopyTo() skip the copy if the caller's snapshot is
+   * still up to date.  It starts at 1, so 0 never refers to a
+   * snapshot.
+   */
+  unsigned serial;
+
+  /**
+   * The #serial value set by the last Reset().  Snapshots older than
+   * this need a full copy.
+   */
+  unsigned reset_serial;
+
+  /**
+   * The most recently appended states, indexed by their #serial
+   * modulo #LOG_SIZE.
+   */
+  LogEntry log[LOG_SIZE];
+
   fixed last_time;
 
 public:
@@ -65,8 +103,9 @@ public:
   }
 
   /**
-   * Returns an unprotected reference to the sprint trace.  This
-   * object may be used only inside the #CalculationThread.
+   * Returns a reference to the sprint trace.  When using this
+   * reference outside of the #CalculationThread, the mutex must be
+   * locked.
    */
   const Trace &GetSprint() const {
     return sprint;
@@ -87,6 +126,27 @@ public:
   void LockedCopyTo(TracePointVector &v, unsigned min_time,
                             const GeoPoint &location, fixed resolution) const;
 
+  /**
+   * Bring the specified copies of both traces up to date.
+   *
+   * If no more than #LOG_SIZE states have been appended since the
+   * caller's snapshot, and the traces have not been reset since,
+   * only these states are copied while the trace is locked; they are
+   * then appended to the copies after the lock is released.  The
+   * copies do their own thinning, so their points may differ from
+   * the originals in the part of the flight which has been thinned.
+   * Otherwise, both traces are copied completely.
+   *
+   * The trace is locked, and the method may be called from any
+   * thread.
+   *
+   * @param last_serial the serial of the caller's copy, 0 to force a
+   * full copy; it is updated by this method
+   * @return true if the copies were modified
+   */
+  bool LockedCopyTo(Trace &full_r, Trace &sprint_r,
+                    unsigned &last_serial) const;
+
   void Update(const SETTINGS_COMPUTER &settings_computer,
               const AircraftState &state);
   void Idle(const SETTINGS_COMPUTER &settings_computer,
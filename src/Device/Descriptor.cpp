@@ -56,8 +56,10 @@ DeviceDescriptor::DeviceDescriptor()
 #ifdef ANDROID
    internal_gps(NULL),
 #endif
+   published(false),
    ticker(false), busy(false)
 {
+  parsed_info.Reset();
 }
 
 DeviceDescriptor::~DeviceDescriptor()
@@ -77,6 +79,8 @@ DeviceDescriptor::Open(Port *_port, const struct DeviceRegister *_driver,
 
   reopen_clock.update();
 
+  ResetParsedData();
+
   device_blackboard.mutex.Lock();
   device_blackboard.SetRealState(index).Reset();
   device_blackboard.ScheduleMerge();
@@ -176,6 +180,8 @@ DeviceDescriptor::Close()
   pDevPipeTo = NULL;
   ticker = false;
 
+  ResetParsedData();
+
   device_blackboard.mutex.Lock();
   device_blackboard.SetRealState(index).Reset();
   device_blackboard.ScheduleMerge();
@@ -270,7 +276,12 @@ DeviceDescriptor::ParseNMEA(const char *line, NMEAInfo &info)
        sent to the device */
     const ExternalSettings old_received = settings_received;
     settings_received = info.settings;
-    info.settings.EliminateRedundant(settings_sent, old_received);
+
+    publish_mutex.Lock();
+    const ExternalSettings sent = settings_sent;
+    publish_mutex.Unlock();
+
+    info.settings.EliminateRedundant(sent, old_received);
 
     return true;
   }
@@ -324,10 +335,9 @@ DeviceDescriptor::PutMacCready(fixed value)
   if (!device->PutMacCready(value))
     return false;
 
-  ScopeLock protect(device_blackboard.mutex);
-  NMEAInfo &basic = device_blackboard.SetRealState(index);
+  ScopeLock protect(publish_mutex);
   settings_sent.mac_cready = value;
-  settings_sent.mac_cready_available.Update(basic.clock);
+  settings_sent.mac_cready_available.Update(fixed(MonotonicClockMS()) / 1000);
 
   return true;
 }
@@ -341,10 +351,9 @@ DeviceDescriptor::PutBugs(fixed value)
   if (!device->PutBugs(value))
     return false;
 
-  ScopeLock protect(device_blackboard.mutex);
-  NMEAInfo &basic = device_blackboard.SetRealState(index);
+  ScopeLock protect(publish_mutex);
   settings_sent.bugs = value;
-  settings_sent.bugs_available.Update(basic.clock);
+  settings_sent.bugs_available.Update(fixed(MonotonicClockMS()) / 1000);
 
   return true;
 }
@@ -358,10 +367,9 @@ DeviceDescriptor::PutBallast(fixed value)
   if (!device->PutBallast(value))
     return false;
 
-  ScopeLock protect(device_blackboard.mutex);
-  NMEAInfo &basic = device_blackboard.SetRealState(index);
+  ScopeLock protect(publish_mutex);
   settings_sent.ballast_fraction = value;
-  settings_sent.ballast_fraction_available.Update(basic.clock);
+  settings_sent.ballast_fraction_available.Update(fixed(MonotonicClockMS()) / 1000);
 
   return true;
 }
@@ -393,10 +401,9 @@ DeviceDescriptor::PutQNH(const AtmosphericPressure &value)
   if (!device->PutQNH(value))
     return false;
 
-  ScopeLock protect(device_blackboard.mutex);
-  NMEAInfo &basic = device_blackboard.SetRealState(index);
+  ScopeLock protect(publish_mutex);
   settings_sent.qnh = value;
-  settings_sent.qnh_available.Update(basic.clock);
+  settings_sent.qnh_available.Update(fixed(MonotonicClockMS()) / 1000);
 
   return true;
 }
@@ -493,13 +500,44 @@ DeviceDescriptor::OnSysTicker(const DerivedInfo &calculated)
   }
 }
 
+void
+DeviceDescriptor::ResetParsedData()
+{
+  parsed_info.Reset();
+
+  ScopeLock protect(publish_mutex);
+  published = false;
+}
+
+bool
+DeviceDescriptor::CollectParsedData(NMEAInfo &dest)
+{
+  ScopeLock protect(publish_mutex);
+  if (!published)
+    return false;
+
+  dest = published_info;
+  published = false;
+  return true;
+}
+
 bool
 DeviceDescriptor::ParseLine(const char *line)
 {
-  ScopeLock protect(device_blackboard.mutex);
-  NMEAInfo &basic = device_blackboard.SetRealState(index);
-  basic.UpdateClock();
-  return ParseNMEA(line, basic);
+  /* apply the expiry which DeviceBlackboard::Merge() and
+     DeviceBlackboard::expire_wall_clock() have applied to the
+     published copy meanwhile */
+  parsed_info.UpdateClock();
+  parsed_info.ExpireWallClock();
+  parsed_info.Expire();
+
+  if (!ParseNMEA(line, parsed_info))
+    return false;
+
+  ScopeLock protect(publish_mutex);
+  published_info = parsed_info;
+  published = true;
+  return true;
 }
 
 void
@@ -29,13 +29,14 @@ Copyright_License {
 #include "Profile/DeviceConfig.hpp"
 #include "RadioFrequency.hpp"
 #include "NMEA/ExternalSettings.hpp"
+#include "NMEA/Info.hpp"
 #include "PeriodClock.hpp"
+#include "Thread/Mutex.hpp"
 
 #include <assert.h>
 #include <tchar.h>
 #include <stdio.h>
 
-struct NMEAInfo;
 struct DerivedInfo;
 class Port;
 class Device;
@@ -89,6 +90,31 @@ class DeviceDescriptor : public Port::Handler {
    */
   ExternalSettings settings_received;
 
+  /**
+   * The port thread parses NMEA sentences into this object, so it
+   * doesn't need to lock the DeviceBlackboard.  Only the port thread
+   * accesses it, and Open()/Close() while there is no port thread.
+   */
+  NMEAInfo parsed_info;
+
+  /**
+   * Protects #published_info, #published and #settings_sent.  This
+   * lock is only held for copying, never while parsing.
+   */
+  Mutex publish_mutex;
+
+  /**
+   * A copy of #parsed_info which is waiting to be collected by
+   * DeviceBlackboard::Merge().
+   */
+  NMEAInfo published_info;
+
+  /**
+   * Has #published_info been updated since the last
+   * CollectParsedData() call?
+   */
+  bool published;
+
   bool was_connected;
 
   bool ticker;
@@ -213,9 +239,23 @@ public:
   gcc_pure
   bool IsConnected() const;
 
+  /**
+   * Copy the data which was parsed since the last call.  Called by
+   * DeviceBlackboard::Merge() while holding the blackboard lock.
+   *
+   * @return true if new data was copied to #dest
+   */
+  bool CollectParsedData(NMEAInfo &dest);
+
 private:
   bool ParseNMEA(const char *line, struct NMEAInfo &info);
 
+  /**
+   * Forget all parsed data.  Must not be called while the port
+   * thread is running.
+   */
+  void ResetParsedData();
+
 public:
   void WriteNMEA(const char *line);
 #ifdef _UNICODE
@@ -47,8 +47,6 @@ using std::max;
 
 bool NMEAParser::ignore_checksum;
 
-int NMEAParser::StartDay = -1;
-
 /**
  * Constructor of the NMEAParser class
  * @return NMEAParser object
@@ -67,6 +65,7 @@ NMEAParser::Reset(void)
   use_geoid = true;
   GGAAvailable = false;
   LastTime = fixed_zero;
+  StartDay = -1;
 }
 
 /**
@@ -37,7 +37,7 @@ public:
   static bool ignore_checksum;
 
 private:
-  static int StartDay;
+  int StartDay;
 
   bool GGAAvailable;
   fixed LastTime;
@@ -87,8 +87,8 @@ private:
   fixed TimeAdvanceTolerance(fixed time) const;
 
   bool TimeHasAdvanced(fixed ThisTime, NMEAInfo &info);
-  static fixed TimeModify(fixed FixTime, BrokenDateTime &date_time,
-                          bool date_available);
+  fixed TimeModify(fixed FixTime, BrokenDateTime &date_time,
+                   bool date_available);
 
   bool GLL(NMEAInputLine &line, NMEAInfo &info);
   bool GGA(NMEAInputLine &line, NMEAInfo &info);
@@ -27,6 +27,8 @@ Copyright_License {
 #include "UtilsSystem.hpp"
 #include "Asset.hpp"
 #include "Device/All.hpp"
+#include "Device/List.hpp"
+#include "Device/Descriptor.hpp"
 #include "Math/Constants.h"
 #include "GlideSolvers/GlidePolar.hpp"
 #include "Simulator.hpp"
@@ -61,6 +63,9 @@ DeviceBlackboard::Initialise()
     per_device_data[i] = gps_info;
 
   real_data = simulator_data = replay_data = gps_info;
+
+  ++basic_serial;
+  ++calculated_serial;
 }
 
 /**
@@ -223,6 +228,7 @@ void
 DeviceBlackboard::ReadBlackboard(const DerivedInfo &derived_info)
 {
   calculated_info = derived_info;
+  ++calculated_serial;
 }
 
 /**
@@ -269,8 +275,12 @@ DeviceBlackboard::ScheduleMerge()
 void
 DeviceBlackboard::Merge()
 {
+  ++basic_serial;
+
   real_data.Reset();
   for (unsigned i = 0; i < NUMDEV; ++i) {
+    DeviceList[i].CollectParsedData(per_device_data[i]);
+
     if (!per_device_data[i].connected)
       continue;
 
@@ -50,7 +50,8 @@ class DeviceBlackboard:
   Simulator simulator;
 
   /**
-   * Data from each physical device.
+   * Data from each physical device.  The devices parse into private
+   * buffers, which are collected by Merge().
    */
   NMEAInfo per_device_data[NUMDEV];
 
@@ -69,10 +70,25 @@ class DeviceBlackboard:
    */
   NMEAInfo replay_data;
 
+  /**
+   * Incremented each time Basic() is modified.  Readers remember the
+   * value of their last copy, and skip copying again if it has not
+   * changed.
+   */
+  unsigned basic_serial;
+
+  /**
+   * Incremented each time Calculated() is modified.
+   */
+  unsigned calculated_serial;
+
 public:
   Mutex mutex;
 
 public:
+  DeviceBlackboard()
+    :basic_serial(1), calculated_serial(1) {}
+
   void Initialise();
   void ReadBlackboard(const DerivedInfo &derived_info);
   void ReadSettingsComputer(const SETTINGS_COMPUTER &settings);
@@ -98,6 +114,22 @@ public:
 public:
   const NMEAInfo &RealState() const { return real_data; }
 
+  /**
+   * Returns a number which changes whenever Basic() is modified.  The
+   * caller must lock the blackboard.
+   */
+  unsigned GetBasicSerial() const {
+    return basic_serial;
+  }
+
+  /**
+   * Returns a number which changes whenever Calculated() is modified.
+   * The caller must lock the blackboard.
+   */
+  unsigned GetCalculatedSerial() const {
+    return calculated_serial;
+  }
+
   /**
    * Is the specified device a FLARM?
    *
@@ -138,8 +170,9 @@ public:
   void ScheduleMerge();
 
   /**
-   * Copy real_data or simulator_data or replay_data to gps_info.
-   * Caller must lock the blackboard.
+   * Collect new data from the devices, and copy real_data or
+   * simulator_data or replay_data to gps_info.  Caller must lock the
+   * blackboard.
    */
   void Merge();
 };
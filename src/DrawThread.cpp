@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "DrawThread.hpp"
 #include "MapWindow/GlueMapWindow.hpp"
+#include "PerfLog.hpp"
 
 #ifndef ENABLE_OPENGL
 
@@ -34,6 +35,8 @@ DrawThread::Run()
 {
   SetLowPriority();
 
+  PerfCounters::SetContext(PerfCounters::CONTEXT_DRAW);
+
   // bounds_dirty maintains the status of whether the map
   // bounds have changed and there are pending idle calls
   // to be run in the map.
@@ -72,7 +75,10 @@ DrawThread::Run()
       map.ExchangeBlackboard();
 
       // Draw the moving map
-      map.repaint();
+      {
+        ScopePerfTimer timer(PerfCounters::TIMER_DRAW);
+        map.repaint();
+      }
 
       if (trigger.Test()) {
         // interrupt re-calculation of bounds if there was a 
@@ -81,12 +87,14 @@ DrawThread::Run()
         continue;
       }
 
+      ScopePerfTimer timer(PerfCounters::TIMER_MAP_IDLE);
       bounds_dirty = map.Idle();
     } else if (bounds_dirty) {
       /* got the "stop" trigger? */
       if (CheckStoppedOrSuspended())
         break;
 
+      ScopePerfTimer timer(PerfCounters::TIMER_MAP_IDLE);
       bounds_dirty = map.Idle();
     }
   }
@@ -222,6 +222,20 @@ public:
     days_of_operation = mask;
   }
 
+  /**
+   * Is the border of the airspace convex?
+   */
+  bool IsConvex() const {
+    return m_is_convex;
+  }
+
+  /**
+   * Get the days of operation of the airspace
+   */
+  const AirspaceActivity &GetDays() const {
+    return days_of_operation;
+  }
+
   /** 
    * Get type of airspace
    * 
@@ -0,0 +1,137 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "AirspaceCandidateSet.hpp"
+#include "AirspaceIntersectionVisitor.hpp"
+#include "Navigation/Geometry/GeoVector.hpp"
+#include "Navigation/Flat/FlatRay.hpp"
+#include "Navigation/Aircraft.hpp"
+
+#include <stdlib.h>
+
+AirspaceCandidateSet::AirspaceCandidateSet(const Airspaces &airspaces)
+  :m_airspaces(airspaces), m_serial(0), m_valid(false),
+   m_center(0, 0), m_range(0)
+{
+}
+
+void
+AirspaceCandidateSet::clear()
+{
+  m_candidates.clear();
+  m_valid = false;
+}
+
+bool
+AirspaceCandidateSet::covers(const FlatGeoPoint &location,
+                             const int range) const
+{
+  return m_valid && m_serial == m_airspaces.get_serial() &&
+    abs(location.Longitude - m_center.Longitude) + range <= m_range &&
+    abs(location.Latitude - m_center.Latitude) + range <= m_range;
+}
+
+bool
+AirspaceCandidateSet::update(const GeoPoint &location, const fixed range)
+{
+  if (m_airspaces.empty()) {
+    clear();
+    return false;
+  }
+
+  const TaskProjection &projection = m_airspaces.get_task_projection();
+  const FlatGeoPoint flat_location = projection.project(location);
+  if (covers(flat_location, projection.project_range(location, range)))
+    return false;
+
+  m_center = flat_location;
+  m_range = projection.project_range(location, range * 2);
+  m_candidates = m_airspaces.scan_box(location, m_range);
+  m_serial = m_airspaces.get_serial();
+  m_valid = true;
+  return true;
+}
+
+void
+AirspaceCandidateSet::visit_intersecting(const GeoPoint &loc,
+                                         const GeoVector &vec,
+                                         AirspaceIntersectionVisitor &visitor) const
+{
+  const TaskProjection &projection = m_airspaces.get_task_projection();
+
+  /* same search box as Airspaces::visit_intersecting() */
+  const GeoPoint c = vec.mid_point(loc);
+  const FlatGeoPoint flat_c = projection.project(c);
+  const int mrange = projection.project_range(c, vec.Distance / 2);
+  if (!covers(flat_c, mrange)) {
+    m_airspaces.visit_intersecting(loc, vec, visitor);
+    return;
+  }
+
+  const FlatRay ray(projection.project(loc),
+                    projection.project(vec.end_point(loc)));
+  const FlatBoundingBox target(flat_c, mrange);
+
+  for (Airspaces::AirspaceVector::const_iterator it = m_candidates.begin();
+       it != m_candidates.end(); ++it)
+    if (it->overlaps(target) && it->intersects(ray) &&
+        visitor.set_intersections(it->intersects(loc, vec)))
+      visitor.Visit(*it);
+}
+
+void
+AirspaceCandidateSet::visit_inside(const GeoPoint &loc,
+                                   AirspaceVisitor &visitor) const
+{
+  const FlatGeoPoint flat_loc =
+    m_airspaces.get_task_projection().project(loc);
+  if (!covers(flat_loc, 0)) {
+    m_airspaces.visit_inside(loc, visitor);
+    return;
+  }
+
+  const FlatBoundingBox target(flat_loc);
+  for (Airspaces::AirspaceVector::const_iterator it = m_candidates.begin();
+       it != m_candidates.end(); ++it)
+    if (it->overlaps(target) && it->inside(loc))
+      visitor.Visit(*it);
+}
+
+const Airspaces::AirspaceVector
+AirspaceCandidateSet::find_inside(const AircraftState &state,
+                                  const AirspacePredicate &condition) const
+{
+  const FlatGeoPoint flat_loc =
+    m_airspaces.get_task_projection().project(state.location);
+  if (!covers(flat_loc, 0))
+    return m_airspaces.find_inside(state, condition);
+
+  const FlatBoundingBox target(flat_loc);
+  Airspaces::AirspaceVector result;
+  for (Airspaces::AirspaceVector::const_iterator it = m_candidates.begin();
+       it != m_candidates.end(); ++it)
+    if (it->overlaps(target) && condition(*it->get_airspace()) &&
+        it->inside(state))
+      result.push_back(*it);
+
+  return result;
+}
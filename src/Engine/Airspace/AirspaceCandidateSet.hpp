@@ -0,0 +1,108 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef AIRSPACE_CANDIDATE_SET_HPP
+#define AIRSPACE_CANDIDATE_SET_HPP
+
+#include "Airspaces.hpp"
+#include "Navigation/Flat/FlatGeoPoint.hpp"
+
+struct GeoPoint;
+class GeoVector;
+class AirspaceVisitor;
+class AirspaceIntersectionVisitor;
+class AirspacePredicate;
+
+/**
+ * A temporally coherent subset of an #Airspaces store: all airspaces
+ * whose bounding box overlaps a square envelope around a reference
+ * location.  Queries which fit entirely inside the envelope are
+ * answered from the (small) candidate list, everything else is
+ * forwarded to the store.  The set is rebuilt only when the aircraft
+ * moves too close to the edge of the envelope, or when the store has
+ * been modified.
+ *
+ * Candidates are kept in the order the kd-tree visits them, so the
+ * queries report exactly the same airspaces in the same order as the
+ * corresponding #Airspaces methods.
+ */
+class AirspaceCandidateSet {
+  const Airspaces &m_airspaces;
+
+  Airspaces::AirspaceVector m_candidates;
+
+  /** serial of #m_airspaces when the set was built */
+  unsigned m_serial;
+
+  /** is the set valid at all? */
+  bool m_valid;
+
+  /** center and projected half-width of the envelope */
+  FlatGeoPoint m_center;
+  int m_range;
+
+public:
+  AirspaceCandidateSet(const Airspaces &airspaces);
+
+  /** Forget all candidates; queries go to the store until next update() */
+  void clear();
+
+  /**
+   * Make sure the envelope covers all locations within the given
+   * range of the aircraft, rebuilding it (with twice that range, to
+   * allow the aircraft to move) if necessary.
+   *
+   * @param location Location of the aircraft
+   * @param range Distance (m) from the aircraft that must be covered
+   *
+   * @return True if the set was rebuilt
+   */
+  bool update(const GeoPoint &location, const fixed range);
+
+  gcc_pure
+  unsigned size() const {
+    return m_candidates.size();
+  }
+
+  /** Same as Airspaces::visit_intersecting() */
+  void visit_intersecting(const GeoPoint &loc, const GeoVector &vec,
+                          AirspaceIntersectionVisitor &visitor) const;
+
+  /** Same as Airspaces::visit_inside() */
+  void visit_inside(const GeoPoint &loc, AirspaceVisitor &visitor) const;
+
+  /** Same as Airspaces::find_inside() */
+  gcc_pure
+  const Airspaces::AirspaceVector
+  find_inside(const AircraftState &state,
+              const AirspacePredicate &condition) const;
+
+private:
+  /**
+   * Is the square of the given projected half-width around the
+   * location inside the envelope?
+   */
+  gcc_pure
+  bool covers(const FlatGeoPoint &location, const int range) const;
+};
+
+#endif
@@ -57,6 +57,17 @@ AirspacePolygon::AirspacePolygon(const std::vector<GeoPoint> &pts,
       m_is_convex = m_border.IsConvex();
     }
   }
+
+  m_polygon.SetLocations(m_border);
+}
+
+AirspacePolygon::AirspacePolygon(const SearchPointVector &border,
+                                 const bool is_convex)
+  :AbstractAirspace(POLYGON)
+{
+  m_border = border;
+  m_is_convex = is_convex;
+  m_polygon.SetLocations(m_border);
 }
 
 const GeoPoint 
@@ -68,10 +79,17 @@ AirspacePolygon::GetCenter() const
   return m_border[0].get_location();
 }
 
+void
+AirspacePolygon::Project(const TaskProjection &tp)
+{
+  AbstractAirspace::Project(tp);
+  m_polygon.SetFlatLocations(m_border);
+}
+
 bool 
 AirspacePolygon::Inside(const GeoPoint &loc) const
 {
-  return m_border.IsInside(loc);
+  return m_polygon.IsInside(loc);
 }
 
 AirspaceIntersectionVector
@@ -83,14 +101,11 @@ AirspacePolygon::Intersects(const GeoPoint &start, const GeoVector &vec) const
 
   AirspaceIntersectSort sorter(start, end, *this);
 
-  for (SearchPointVector::const_iterator it = m_border.begin();
-       it + 1 != m_border.end(); ++it) {
-
-    const FlatRay r_seg(it->get_flatLocation(), (it + 1)->get_flatLocation());
-    fixed t;
-    if (ray.intersects_distinct(r_seg, t))
-      sorter.add(t, m_task_projection->unproject(ray.parametric(t)));
-  }
+  const unsigned n = m_polygon.GetEdgeCount();
+  fixed t;
+  for (unsigned i = m_polygon.NextIntersection(ray, 0, t); i < n;
+       i = m_polygon.NextIntersection(ray, i + 1, t))
+    sorter.add(t, m_task_projection->unproject(ray.parametric(t)));
 
   return sorter.all();
 }
@@ -99,6 +114,6 @@ GeoPoint
 AirspacePolygon::ClosestPoint(const GeoPoint &loc) const
 {
   const FlatGeoPoint p = m_task_projection->project(loc);
-  const FlatGeoPoint pb = m_border.NearestPoint(p);
+  const FlatGeoPoint pb = m_polygon.NearestPoint(p);
   return m_task_projection->unproject(pb);
 }
@@ -24,6 +24,7 @@
 #define AIRSPACEPOLYGON_HPP
 
 #include "AbstractAirspace.hpp"
+#include "Navigation/SearchPolygon.hpp"
 #include <vector>
 
 #ifdef DO_PRINT
@@ -34,6 +35,9 @@
 class AirspacePolygon: 
   public AbstractAirspace 
 {
+  /** copy of #m_border laid out for the Inside()/Intersects() kernels */
+  SearchPolygon m_polygon;
+
 public:
   /** 
    * Constructor.  For testing, pts vector is a cloud of points,
@@ -46,6 +50,15 @@ public:
    */
   AirspacePolygon(const std::vector<GeoPoint> &pts, const bool prune = false);
 
+  /**
+   * Constructor for a border which has been closed and checked
+   * before, e.g. by a previous instance loaded from a cache file.
+   *
+   * @param border Closed border
+   * @param is_convex Whether the border is convex
+   */
+  AirspacePolygon(const SearchPointVector &border, const bool is_convex);
+
   /**
    * Get arbitrary center or reference point for use in determining
    * overall center location of all airspaces
@@ -78,6 +91,9 @@ public:
 
   GeoPoint ClosestPoint(const GeoPoint &loc) const;
 
+protected:
+  void Project(const TaskProjection &tp);
+
 public:
 #ifdef DO_PRINT
   friend std::ostream& operator<< (std::ostream& f, 
@@ -30,11 +30,18 @@
 
 #define CRUISE_FILTER_FACT fixed_half
 
+/**
+ * Lower bound of the speed (m/s) used to size the candidate envelope,
+ * so a slow or stationary aircraft doesn't rebuild it too often.
+ */
+#define CANDIDATE_MIN_SPEED fixed(50)
+
 AirspaceWarningManager::AirspaceWarningManager(const Airspaces& airspaces,
                                                const TaskManager &task_manager,
                                                const fixed& prediction_time_glide,
                                                const fixed& prediction_time_filter):
   m_airspaces(airspaces),
+  m_candidates(airspaces),
   m_prediction_time_glide(prediction_time_glide),
   m_prediction_time_filter(prediction_time_filter),
   m_perf_glide(task_manager.get_glide_polar()),
@@ -60,6 +67,7 @@ void
 AirspaceWarningManager::reset(const AircraftState& state)
 {
   m_warnings.clear();
+  m_candidates.clear();
   m_cruise_filter.Reset(state);
   m_circling_filter.Reset(state);
 }
@@ -116,6 +124,12 @@ AirspaceWarningManager::update(const AircraftState& state,
     return false;
   }
 
+  // the predictions below look at most this far; the candidate set
+  // is only rebuilt when the aircraft gets close to its edge
+  m_candidates.update(state.location,
+                      max(m_prediction_time_glide, m_prediction_time_filter) *
+                      max(state.ground_speed, CANDIDATE_MIN_SPEED));
+
   // save old state
   for (AirspaceWarningList::iterator it = m_warnings.begin();
        it != m_warnings.end(); ++it)
@@ -288,10 +302,10 @@ AirspaceWarningManager::update_predicted(const AircraftState& state,
                                              ceiling);
 
   GeoVector vector_predicted(state.location, location_predicted);
-  m_airspaces.visit_intersecting(state.location, vector_predicted, visitor);
+  m_candidates.visit_intersecting(state.location, vector_predicted, visitor);
 
   visitor.set_mode(true);
-  m_airspaces.visit_inside(state.location, visitor);
+  m_candidates.visit_inside(state.location, visitor);
 
   return visitor.found();
 }
@@ -355,7 +369,7 @@ AirspaceWarningManager::update_inside(const AircraftState& state)
 
   AirspacePredicateAircraftInside condition(state);
 
-  Airspaces::AirspaceVector results = m_airspaces.find_inside(state, condition);
+  Airspaces::AirspaceVector results = m_candidates.find_inside(state, condition);
   for (Airspaces::AirspaceVector::iterator it = results.begin();
        it != results.end(); ++it) {
 
@@ -26,6 +26,7 @@
 #include "AirspaceWarning.hpp"
 #include "AirspaceWarningConfig.hpp"
 #include "AirspaceAircraftPerformance.hpp"
+#include "AirspaceCandidateSet.hpp"
 #include "Compiler.h"
 
 #include <list>
@@ -52,6 +53,12 @@ class AirspaceWarningManager:
 
   const Airspaces& m_airspaces;
 
+  /**
+   * Airspaces near the aircraft; the per-cycle searches run on this
+   * instead of the whole store.
+   */
+  AirspaceCandidateSet m_candidates;
+
   fixed m_prediction_time_glide;
   fixed m_prediction_time_filter;
 
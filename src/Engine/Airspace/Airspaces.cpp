@@ -25,11 +25,7 @@
 #include "Atmosphere/Pressure.hpp"
 #include "Navigation/Aircraft.hpp"
 #include "Navigation/Geometry/GeoVector.hpp"
-
-#ifdef INSTRUMENT_TASK
-extern unsigned n_queries;
-extern long count_intersections;
-#endif
+#include "Util/PerfCounters.hpp"
 
 class AirspacePredicateVisitorAdapter {
   const AirspacePredicate *predicate;
@@ -55,14 +51,11 @@ Airspaces::visit_within_range(const GeoPoint &loc,
 {
   if (empty()) return; // nothing to do
 
-  Airspace bb_target(loc, task_projection);
-  int mrange = task_projection.project_range(loc, range);
+  const Airspace bb_target(loc, task_projection, range);
   AirspacePredicateVisitorAdapter adapter(predicate, visitor);
-  airspace_tree.visit_within_range(bb_target, -mrange, adapter);
+  airspace_tree.visit_overlapping(bb_target, adapter);
 
-#ifdef INSTRUMENT_TASK
-  n_queries++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_AIRSPACE_QUERIES);
 }
 
 class IntersectingAirspaceVisitorAdapter {
@@ -96,14 +89,11 @@ Airspaces::visit_intersecting(const GeoPoint &loc,
               task_projection.project(vec.end_point(loc)));
 
   GeoPoint c = vec.mid_point(loc);
-  Airspace bb_target(c, task_projection);
-  int mrange = task_projection.project_range(c, vec.Distance / 2);
+  const Airspace bb_target(c, task_projection, vec.Distance / 2);
   IntersectingAirspaceVisitorAdapter adapter(loc, vec, ray, visitor);
-  airspace_tree.visit_within_range(bb_target, -mrange, adapter);
+  airspace_tree.visit_overlapping(bb_target, adapter);
 
-#ifdef INSTRUMENT_TASK
-  n_queries++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_AIRSPACE_QUERIES);
 }
 
 // SCAN METHODS
@@ -119,6 +109,12 @@ struct AirspacePredicateAdapter {
   }
 };
 
+struct AirspaceAlwaysTrue {
+  bool operator()(const Airspace &as) const {
+    return true;
+  }
+};
+
 const Airspace *
 Airspaces::find_nearest(const GeoPoint &location,
                         const AirspacePredicate &condition) const
@@ -129,8 +125,8 @@ Airspaces::find_nearest(const GeoPoint &location,
   const Airspace bb_target(location, task_projection);
   const int mrange = task_projection.project_range(location, fixed(30000));
   const AirspacePredicateAdapter predicate(condition);
-  std::pair<AirspaceTree::const_iterator, AirspaceTree::distance_type> found =
-    airspace_tree.find_nearest_if(bb_target, BBDist(0, mrange), predicate);
+  std::pair<AirspaceTree::const_iterator, unsigned> found =
+    airspace_tree.find_nearest_if(bb_target, mrange, predicate);
 
   return found.first != airspace_tree.end()
     ? &*found.first
@@ -145,18 +141,17 @@ Airspaces::scan_nearest(const GeoPoint &location,
 
   Airspace bb_target(location, task_projection);
 
-  std::pair<AirspaceTree::const_iterator, AirspaceTree::distance_type>
-    found = airspace_tree.find_nearest(bb_target);
+  std::pair<AirspaceTree::const_iterator, unsigned>
+    found = airspace_tree.find_nearest_if(bb_target, 0 - 1,
+                                          AirspaceAlwaysTrue());
 
-#ifdef INSTRUMENT_TASK
-  n_queries++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_AIRSPACE_QUERIES);
 
   AirspaceVector res;
   if (found.first != airspace_tree.end()) {
     // also should do scan_range with range = 0 since there
     // could be more than one with zero dist
-    if (found.second.is_zero()) {
+    if (found.second == 0) {
       return scan_range(location, fixed_zero, condition);
     } else {
       if (condition(*found.first->get_airspace()))
@@ -174,15 +169,14 @@ Airspaces::scan_range(const GeoPoint &location,
 {
   if (empty()) return AirspaceVector(); // nothing to do
 
-  Airspace bb_target(location, task_projection);
-  int mrange = task_projection.project_range(location, range);
-  
+  const Airspace bb_target(location, task_projection);
+  const unsigned mrange = task_projection.project_range(location, range);
+  const Airspace bb_range(location, task_projection, range);
+
   std::deque< Airspace > vectors;
-  airspace_tree.find_within_range(bb_target, -mrange, std::back_inserter(vectors));
+  airspace_tree.find_overlapping(bb_range, std::back_inserter(vectors));
 
-#ifdef INSTRUMENT_TASK
-  n_queries++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_AIRSPACE_QUERIES);
 
   AirspaceVector res;
 
@@ -190,7 +184,7 @@ Airspaces::scan_range(const GeoPoint &location,
     if (!condition(*v->get_airspace()))
       continue;
 
-    if (fixed((*v).distance(bb_target)) > range)
+    if ((*v).distance(bb_target) > mrange)
       continue;
 
     if ((*v).inside(location) || positive(range))
@@ -204,21 +198,17 @@ const Airspaces::AirspaceVector
 Airspaces::find_inside(const AircraftState &state,
                        const AirspacePredicate &condition) const
 {
-  Airspace bb_target(state.location, task_projection);
+  const Airspace bb_target(state.location, task_projection);
 
   AirspaceVector vectors;
-  airspace_tree.find_within_range(bb_target, 0, std::back_inserter(vectors));
+  airspace_tree.find_overlapping(bb_target, std::back_inserter(vectors));
 
-#ifdef INSTRUMENT_TASK
-  n_queries++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_AIRSPACE_QUERIES);
 
   for (AirspaceVector::iterator v = vectors.begin(); v != vectors.end();) {
 
-#ifdef INSTRUMENT_TASK
-    count_intersections++;
-#endif
-    
+    PerfCounters::Increment(PerfCounters::COUNT_AIRSPACE_INTERSECTIONS);
+
     if (!condition(*v->get_airspace()) || !(*v).inside(state))
       vectors.erase(v);
     else
@@ -242,6 +232,7 @@ Airspaces::optimise()
       tmp_as.push_back(it->get_airspace());
 
     airspace_tree.clear();
+    ++serial;
   }
 
   if (!tmp_as.empty()) {
@@ -251,6 +242,7 @@ Airspaces::optimise()
       tmp_as.pop_front();
     }
     airspace_tree.optimise();
+    ++serial;
   }
 }
 
@@ -302,6 +294,7 @@ Airspaces::clear()
 
   // then delete the tree
   airspace_tree.clear();
+  ++serial;
 }
 
 unsigned
@@ -364,10 +357,26 @@ Airspaces::Airspaces(const Airspaces& master,
   m_QNH(master.m_QNH),
   m_day(master.m_day),
   m_owner(owner),
-  task_projection(master.task_projection)
+  task_projection(master.task_projection),
+  serial(0)
 {
 }
 
+const Airspaces::AirspaceVector
+Airspaces::scan_box(const GeoPoint &location, const int mrange) const
+{
+  AirspaceVector vectors;
+  if (empty())
+    return vectors;
+
+  FlatBoundingBox bb_target(task_projection.project(location), mrange);
+  airspace_tree.find_overlapping(bb_target, std::back_inserter(vectors));
+
+  PerfCounters::Increment(PerfCounters::COUNT_AIRSPACE_QUERIES);
+
+  return vectors;
+}
+
 void
 Airspaces::clear_clearances()
 {
@@ -421,10 +430,7 @@ Airspaces::synchronise_in_range(const Airspaces& master,
     for (AirspaceTree::iterator t = airspace_tree.begin();
          t != airspace_tree.end(); ) {
       if (t->get_airspace() == v->get_airspace()) {
-        AirspaceTree::const_iterator new_t = t;
-        ++new_t;
-        airspace_tree.erase_exact(*t);
-        t = new_t;
+        t = airspace_tree.erase(t);
         found = true;
       } else {
         ++t;
@@ -446,9 +452,9 @@ Airspaces::visit_inside(const GeoPoint &loc,
 {
   if (empty()) return; // nothing to do
 
-  Airspace bb_target(loc, task_projection);
+  const Airspace bb_target(loc, task_projection);
   AirspaceVector vectors;
-  airspace_tree.find_within_range(bb_target, 0, std::back_inserter(vectors));
+  airspace_tree.find_overlapping(bb_target, std::back_inserter(vectors));
 
   for (AirspaceVector::iterator v = vectors.begin(); v != vectors.end(); ++v) {
     if ((*v).inside(loc))
@@ -37,21 +37,21 @@ class AirspaceVisitor;
 class AirspaceIntersectionVisitor;
 
 /**
- * Container for airspaces using kd-tree representation internally for fast 
- * geospatial lookups.
+ * Container for airspaces using a packed R-tree representation
+ * internally for fast geospatial lookups.
  *
- * Complexity analysis (with kdtree):
+ * Complexity analysis (with R-tree):
  *   
  *    Find within range (k points found):
- *     O(n^(3/4) + k)
+ *     O(log(n) + k)
  *
  *    Find intersecting:
- *     O(n^(3/4) + k)
+ *     O(log(n) + k)
  *
  *    Find nearest:
  *     O(log(n))
  *
- *  Without kd-tree:
+ *  Without R-tree:
  *
  *    Find within range:
  *     O(n)
@@ -73,6 +73,12 @@ class Airspaces:
   AirspaceTree airspace_tree;
   TaskProjection task_projection;
 
+  /**
+   * Incremented whenever the tree is rebuilt or cleared; lets
+   * clients holding #Airspace copies detect that they are stale.
+   */
+  unsigned serial;
+
   std::deque< AbstractAirspace* > tmp_as;
 
 public:
@@ -85,7 +91,7 @@ public:
    *
    * @return empty Airspaces class.
    */
-  Airspaces():m_QNH(0), m_owner(true) {}
+  Airspaces():m_QNH(0), m_owner(true), serial(0) {}
 
   /**
    * Make a copy of the airspaces metadata
@@ -245,6 +251,21 @@ public:
                                    const AirspacePredicate &condition
                                    =AirspacePredicate::always_true) const;
 
+  /**
+   * Find airspaces whose bounding box overlaps the square of the
+   * given projected half-width around a location.  The result is in
+   * the order the tree visits matches, which is the order all other
+   * queries report them in.
+   *
+   * @param location Center of the square
+   * @param mrange Half-width in projected units
+   *
+   * @return airspaces overlapping the square
+   */
+  gcc_pure
+  const AirspaceVector scan_box(const GeoPoint &location,
+                                const int mrange) const;
+
   /**
    * Access first airspace in store, for use in iterators.
    *
@@ -265,6 +286,10 @@ public:
     return task_projection;
   }
 
+  unsigned get_serial() const {
+    return serial;
+  }
+
   /**
    * Empty clearance polygons of all airspaces in this database
    */
@@ -22,10 +22,8 @@
 #ifndef AIRSPACESINTERFACE_HPP
 #define AIRSPACESINTERFACE_HPP
 
-#include "Util/SliceAllocator.hpp"
 #include "Airspace.hpp"
-
-#include <kdtree++/kdtree.hpp>
+#include "Navigation/Flat/PackedRTree.hpp"
 
 /**
  * Abstract class for interface to #Airspaces database.
@@ -37,15 +35,9 @@ public:
   typedef std::vector<Airspace> AirspaceVector; /**< Vector of airspaces (used internally) */
 
   /**
-   * Type of KD-tree data structure for airspace container
+   * Type of R-tree data structure for airspace container
    */
-  typedef KDTree::KDTree<4, 
-                         Airspace, 
-                         FlatBoundingBox::kd_get_bounds,
-                         FlatBoundingBox::kd_distance,
-                         std::less<FlatBoundingBox::kd_get_bounds::result_type>,
-                         SliceAllocator<KDTree::_Node<Airspace>, 256>
-                         > AirspaceTree;
+  typedef PackedRTree<Airspace> AirspaceTree;
 };
 
 #endif
@@ -156,6 +156,36 @@ ContestManager::UpdateIdle(bool exhaustive)
   return retval;
 }
 
+bool
+ContestManager::IsBusy() const
+{
+  switch (contest) {
+  case OLC_Sprint:
+    return olc_sprint.IsBusy();
+
+  case OLC_FAI:
+    return olc_fai.IsBusy();
+
+  case OLC_Classic:
+  case OLC_League:
+    return olc_classic.IsBusy();
+
+  case OLC_Plus:
+    return olc_classic.IsBusy() || olc_fai.IsBusy();
+
+  case OLC_XContest:
+    return olc_xcontest_free.IsBusy() || olc_xcontest_triangle.IsBusy();
+
+  case OLC_DHVXC:
+    return olc_dhvxc_free.IsBusy() || olc_dhvxc_triangle.IsBusy();
+
+  case OLC_SISAT:
+    return olc_sisat.IsBusy();
+  };
+
+  return false;
+}
+
 void
 ContestManager::Reset()
 {
@@ -95,6 +95,13 @@ public:
     return UpdateIdle(true);
   }
 
+  /**
+   * Is one of the solvers of the current contest in the middle of a
+   * search?  If yes, calling UpdateIdle() again will make progress.
+   */
+  gcc_pure
+  bool IsBusy() const;
+
   /** 
    * Reset the task (as if never flown)
    */
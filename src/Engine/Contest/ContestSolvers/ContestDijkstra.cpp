@@ -24,13 +24,12 @@ Copyright_License {
 #include "ContestDijkstra.hpp"
 #include "../ContestResult.hpp"
 #include "Trace/Trace.hpp"
+#include "Util/PerfCounters.hpp"
 
 #include <algorithm>
 #include <assert.h>
 #include <limits.h>
 
-unsigned long ContestDijkstra::count_olc_solve = 0;
-unsigned long ContestDijkstra::count_olc_trace = 0;
 unsigned ContestDijkstra::count_olc_size = 0;
 
 // set size of reserved queue elements (may differ from Dijkstra default)
@@ -111,7 +110,7 @@ ContestDijkstra::update_trace()
   n_points = trace.size();
   trace_dirty = true;
 
-  count_olc_trace++;
+  PerfCounters::Increment(PerfCounters::COUNT_CONTEST_TRACE);
 
   if (n_points<2) return;
 }
@@ -149,7 +148,7 @@ ContestDijkstra::Solve(bool exhaustive)
   if (trace_dirty) {
     trace_dirty = false;
 
-    dijkstra.restart(ScanTaskPoint(0, 0));
+    dijkstra.restart(ScanTaskPoint(0, 0), num_stages, n_points);
     start_search();
     add_start_edges();
     if (dijkstra.empty()) {
@@ -157,7 +156,7 @@ ContestDijkstra::Solve(bool exhaustive)
     }
   }
 
-  count_olc_solve++;
+  PerfCounters::Increment(PerfCounters::COUNT_CONTEST_SOLVE);
   count_olc_size = max(count_olc_size, dijkstra.queue_size());
 
   if (distance_general(exhaustive ? 0 - 1 : 25)) {
@@ -179,8 +178,6 @@ ContestDijkstra::Reset()
 
   AbstractContest::Reset();
 
-  count_olc_solve = 0;
-  count_olc_trace = 0;
   count_olc_size = 0;
 }
 
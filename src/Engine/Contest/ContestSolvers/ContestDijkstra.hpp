@@ -42,11 +42,13 @@ class ContestDijkstra:
   public NavDijkstra<TracePoint>
 {
   bool solution_found;
-  bool trace_dirty;
 
   TracePointVector trace; // working trace for solver
 
 protected:
+  /** Has the working trace changed since the last search started? */
+  bool trace_dirty;
+
   /** Number of points in current trace set */
   unsigned n_points;
 
@@ -56,8 +58,7 @@ protected:
   ContestTraceVector best_solution;
 
 public: // instrumentation
-  static unsigned long count_olc_solve;
-  static unsigned long count_olc_trace;
+  /** The largest queue size seen so far */
   static unsigned count_olc_size;
 
 public:
@@ -95,6 +96,14 @@ public:
    */
   virtual bool Solve(bool exhaustive);
 
+  /**
+   * Is a search in progress, i.e. will the next Solve() call
+   * continue where the previous one stopped?
+   */
+  virtual bool IsBusy() const {
+    return !dijkstra.empty();
+  }
+
 protected:
   gcc_pure
   const TracePoint &GetPointFast(const ScanTaskPoint &sp) const {
@@ -166,11 +175,15 @@ protected:
     return GetPointFast(s1).flat_distance(GetPointFast(s2));
   }
 
-private:
-  virtual void add_start_edges();
-
+  /**
+   * Is the master trace far enough ahead of the working trace that
+   * update_trace() would take a new copy?
+   */
   gcc_pure
   bool master_is_updated() const;
+
+private:
+  virtual void add_start_edges();
 };
 
 #endif
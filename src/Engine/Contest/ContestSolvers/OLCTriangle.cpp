@@ -20,7 +20,9 @@
 }
  */
 #include "OLCTriangle.hpp"
-#include "Navigation/Flat/FlatRay.hpp"
+#include "TriangleSecondLeg.hpp"
+
+#include <algorithm>
 
 /*
  @todo potential to use 3d convex hull to speed search
@@ -41,12 +43,26 @@
   4: end
 */
 
+/**
+ * Index ranges up to this size are not split any further, all point
+ * pairs are checked.
+ */
+static const unsigned LEAF_SIZE = 8;
+
+/**
+ * The amount of work done by one incremental Solve() call, roughly
+ * counted in point pairs.
+ */
+static const unsigned SEARCH_STEPS = 8192;
+
 OLCTriangle::OLCTriangle(const Trace &_trace,
                          const bool _is_fai):
   ContestDijkstra(_trace, 3, 1000),
+  best_first(0), best_second(0),
   is_closed(false),
   is_complete(false),
   first_tp(0),
+  best_d(0),
   is_fai(_is_fai)
 {}
 
@@ -55,6 +71,9 @@ void
 OLCTriangle::Reset()
 {
   ContestDijkstra::Reset();
+  nodes.clear();
+  candidates.clear();
+  best_first = best_second = 0;
   is_complete = false;
   is_closed = false;
   first_tp = 0;
@@ -110,26 +129,6 @@ OLCTriangle::path_closed() const
   return false;
 }
 
-class TriangleSecondLeg {
-  const bool is_fai;
-  const TracePoint a, b;
-  const unsigned df_1;
-
-public:
-  TriangleSecondLeg(bool _fai, const TracePoint &_a, const TracePoint &_b)
-    :is_fai(_fai), a(_a), b(_b), df_1(a.flat_distance(b)) {}
-
-  struct Result {
-    unsigned leg_distance, total_distance;
-
-    Result(unsigned _leg, unsigned _total)
-      :leg_distance(_leg), total_distance(_total) {}
-  };
-
-  gcc_pure
-  Result Calculate(const TracePoint &c, unsigned best) const;
-};
-
 TriangleSecondLeg::Result
 TriangleSecondLeg::Calculate(const TracePoint &c, unsigned best) const
 {
@@ -205,77 +204,6 @@ TriangleSecondLeg::Calculate(const TracePoint &c, unsigned best) const
 }
 
 
-void
-OLCTriangle::add_start_edges()
-{
-  // use last point as single start,
-  // this is out of order but required
-
-  dijkstra.pop();
-  ScanTaskPoint destination(0, n_points-1);
-  dijkstra.link(destination, destination, 0);
-}
-
-
-void 
-OLCTriangle::add_edges(const ScanTaskPoint& origin)
-{
-  assert(origin.point_index < n_points);
-  ScanTaskPoint destination(origin.stage_number + 1, origin.point_index + 1);
-
-  switch (destination.stage_number) {
-  case 1:
-    // add points up to finish
-    for (destination.point_index = 0;
-         destination.point_index < origin.point_index;
-         ++destination.point_index) {
-      const unsigned d = 
-        distance(origin, destination);
-
-      if (!is_fai || (4*d >= best_d)) { // no reason to add candidate if worse
-                                        // than 25% rule for FAI tasks
-        dijkstra.link(destination, origin,
-                      get_weighting(origin.stage_number) * d);
-      }
-
-    }
-    break;
-  case 2: {
-    ScanTaskPoint previous = dijkstra.get_predecessor(origin);
-
-    // give first leg points to penultimate node
-    TriangleSecondLeg sl(is_fai, GetPointFast(previous), GetPointFast(origin));
-    for (; destination.point_index < n_points-1; ++destination.point_index) {
-      TriangleSecondLeg::Result result = sl.Calculate(GetPointFast(destination),
-                                                      best_d);
-      const unsigned d = result.leg_distance;
-      if (d) {
-        best_d = result.total_distance;
-
-        dijkstra.link(destination, origin,
-                      get_weighting(origin.stage_number) * d);
-
-        // we have an improved solution
-        is_complete = true;
-
-        // need to scan again whether path is closed
-        is_closed = false;
-        first_tp = origin.point_index;
-      }
-    }
-  }
-    break;
-  case 3:
-    // dummy just to close the triangle
-    destination.point_index = n_points - 1;
-    dijkstra.link(destination, origin, 0);
-    break;
-  default:
-    assert(1);
-  }
-}
-
-
 fixed
 OLCTriangle::CalcDistance() const
 {
@@ -306,11 +234,224 @@ OLCTriangle::CalcScore() const
   return ApplyHandicap(CalcDistance()*fixed(0.001));
 }
 
+unsigned
+OLCTriangle::BuildTree(unsigned begin, unsigned end)
+{
+  assert(begin < end);
+
+  const unsigned index = nodes.size();
+  nodes.push_back(Node());
+
+  FlatBoundingBox box(GetPointFast(ScanTaskPoint(0, begin)).get_flatLocation());
+  unsigned children[2] = { 0, 0 };
+
+  if (end - begin <= LEAF_SIZE) {
+    for (unsigned i = begin + 1; i < end; ++i)
+      box.expand(GetPointFast(ScanTaskPoint(0, i)).get_flatLocation());
+  } else {
+    const unsigned middle = (begin + end) / 2;
+    children[0] = BuildTree(begin, middle);
+    children[1] = BuildTree(middle, end);
+
+    box = nodes[children[0]].box;
+    box.expand(nodes[children[1]].box);
+  }
+
+  /* don't keep a reference across the recursion, push_back() may
+     have moved the vector */
+  Node &node = nodes[index];
+  node.box = box;
+  node.begin = begin;
+  node.end = end;
+  node.children[0] = children[0];
+  node.children[1] = children[1];
+  return index;
+}
+
+unsigned
+OLCTriangle::CalcBound(unsigned first, unsigned second) const
+{
+  const FlatBoundingBox &a = nodes[first].box, &b = nodes[second].box;
+  const FlatBoundingBox finish(GetPointFast(ScanTaskPoint(0, n_points - 1))
+                               .get_flatLocation());
+
+  const unsigned d1 = finish.max_distance(a);
+  const unsigned d2 = a.max_distance(b);
+  const unsigned d3 = b.max_distance(finish);
+
+  const unsigned bound = d1 + d2 + d3;
+  if (!is_fai)
+    return bound;
+
+  // a FAI triangle fails unless its shortest leg has 25% of the total
+  const unsigned fai_bound = 4 * std::min(d1, std::min(d2, d3));
+
+  /* ... which can't be achieved if even the shortest possible
+     perimeter is longer than that */
+  if (fai_bound < finish.distance(a) + a.distance(b) + b.distance(finish))
+    return 0;
+
+  return std::min(bound, fai_bound);
+}
+
+void
+OLCTriangle::AddCandidate(unsigned first, unsigned second)
+{
+  // the first turn point must be before the second one
+  if (nodes[first].begin + 1 >= nodes[second].end)
+    return;
+
+  const unsigned bound = CalcBound(first, second);
+  if (bound > best_d)
+    candidates.push_back(Candidate(first, second, bound));
+}
+
+void
+OLCTriangle::StartSearch()
+{
+  nodes.clear();
+  candidates.clear();
+  best_first = best_second = 0;
+
+  /* the best perimeter of the previous search must not bound this
+     one: it was closed at another finish point, and it is measured in
+     the flat projection of the previous trace copy, which may have
+     changed */
+  best_d = 0;
+
+  // the last point closes the triangle, it is not a turn point
+  const unsigned root = BuildTree(0, n_points - 1);
+  AddCandidate(root, root);
+}
+
+unsigned
+OLCTriangle::ScanLeaf(const Candidate &c)
+{
+  const Node &a = nodes[c.first], &b = nodes[c.second];
+  const TracePoint &finish = GetPointFast(ScanTaskPoint(0, n_points - 1));
+
+  unsigned count = 0;
+  for (unsigned i = a.begin; i < a.end; ++i) {
+    const unsigned j_begin = std::max(b.begin, i + 1);
+    if (j_begin >= b.end)
+      break;
+
+    const TriangleSecondLeg sl(is_fai, finish,
+                               GetPointFast(ScanTaskPoint(0, i)));
+    for (unsigned j = j_begin; j < b.end; ++j) {
+      const TriangleSecondLeg::Result result =
+        sl.Calculate(GetPointFast(ScanTaskPoint(0, j)), best_d);
+      if (result.leg_distance) {
+        // we have an improved solution
+        best_d = result.total_distance;
+        best_first = i;
+        best_second = j;
+      }
+    }
+
+    count += b.end - j_begin;
+  }
+
+  return count;
+}
+
+bool
+OLCTriangle::RunSearch(unsigned max_steps)
+{
+  unsigned steps = 0;
+
+  while (!candidates.empty()) {
+    if (steps >= max_steps)
+      return false;
+
+    const Candidate c = candidates.back();
+    candidates.pop_back();
+    ++steps;
+
+    if (c.bound <= best_d)
+      /* a better triangle has been found since this candidate was
+         added */
+      continue;
+
+    const Node &a = nodes[c.first], &b = nodes[c.second];
+    if (a.IsLeaf() && b.IsLeaf()) {
+      steps += ScanLeaf(c);
+      continue;
+    }
+
+    // split the larger index range
+    const unsigned n_candidates = candidates.size();
+    if (!a.IsLeaf() &&
+        (b.IsLeaf() || a.end - a.begin >= b.end - b.begin)) {
+      AddCandidate(a.children[0], c.second);
+      AddCandidate(a.children[1], c.second);
+    } else {
+      AddCandidate(c.first, b.children[0]);
+      AddCandidate(c.first, b.children[1]);
+    }
+
+    /* visit the more promising half first */
+    if (candidates.size() == n_candidates + 2 &&
+        candidates[n_candidates].bound > candidates[n_candidates + 1].bound)
+      std::swap(candidates[n_candidates], candidates[n_candidates + 1]);
+  }
+
+  return true;
+}
+
 void
-OLCTriangle::start_search()
+OLCTriangle::FinishSearch()
 {
+  if (best_second <= best_first)
+    return;
+
+  const TracePoint &finish = GetPointFast(ScanTaskPoint(0, n_points - 1));
+  solution[0] = finish;
+  solution[1] = GetPointFast(ScanTaskPoint(0, best_first));
+  solution[2] = GetPointFast(ScanTaskPoint(0, best_second));
+  solution[3] = finish;
+
+  is_complete = true;
+
+  // need to scan again whether path is closed
+  is_closed = false;
+  first_tp = best_first;
+
+  SaveSolution();
 }
 
+bool
+OLCTriangle::Solve(bool exhaustive)
+{
+  bool finished = false;
+  if (!candidates.empty() && (exhaustive || master_is_updated())) {
+    /* a new trace copy is due: complete the search of the current
+       one before it gets replaced, or triangles closed at its finish
+       point would never be seen */
+    RunSearch(0 - 1);
+    FinishSearch();
+    finished = true;
+  }
+
+  if (candidates.empty()) {
+    update_trace();
+    if (n_points < num_stages)
+      return true;
+
+    if (!trace_dirty)
+      // don't re-start search unless we have had new data appear
+      return true;
+
+    trace_dirty = false;
+    StartSearch();
+  }
+
+  if (!RunSearch(exhaustive ? 0 - 1 : SEARCH_STEPS))
+    return finished;
+
+  FinishSearch();
+  return true;
+}
 
 bool 
 OLCTriangle::UpdateScore()
@@ -24,13 +24,64 @@
 #define OLC_TRIANGLE_HPP
 
 #include "ContestDijkstra.hpp"
+#include "Navigation/Flat/FlatBoundingBox.hpp"
+
+#include <vector>
 
 /**
  * Specialisation of OLC Dijkstra for OLC Triangle (triangle) rules
+ *
+ * The triangle is closed at the most recent trace point; the other
+ * two turn points are chosen by a branch-and-bound search instead of
+ * the Dijkstra queue.  The trace index range is split recursively,
+ * each range is annotated with the bounding box of its points, and
+ * pairs of ranges whose largest possible perimeter cannot beat the
+ * best triangle found so far are discarded.  The result is the
+ * triangle with the largest flat perimeter on the (thinned) trace
+ * which passes TriangleSecondLeg.
+ *
+ * Each search runs on a new copy of the trace and is bounded only by
+ * triangles of that copy; the score is the best result of all
+ * searches so far.  A search is always completed before the next
+ * trace copy is taken, so no copy is skipped.
  */
 class OLCTriangle: 
   public ContestDijkstra
 {
+  /**
+   * A node of the bounding box tree over the trace point indices
+   * [begin, end).
+   */
+  struct Node {
+    FlatBoundingBox box;
+    unsigned begin, end;
+    unsigned children[2];
+
+    bool IsLeaf() const {
+      return children[0] == 0;
+    }
+  };
+
+  /**
+   * A pending pair of index ranges: the first turn point is within
+   * node #first, the second one within node #second.
+   */
+  struct Candidate {
+    unsigned first, second;
+
+    /** upper bound of the flat perimeter */
+    unsigned bound;
+
+    Candidate(unsigned _first, unsigned _second, unsigned _bound)
+      :first(_first), second(_second), bound(_bound) {}
+  };
+
+  std::vector<Node> nodes;
+  std::vector<Candidate> candidates;
+
+  /** indices of the best turn points found by the current search */
+  unsigned best_first, best_second;
+
 protected:
   bool is_closed;
   bool is_complete;
@@ -44,6 +95,12 @@ public:
 
   void Reset();
 
+  virtual bool Solve(bool exhaustive);
+
+  virtual bool IsBusy() const {
+    return !candidates.empty();
+  }
+
 protected:
   virtual bool SaveSolution();
 
@@ -55,14 +112,37 @@ protected:
 
   bool path_closed() const;
 
-  void add_edges(const ScanTaskPoint &curNode);
-
-  void start_search();
-
   bool UpdateScore();
 
 private:
-  void add_start_edges();
+  unsigned BuildTree(unsigned begin, unsigned end);
+
+  gcc_pure
+  unsigned CalcBound(unsigned first, unsigned second) const;
+
+  void AddCandidate(unsigned first, unsigned second);
+
+  void StartSearch();
+
+  /**
+   * Evaluate all point pairs of a candidate.
+   *
+   * @return the number of pairs that were checked
+   */
+  unsigned ScanLeaf(const Candidate &c);
+
+  /**
+   * Continue the search.
+   *
+   * @param max_steps the maximum amount of work to be done
+   * @return true if the search is finished
+   */
+  bool RunSearch(unsigned max_steps);
+
+  /**
+   * Store the triangle found by the finished search as the solution.
+   */
+  void FinishSearch();
 };
 
 #endif
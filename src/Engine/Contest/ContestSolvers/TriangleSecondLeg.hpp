@@ -0,0 +1,59 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef TRIANGLE_SECOND_LEG_HPP
+#define TRIANGLE_SECOND_LEG_HPP
+
+#include "Navigation/TracePoint.hpp"
+#include "Compiler.h"
+
+/**
+ * Checks the candidate third vertex of a triangle, given the other
+ * two, against the (FAI) triangle rules, in flat projection.
+ */
+class TriangleSecondLeg {
+  const bool is_fai;
+  const TracePoint a, b;
+  const unsigned df_1;
+
+public:
+  TriangleSecondLeg(bool _fai, const TracePoint &_a, const TracePoint &_b)
+    :is_fai(_fai), a(_a), b(_b), df_1(a.flat_distance(b)) {}
+
+  struct Result {
+    unsigned leg_distance, total_distance;
+
+    Result(unsigned _leg, unsigned _total)
+      :leg_distance(_leg), total_distance(_total) {}
+  };
+
+  /**
+   * @param best the total flat distance of the best triangle found
+   * so far; only better triangles are accepted
+   * @return the flat distance b-c-a and the total flat distance, or
+   * zero if the triangle is invalid or not better than #best
+   */
+  gcc_pure
+  Result Calculate(const TracePoint &c, unsigned best) const;
+};
+
+#endif
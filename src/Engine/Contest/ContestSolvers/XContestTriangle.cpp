@@ -64,7 +64,7 @@ XContestTriangle::CalcDistance() const
 bool 
 XContestTriangle::Solve(bool exhaustive)
 {
-  if (!ContestDijkstra::Solve(exhaustive))
+  if (!OLCTriangle::Solve(exhaustive))
     return false;
 
   best_d = 0; // reset heuristic
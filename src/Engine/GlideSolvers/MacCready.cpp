@@ -29,14 +29,10 @@
 #include "Navigation/Aircraft.hpp"
 #include "Util/ZeroFinder.hpp"
 #include "Util/Tolerances.hpp"
+#include "Util/PerfCounters.hpp"
 
 #define fixed_1mil fixed_int_constant(1000000)
 
-#ifdef INSTRUMENT_TASK
-// global, used for test harness
-long count_mc = 0;
-#endif
-
 MacCready::MacCready(const GlidePolar &_glide_polar,
                      const fixed _cruise_efficiency)
   :glide_polar(_glide_polar), cruise_efficiency(_cruise_efficiency) {}
@@ -90,9 +86,7 @@ MacCready::solve_vertical(const GlideState &task) const
 GlideResult
 MacCready::solve(const GlidePolar &glide_polar, const GlideState &task)
 {
-#ifdef INSTRUMENT_TASK
-  count_mc++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_MACCREADY);
   MacCready mac(glide_polar, glide_polar.GetCruiseEfficiency());
   return mac.solve(task);
 }
@@ -101,9 +95,7 @@ GlideResult
 MacCready::solve_sink(const GlidePolar &glide_polar, const GlideState &task,
                       const fixed S)
 {
-#ifdef INSTRUMENT_TASK
-  count_mc++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_MACCREADY);
   MacCready mac(glide_polar, glide_polar.GetCruiseEfficiency());
   return mac.solve_sink(task, S);
 }
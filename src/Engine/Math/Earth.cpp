@@ -22,10 +22,9 @@ Copyright_License {
 */
 
 #include "Math/Earth.hpp"
-#include <assert.h>
+#include "Util/PerfCounters.hpp"
 
-// global, used for test harness
-unsigned count_distbearing = 0;
+#include <assert.h>
 
 #define fixed_double_earth_r fixed(REARTH * 2)
 
@@ -89,9 +88,7 @@ IntermediatePoint(const GeoPoint loc1, const GeoPoint loc2, fixed dthis, fixed d
   loc3.Longitude = Angle::radians(atan2(y, x));
   loc3.normalize(); // ensure longitude is within -180:180
 
-#ifdef INSTRUMENT_TASK
-  count_distbearing++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_DISTANCE_BEARING);
 
   return loc3;
 }
@@ -152,9 +149,7 @@ DistanceBearingS(const GeoPoint loc1, const GeoPoint loc2,
       : Angle::radians(atan2(y, x)).as_bearing();
   }
 
-#ifdef INSTRUMENT_TASK
-  count_distbearing++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_DISTANCE_BEARING);
 }
 
 
@@ -198,9 +193,7 @@ CrossTrackError(const GeoPoint loc1, const GeoPoint loc2,
     *loc4 = IntermediatePoint(loc1, loc2, ATD, dist_AB.value_radians());
   }
 
-#ifdef INSTRUMENT_TASK
-  count_distbearing++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_DISTANCE_BEARING);
 
   // units
   return XTD * fixed_earth_r;
@@ -235,9 +228,7 @@ ProjectedDistance(const GeoPoint loc1, const GeoPoint loc2, const GeoPoint loc3)
   // along track distance
   const fixed ATD(earth_asin(sqrt(sindist_AD * sindist_AD - sinXTD * sinXTD) / cosXTD));
 
-#ifdef INSTRUMENT_TASK
-  count_distbearing++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_DISTANCE_BEARING);
 
   return ATD * fixed_earth_r;
 }
@@ -258,9 +249,7 @@ DoubleDistance(const GeoPoint loc1, const GeoPoint loc2, const GeoPoint loc3)
   const fixed a12 = sqr(s21) + cloc1Latitude * cloc2Latitude * sqr(sl21);
   const fixed a23 = sqr(s32) + cloc2Latitude * cloc3Latitude * sqr(sl32);
 
-#ifdef INSTRUMENT_TASK
-  count_distbearing++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_DISTANCE_BEARING);
 
   return fixed_double_earth_r * 
     (earth_distance_function(a12) + earth_distance_function(a23));
@@ -310,9 +299,7 @@ FindLatitudeLongitude(const GeoPoint loc, const Angle Bearing,
   loc_out.Longitude = Angle::radians(result);
   loc_out.normalize(); // ensure longitude is within -180:180
 
-#ifdef INSTRUMENT_TASK
-  count_distbearing++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_DISTANCE_BEARING);
 
   return loc_out;
 }
@@ -31,14 +31,26 @@ FlatBoundingBox::distance(const FlatBoundingBox &f) const
   if (overlaps(f))
     return 0;
 
-  long dx = max(0, min(f.bb_ll.Longitude - bb_ur.Longitude,
+  long dx = max(0, max(f.bb_ll.Longitude - bb_ur.Longitude,
                        bb_ll.Longitude - f.bb_ur.Longitude));
-  long dy = max(0, min(f.bb_ll.Latitude - bb_ur.Latitude,
+  long dy = max(0, max(f.bb_ll.Latitude - bb_ur.Latitude,
                        bb_ll.Latitude - f.bb_ur.Latitude));
 
   return lhypot(dx, dy);
 }
 
+unsigned
+FlatBoundingBox::max_distance(const FlatBoundingBox &f) const
+{
+  long dx = max(f.bb_ur.Longitude - bb_ll.Longitude,
+                bb_ur.Longitude - f.bb_ll.Longitude);
+  long dy = max(f.bb_ur.Latitude - bb_ll.Latitude,
+                bb_ur.Latitude - f.bb_ll.Latitude);
+
+  /* round up, lhypot() truncates */
+  return lhypot(dx, dy) + 1;
+}
+
 static void
 swap(fixed &t1, fixed &t2)
 {
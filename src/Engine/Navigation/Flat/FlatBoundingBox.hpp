@@ -81,6 +81,18 @@ public:
   gcc_pure
   unsigned distance(const FlatBoundingBox &f) const;
 
+  /**
+   * Calculate the largest distance between any point in this box
+   * and any point in the other box.  The result is never smaller
+   * than FlatGeoPoint::distance_to() between two such points.
+   *
+   * @param f That box
+   *
+   * @return Distance in projected units
+   */
+  gcc_pure
+  unsigned max_distance(const FlatBoundingBox &f) const;
+
   /**
    * Test whether a point is inside the bounding box
    *
@@ -24,32 +24,49 @@
 
 #include "Math/FastMath.h"
 
+#include <limits.h>
+
 #define sgn(x) (x >= 0 ? 1 : -1)
 
+/** cross product of two vectors, which overflows "int" for vectors
+    longer than ~46000 units (large airspaces) */
+static inline int64_t
+cross64(const FlatGeoPoint &a, const FlatGeoPoint &b)
+{
+  return (int64_t)a.Longitude * b.Latitude - (int64_t)a.Latitude * b.Longitude;
+}
+
+static inline int64_t
+abs64(int64_t x)
+{
+  return x >= 0 ? x : -x;
+}
+
 /*
  * Checks whether two lines intersect or not
  * @see http://local.wasp.uwa.edu.au/~pbourke/geometry/lineline2d/
  * adapted from line_line_intersection
  */
-std::pair<int, int>
+std::pair<int64_t, int64_t>
 FlatRay::intersects_ratio(const FlatRay &that) const
 {
-  std::pair<int, int> r;
-  r.second = vector.cross(that.vector);
+  std::pair<int64_t, int64_t> r;
+  r.second = cross64(vector, that.vector);
   if (r.second == 0)
     // lines are parallel
     return r;
 
   const FlatGeoPoint delta = that.point - point;
-  r.first = delta.cross(that.vector);
-  if ((sgn(r.first) * sgn(r.second) < 0) || (abs(r.first) > abs(r.second))) {
+  r.first = cross64(delta, that.vector);
+  if ((sgn(r.first) * sgn(r.second) < 0) ||
+      (abs64(r.first) > abs64(r.second))) {
     // outside first line
     r.second = 0;
     return r;
   }
 
-  const int ub = delta.cross(vector);
-  if ((sgn(ub) * sgn(r.second) < 0) || (abs(ub) > abs(r.second))) {
+  const int64_t ub = cross64(delta, vector);
+  if ((sgn(ub) * sgn(r.second) < 0) || (abs64(ub) > abs64(r.second))) {
     // outside second line
     r.second = 0;
     return r;
@@ -59,6 +76,17 @@ FlatRay::intersects_ratio(const FlatRay &that) const
   return r;
 }
 
+fixed
+FlatRay::ratio(int64_t numerator, int64_t denominator)
+{
+  while (denominator > INT_MAX || denominator < -INT_MAX) {
+    numerator /= 2;
+    denominator /= 2;
+  }
+
+  return ((fixed)(int)numerator) / (int)denominator;
+}
+
 FlatGeoPoint
 FlatRay::parametric(const fixed t) const
 {
@@ -71,29 +99,29 @@ FlatRay::parametric(const fixed t) const
 fixed
 FlatRay::intersects(const FlatRay &that) const
 {
-  std::pair<int, int> r = intersects_ratio(that);
+  std::pair<int64_t, int64_t> r = intersects_ratio(that);
   if (r.second == 0)
     return -fixed_one;
-  return ((fixed)r.first) / r.second;
+  return ratio(r.first, r.second);
 }
 
 bool
 FlatRay::intersects_distinct(const FlatRay& that) const
 {
-  std::pair<int, int> r = intersects_ratio(that);
+  std::pair<int64_t, int64_t> r = intersects_ratio(that);
   return (r.second != 0) &&
          (sgn(r.second) * r.first > 0) &&
-         (abs(r.first) < abs(r.second));
+         (abs64(r.first) < abs64(r.second));
 }
 
 bool
 FlatRay::intersects_distinct(const FlatRay& that, fixed& t) const
 {
-  std::pair<int, int> r = intersects_ratio(that);
+  std::pair<int64_t, int64_t> r = intersects_ratio(that);
   if (r.second != 0 &&
       sgn(r.second) * r.first > 0 &&
-      abs(r.first) < abs(r.second)) {
-    t = ((fixed)r.first) / r.second;
+      abs64(r.first) < abs64(r.second)) {
+    t = ratio(r.first, r.second);
     return true;
   }
 
@@ -27,6 +27,8 @@
 #include <utility>
 #include "Compiler.h"
 
+#include <stdint.h>
+
 /**
  * Projected ray (a point and vector) in 2-d cartesian integer coordinates
  */
@@ -80,9 +82,22 @@ public:
   bool
   intersects_distinct(const FlatRay& that, fixed& t) const;
 
+  /**
+   * Divide two cross products, scaling them down first if they don't
+   * fit in "int"; products of small rays give the same result as an
+   * "int" division.
+   */
+  gcc_const
+  static fixed ratio(int64_t numerator, int64_t denominator);
+
 private:
+  /**
+   * @return the cross products (ua, denominator) of the intersection,
+   * in 64 bit so that they don't overflow for large rays; the
+   * denominator is 0 if the rays don't intersect
+   */
   gcc_pure
-  std::pair<int, int> intersects_ratio(const FlatRay &that) const;
+  std::pair<int64_t, int64_t> intersects_ratio(const FlatRay &that) const;
 };
 
 #endif
@@ -0,0 +1,310 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef PACKED_RTREE_HPP
+#define PACKED_RTREE_HPP
+
+#include "FlatBoundingBox.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include <math.h>
+
+/**
+ * A static R-tree over objects derived from #FlatBoundingBox, bulk
+ * loaded with the Sort-Tile-Recursive algorithm.  Objects and node
+ * boxes are stored in contiguous arrays; there are no per-node
+ * allocations and no pointers to chase.
+ *
+ * Objects may be inserted and erased at any time, but this only marks
+ * the index as stale: until the next optimise(), queries fall back to
+ * a linear scan.  This suits data which is loaded once and then
+ * queried many times, such as airspaces.
+ *
+ * All queries report matching objects in storage order, so the
+ * results of two queries are always ordered consistently.
+ */
+template<typename T, unsigned NODE_SIZE = 8>
+class PackedRTree {
+  typedef std::vector<T> ItemVector;
+  typedef std::vector<FlatBoundingBox> BoxVector;
+
+  ItemVector items;
+
+  /**
+   * Node boxes of all levels, leaves (groups of NODE_SIZE objects)
+   * first, the root last.  The children of node i are the nodes
+   * i*NODE_SIZE to i*NODE_SIZE+NODE_SIZE-1 of the level below.
+   */
+  BoxVector nodes;
+
+  /** Index of the first node of each level in #nodes */
+  std::vector<unsigned> levels;
+
+  /** Has #items been modified since the last optimise()? */
+  bool stale;
+
+public:
+  typedef typename ItemVector::iterator iterator;
+  typedef typename ItemVector::const_iterator const_iterator;
+  typedef typename ItemVector::size_type size_type;
+
+  PackedRTree():stale(false) {}
+
+  size_type size() const {
+    return items.size();
+  }
+
+  bool empty() const {
+    return items.empty();
+  }
+
+  iterator begin() {
+    return items.begin();
+  }
+
+  iterator end() {
+    return items.end();
+  }
+
+  const_iterator begin() const {
+    return items.begin();
+  }
+
+  const_iterator end() const {
+    return items.end();
+  }
+
+  void clear() {
+    items.clear();
+    nodes.clear();
+    levels.clear();
+    stale = false;
+  }
+
+  void insert(const T &item) {
+    items.push_back(item);
+    stale = true;
+  }
+
+  iterator erase(iterator i) {
+    stale = true;
+    return items.erase(i);
+  }
+
+  /**
+   * (Re)build the index.  Must be called after inserting or erasing
+   * objects, before the next query.
+   */
+  void optimise() {
+    nodes.clear();
+    levels.clear();
+    stale = false;
+
+    if (items.empty())
+      return;
+
+    const unsigned n_leaves = (items.size() + NODE_SIZE - 1) / NODE_SIZE;
+    const unsigned n_slices = (unsigned)ceil(sqrt((double)n_leaves));
+    const unsigned slice_size = n_slices * NODE_SIZE;
+
+    /* sort into vertical slices, then each slice from south to
+       north */
+    std::sort(items.begin(), items.end(), CompareCenter(0));
+    for (unsigned i = 0; i < items.size(); i += slice_size)
+      std::sort(items.begin() + i,
+                items.begin() + std::min(i + slice_size,
+                                         (unsigned)items.size()),
+                CompareCenter(1));
+
+    /* leaves */
+    levels.push_back(0);
+    for (unsigned i = 0; i < items.size(); i += NODE_SIZE) {
+      FlatBoundingBox box = items[i];
+      const unsigned end = std::min(i + NODE_SIZE, (unsigned)items.size());
+      for (unsigned j = i + 1; j < end; ++j)
+        box.expand(items[j]);
+      nodes.push_back(box);
+    }
+
+    /* upper levels: consecutive nodes are already close to each
+       other */
+    while (nodes.size() - levels.back() > 1) {
+      const unsigned first = levels.back(), last = nodes.size();
+      levels.push_back(last);
+      for (unsigned i = first; i < last; i += NODE_SIZE) {
+        FlatBoundingBox box = nodes[i];
+        const unsigned end = std::min(i + NODE_SIZE, last);
+        for (unsigned j = i + 1; j < end; ++j)
+          box.expand(nodes[j]);
+        nodes.push_back(box);
+      }
+    }
+  }
+
+  /**
+   * Call visitor(object) for every object whose bounding box overlaps
+   * the given box.
+   */
+  template<typename Visitor>
+  void visit_overlapping(const FlatBoundingBox &box, Visitor &visitor) const {
+    if (stale) {
+      for (const_iterator i = items.begin(); i != items.end(); ++i)
+        if (i->overlaps(box))
+          visitor(*i);
+    } else if (!items.empty())
+      visit_overlapping(levels.size() - 1, 0, box, visitor);
+  }
+
+  /**
+   * Copy every object whose bounding box overlaps the given box to
+   * the output iterator.
+   */
+  template<typename OutputIterator>
+  OutputIterator find_overlapping(const FlatBoundingBox &box,
+                                  OutputIterator out) const {
+    CopyVisitor<OutputIterator> visitor(out);
+    visit_overlapping(box, visitor);
+    return visitor.out;
+  }
+
+  /**
+   * Find the object nearest to the given box (see
+   * FlatBoundingBox::distance()) which satisfies a predicate.
+   *
+   * @param max_distance Ignore objects further away than this
+   *
+   * @return The object (or end()) and its distance
+   */
+  template<typename Predicate>
+  std::pair<const_iterator, unsigned>
+  find_nearest_if(const FlatBoundingBox &box, unsigned max_distance,
+                  const Predicate &predicate) const {
+    unsigned best = items.size(), best_distance = max_distance;
+    if (stale) {
+      for (unsigned i = 0; i < items.size(); ++i)
+        check_nearest(i, box, predicate, best, best_distance);
+    } else if (!items.empty())
+      find_nearest(levels.size() - 1, 0, box, predicate,
+                   best, best_distance);
+
+    std::pair<const_iterator, unsigned> result(items.end(), best_distance);
+    if (best < items.size())
+      result.first = items.begin() + best;
+    return result;
+  }
+
+private:
+  struct CompareCenter {
+    unsigned axis;
+
+    CompareCenter(unsigned _axis):axis(_axis) {}
+
+    bool operator()(const T &a, const T &b) const {
+      const FlatGeoPoint ca = a.get_center(), cb = b.get_center();
+      return axis == 0
+        ? ca.Longitude < cb.Longitude
+        : ca.Latitude < cb.Latitude;
+    }
+  };
+
+  template<typename OutputIterator>
+  struct CopyVisitor {
+    OutputIterator out;
+
+    CopyVisitor(OutputIterator _out):out(_out) {}
+
+    void operator()(const T &item) {
+      *out++ = item;
+    }
+  };
+
+  /** Number of nodes in the given level */
+  unsigned level_size(unsigned level) const {
+    return (level + 1 < levels.size() ? levels[level + 1] : nodes.size())
+      - levels[level];
+  }
+
+  template<typename Visitor>
+  void visit_overlapping(unsigned level, unsigned node,
+                         const FlatBoundingBox &box, Visitor &visitor) const {
+    if (!nodes[levels[level] + node].overlaps(box))
+      return;
+
+    const unsigned first = node * NODE_SIZE;
+    if (level == 0) {
+      const unsigned end = std::min(first + NODE_SIZE,
+                                    (unsigned)items.size());
+      for (unsigned i = first; i < end; ++i)
+        if (items[i].overlaps(box))
+          visitor(items[i]);
+    } else {
+      const unsigned end = std::min(first + NODE_SIZE,
+                                    level_size(level - 1));
+      for (unsigned i = first; i < end; ++i)
+        visit_overlapping(level - 1, i, box, visitor);
+    }
+  }
+
+  template<typename Predicate>
+  void check_nearest(unsigned i, const FlatBoundingBox &box,
+                     const Predicate &predicate,
+                     unsigned &best, unsigned &best_distance) const {
+    const unsigned d = items[i].distance(box);
+    if ((d < best_distance || (d == best_distance && best >= items.size())) &&
+        predicate(items[i])) {
+      best = i;
+      best_distance = d;
+    }
+  }
+
+  /**
+   * Branch and bound search; objects are visited in storage order
+   * and only a strictly nearer one replaces the current best, so ties
+   * go to the first object like in the linear scan.
+   */
+  template<typename Predicate>
+  void find_nearest(unsigned level, unsigned node,
+                    const FlatBoundingBox &box, const Predicate &predicate,
+                    unsigned &best, unsigned &best_distance) const {
+    const unsigned d = nodes[levels[level] + node].distance(box);
+    if (d > best_distance || (d == best_distance && best < items.size()))
+      return;
+
+    const unsigned first = node * NODE_SIZE;
+    if (level == 0) {
+      const unsigned end = std::min(first + NODE_SIZE,
+                                    (unsigned)items.size());
+      for (unsigned i = first; i < end; ++i)
+        check_nearest(i, box, predicate, best, best_distance);
+    } else {
+      const unsigned end = std::min(first + NODE_SIZE,
+                                    level_size(level - 1));
+      for (unsigned i = first; i < end; ++i)
+        find_nearest(level - 1, i, box, predicate, best, best_distance);
+    }
+  }
+};
+
+#endif
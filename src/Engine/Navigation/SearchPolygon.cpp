@@ -0,0 +1,310 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "SearchPolygon.hpp"
+#include "SearchPointVector.hpp"
+#include "Flat/FlatRay.hpp"
+#include "Flat/FlatGeoPoint.hpp"
+
+#include <algorithm>
+
+#include <stdlib.h>
+
+void
+SearchPolygon::SetLocations(const SearchPointVector &v)
+{
+  const unsigned n = v.size();
+  latitude.resize(n);
+  longitude.resize(n);
+  for (unsigned i = 0; i < n; ++i) {
+    const GeoPoint &p = v[i].get_location();
+    latitude[i] = p.Latitude.value_native();
+    longitude[i] = p.Longitude.value_native();
+  }
+}
+
+void
+SearchPolygon::SetFlatLocations(const SearchPointVector &v)
+{
+  const unsigned n = v.size();
+  flat_x.resize(n);
+  flat_y.resize(n);
+  for (unsigned i = 0; i < n; ++i) {
+    const FlatGeoPoint &p = v[i].get_flatLocation();
+    flat_x[i] = p.Longitude;
+    flat_y[i] = p.Latitude;
+  }
+
+  tree.clear();
+  const unsigned n_edges = GetEdgeCount();
+  if (n_edges < 4 * LEAF_SIZE || flat_x.size() != n_edges + 1)
+    return;
+
+  unsigned depth = 0;
+  for (unsigned count = n_edges; count > LEAF_SIZE; count = (count + 1) / 2)
+    ++depth;
+
+  tree.resize((2u << depth) - 1);
+  BuildTree(0, 0, n_edges);
+}
+
+SearchPolygon::EdgeBox
+SearchPolygon::BuildTree(unsigned node, unsigned first, unsigned last)
+{
+  EdgeBox box;
+  if (last - first <= LEAF_SIZE) {
+    /* edge i spans vertices i and i+1 */
+    box.x_min = box.x_max = flat_x[first];
+    box.y_min = box.y_max = flat_y[first];
+    for (unsigned i = first + 1; i <= last; ++i) {
+      box.x_min = std::min(box.x_min, flat_x[i]);
+      box.x_max = std::max(box.x_max, flat_x[i]);
+      box.y_min = std::min(box.y_min, flat_y[i]);
+      box.y_max = std::max(box.y_max, flat_y[i]);
+    }
+  } else {
+    const unsigned middle = (first + last) / 2;
+    const EdgeBox a = BuildTree(2 * node + 1, first, middle);
+    const EdgeBox b = BuildTree(2 * node + 2, middle, last);
+    box.x_min = std::min(a.x_min, b.x_min);
+    box.x_max = std::max(a.x_max, b.x_max);
+    box.y_min = std::min(a.y_min, b.y_min);
+    box.y_max = std::max(a.y_max, b.y_max);
+  }
+
+  tree[node] = box;
+  return box;
+}
+
+bool
+SearchPolygon::EdgeBox::MayIntersect(const FlatRay &ray) const
+{
+  const int x0 = ray.point.Longitude, y0 = ray.point.Latitude;
+  const int vx = ray.vector.Longitude, vy = ray.vector.Latitude;
+
+  /* bounding box of the ray */
+  if (std::max(x0, x0 + vx) < x_min || std::min(x0, x0 + vx) > x_max ||
+      std::max(y0, y0 + vy) < y_min || std::min(y0, y0 + vy) > y_max)
+    return false;
+
+  /* all four corners strictly on one side of the ray's line; in 64
+     bit like FlatRay::intersects_ratio(), the products overflow "int"
+     for large polygons */
+  const int64_t c0 = (int64_t)vx * (y_min - y0) - (int64_t)vy * (x_min - x0);
+  const int64_t c1 = (int64_t)vx * (y_min - y0) - (int64_t)vy * (x_max - x0);
+  const int64_t c2 = (int64_t)vx * (y_max - y0) - (int64_t)vy * (x_min - x0);
+  const int64_t c3 = (int64_t)vx * (y_max - y0) - (int64_t)vy * (x_max - x0);
+  return !((c0 > 0 && c1 > 0 && c2 > 0 && c3 > 0) ||
+           (c0 < 0 && c1 < 0 && c2 < 0 && c3 < 0));
+}
+
+unsigned
+SearchPolygon::EdgeBox::DistanceSquared(int x, int y) const
+{
+  const unsigned dx = std::max(0, std::max(x_min - x, x - x_max));
+  const unsigned dy = std::max(0, std::max(y_min - y, y - y_max));
+  return dx * dx + dy * dy;
+}
+
+bool
+SearchPolygon::IsInside(const GeoPoint &p) const
+{
+  const unsigned n = latitude.size();
+  if (n < 3)
+    return false;
+
+  const fixed px = p.Longitude.value_native();
+  const fixed py = p.Latitude.value_native();
+  const fixed *x = &longitude[0];
+  const fixed *y = &latitude[0];
+
+  int wn = 0;
+  for (unsigned i = 0; i + 1 < n; ++i) {
+    const bool below = y[i] <= py;
+    if (below == (y[i + 1] <= py))
+      /* the edge doesn't cross the horizontal line through p */
+      continue;
+
+    const fixed left = (x[i + 1] - x[i]) * (py - y[i])
+      - (px - x[i]) * (y[i + 1] - y[i]);
+    if (below)
+      wn += positive(left);
+    else
+      wn -= negative(left);
+  }
+
+  return wn != 0;
+}
+
+unsigned
+SearchPolygon::ScanIntersection(const FlatRay &ray,
+                                unsigned i, unsigned last, fixed &t) const
+{
+  const int *x = &flat_x[0];
+  const int *y = &flat_y[0];
+  const int rx = ray.point.Longitude, ry = ray.point.Latitude;
+  const int vx = ray.vector.Longitude, vy = ray.vector.Latitude;
+
+  for (; i < last; ++i) {
+    const int sx = x[i + 1] - x[i], sy = y[i + 1] - y[i];
+
+    /* same as FlatRay::intersects_ratio() */
+    const int64_t denom = (int64_t)vx * sy - (int64_t)vy * sx;
+    const int dx = x[i] - rx, dy = y[i] - ry;
+    const int64_t ua = (int64_t)dx * sy - (int64_t)dy * sx;
+    const int64_t ub = (int64_t)dx * vy - (int64_t)dy * vx;
+    const int64_t abs_denom = denom >= 0 ? denom : -denom;
+    const bool denom_positive = denom >= 0;
+
+    /* same as FlatRay::intersects_distinct(): the intersection must
+       lie strictly inside the ray and within the segment */
+    if (denom == 0 || ua == 0 ||
+        (ua >= 0) != denom_positive || (ua >= 0 ? ua : -ua) >= abs_denom ||
+        (ub >= 0) != denom_positive || (ub >= 0 ? ub : -ub) > abs_denom)
+      continue;
+
+    t = FlatRay::ratio(ua, denom);
+    return i;
+  }
+
+  return last;
+}
+
+unsigned
+SearchPolygon::FindIntersection(unsigned node, unsigned first, unsigned last,
+                                const FlatRay &ray, unsigned start,
+                                fixed &t) const
+{
+  if (last <= start || !tree[node].MayIntersect(ray))
+    return last;
+
+  if (last - first <= LEAF_SIZE)
+    return ScanIntersection(ray, std::max(first, start), last, t);
+
+  const unsigned middle = (first + last) / 2;
+  const unsigned i = FindIntersection(2 * node + 1, first, middle,
+                                      ray, start, t);
+  if (i < middle)
+    return i;
+
+  return FindIntersection(2 * node + 2, middle, last, ray, start, t);
+}
+
+unsigned
+SearchPolygon::NextIntersection(const FlatRay &ray, unsigned start,
+                                fixed &t) const
+{
+  const unsigned n = GetEdgeCount();
+  const unsigned i = flat_x.size() != n + 1
+    ? n
+    : (tree.empty()
+       ? ScanIntersection(ray, start, n, t)
+       : FindIntersection(0, 0, n, ray, start, t));
+
+  if (i >= n)
+    t = -fixed_one;
+  return i;
+}
+
+void
+SearchPolygon::ScanNearest(unsigned first, unsigned last,
+                           const FlatGeoPoint &p,
+                           unsigned &distance_min, FlatGeoPoint &best) const
+{
+  /* same as NearestPoint() in SearchPointVector.cpp, but the products
+     are evaluated in "fixed" and "unsigned" so that they don't overflow
+     for polygons spanning more than ~5000 km (e.g. FIR boundaries) */
+  for (unsigned i = first; i < last; ++i) {
+    const FlatGeoPoint p1(flat_x[i], flat_y[i]);
+    const FlatGeoPoint p12 = FlatGeoPoint(flat_x[i + 1], flat_y[i + 1]) - p1;
+    const FlatGeoPoint p13 = p - p1;
+    const fixed rsq = fixed(p12.Longitude) * p12.Longitude
+      + fixed(p12.Latitude) * p12.Latitude;
+
+    FlatGeoPoint pa = p1;
+    if (positive(rsq)) {
+      const fixed numerator = fixed(p13.Longitude) * p12.Longitude
+        + fixed(p13.Latitude) * p12.Latitude;
+      if (numerator >= rsq)
+        pa = p1 + p12;
+      else if (positive(numerator))
+        pa = p1 + p12 * (numerator / rsq);
+    }
+
+    const unsigned dx = abs(p.Longitude - pa.Longitude);
+    const unsigned dy = abs(p.Latitude - pa.Latitude);
+    const unsigned d = dx * dx + dy * dy;
+    if (d < distance_min) {
+      distance_min = d;
+      best = pa;
+    }
+  }
+}
+
+void
+SearchPolygon::FindNearest(unsigned node, unsigned first, unsigned last,
+                           const FlatGeoPoint &p,
+                           unsigned &distance_min, FlatGeoPoint &best) const
+{
+  /* edges are visited in index order so that ties are resolved like
+     in the linear search */
+  if (tree[node].DistanceSquared(p.Longitude, p.Latitude) >= distance_min)
+    return;
+
+  if (last - first <= LEAF_SIZE) {
+    ScanNearest(first, last, p, distance_min, best);
+    return;
+  }
+
+  const unsigned middle = (first + last) / 2;
+  FindNearest(2 * node + 1, first, middle, p, distance_min, best);
+  FindNearest(2 * node + 2, middle, last, p, distance_min, best);
+}
+
+FlatGeoPoint
+SearchPolygon::NearestPoint(const FlatGeoPoint &p) const
+{
+  const unsigned n = GetEdgeCount();
+  if (flat_x.empty())
+    return p;
+
+  if (n == 0 || flat_x.size() != n + 1)
+    return FlatGeoPoint(flat_x[0], flat_y[0]);
+
+  unsigned distance_min = 0 - 1;
+  FlatGeoPoint best;
+  if (tree.empty())
+    ScanNearest(0, n, p, distance_min, best);
+  else
+    FindNearest(0, 0, n, p, distance_min, best);
+
+  /* the linear search also visits the degenerate closing edge, which
+     contributes the last vertex itself; it can win over the rounded
+     projection onto the first edge */
+  const FlatGeoPoint last(flat_x[n], flat_y[n]);
+  const unsigned dx = abs(p.Longitude - last.Longitude);
+  const unsigned dy = abs(p.Latitude - last.Latitude);
+  if (dx * dx + dy * dy < distance_min)
+    best = last;
+
+  return best;
+}
@@ -0,0 +1,151 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef SEARCHPOLYGON_HPP
+#define SEARCHPOLYGON_HPP
+
+#include "Math/fixed.hpp"
+#include "Compiler.h"
+
+#include <vector>
+
+class SearchPointVector;
+class FlatRay;
+struct GeoPoint;
+struct FlatGeoPoint;
+
+/**
+ * A closed polygon stored as a structure of arrays: one array per
+ * coordinate, geodetic and projected.  This is a read-only copy of a
+ * #SearchPointVector, laid out so that the inner loops of the
+ * point-in-polygon and ray intersection tests only touch the
+ * coordinates they need, without the #SearchPoint objects in between.
+ * The loops are not vectorised: they skip most edges early, and the
+ * ray test needs 64 bit products.
+ *
+ * The kernels use exactly the same arithmetic as PolygonInterior()
+ * and FlatRay::intersects_distinct(), so results are identical.
+ *
+ * Large polygons additionally get a bounding box hierarchy over
+ * their edges, which turns ray and nearest point queries from linear
+ * into (roughly) logarithmic in the number of vertices.
+ */
+class SearchPolygon {
+  /** geodetic coordinates (native #Angle values), n+1 entries */
+  std::vector<fixed> latitude, longitude;
+
+  /** projected coordinates, n+1 entries */
+  std::vector<int> flat_x, flat_y;
+
+  /**
+   * Maximum number of edges in a leaf of the bounding box hierarchy;
+   * polygons with fewer than four leaves worth of edges don't get a
+   * hierarchy at all.
+   */
+  static const unsigned LEAF_SIZE = 16;
+
+  /** Projected bounding box of a range of consecutive edges */
+  struct EdgeBox {
+    int x_min, y_min, x_max, y_max;
+
+    /**
+     * Can the ray cross any edge inside this box?  This is a
+     * conservative test in exact integer arithmetic: it never
+     * rejects a box containing an intersection.
+     */
+    gcc_pure
+    bool MayIntersect(const FlatRay &ray) const;
+
+    /** Lower bound of the squared distance to any point in this box */
+    gcc_pure
+    unsigned DistanceSquared(int x, int y) const;
+  };
+
+  /**
+   * Implicit binary tree (children of node k are 2k+1 and 2k+2),
+   * each node covering a range of consecutive edges which is split
+   * in the middle.  Consecutive edges of a polygon are close to each
+   * other, so no reordering is needed.  Empty for small polygons.
+   */
+  std::vector<EdgeBox> tree;
+
+public:
+  /**
+   * Copy the geodetic locations of a closed polygon (first point
+   * repeated at the end).
+   */
+  void SetLocations(const SearchPointVector &v);
+
+  /**
+   * Copy the projected locations and rebuild the edge hierarchy;
+   * must be called again whenever the #SearchPointVector is
+   * re-projected.
+   */
+  void SetFlatLocations(const SearchPointVector &v);
+
+  /** Number of edges */
+  gcc_pure
+  unsigned GetEdgeCount() const {
+    return latitude.size() > 1 ? latitude.size() - 1 : 0;
+  }
+
+  /** Winding number test on the geodetic coordinates */
+  gcc_pure
+  bool IsInside(const GeoPoint &p) const;
+
+  /**
+   * Find the first edge, starting at index #start, which the ray
+   * crosses distinctly (see FlatRay::intersects_distinct()).
+   *
+   * @param t Set to the ray parameter of the intersection
+   *
+   * @return Index of the edge or GetEdgeCount() if there is none
+   */
+  unsigned NextIntersection(const FlatRay &ray, unsigned start,
+                            fixed &t) const;
+
+  /**
+   * Find the point on the border nearest to the given location; same
+   * result as SearchPointVector::NearestPoint().
+   */
+  gcc_pure
+  FlatGeoPoint NearestPoint(const FlatGeoPoint &p) const;
+
+private:
+  EdgeBox BuildTree(unsigned node, unsigned first, unsigned last);
+
+  unsigned ScanIntersection(const FlatRay &ray, unsigned first, unsigned last,
+                            fixed &t) const;
+
+  unsigned FindIntersection(unsigned node, unsigned first, unsigned last,
+                            const FlatRay &ray, unsigned start,
+                            fixed &t) const;
+
+  void ScanNearest(unsigned first, unsigned last, const FlatGeoPoint &p,
+                   unsigned &distance_min, FlatGeoPoint &best) const;
+
+  void FindNearest(unsigned node, unsigned first, unsigned last,
+                   const FlatGeoPoint &p,
+                   unsigned &distance_min, FlatGeoPoint &best) const;
+};
+
+#endif
@@ -23,6 +23,7 @@
 #include "Route/RoutePolar.hpp"
 #include "Terrain/RasterMap.hpp"
 #include "Geo/GeoBounds.hpp"
+#include "Util/Macros.hpp"
 
 #define REACH_BUFFER 1
 #define REACH_SWEEP (ROUTEPOLAR_Q1-REACH_BUFFER)
@@ -259,17 +260,28 @@ FlatTriangleFanTree::update_terrain_base(const FlatGeoPoint& o, ReachFanParms& p
     parms.terrain_base = 0;
     return;
   }
-  for (VertexVector::const_iterator x= vs.begin(), end= vs.end();
-       x != end; ++x) {
-    const FlatGeoPoint av = (o+(*x))*fixed_half;
-    const GeoPoint p = parms.task_proj.unproject(av);
-    short h = parms.terrain->GetHeight(p);
-    if (RasterBuffer::is_water(h))
-      /* water: assume 0m MSL */
-      parms.terrain_counter++;
-    else if (!RasterBuffer::is_invalid(h)) {
-      parms.terrain_counter++;
-      parms.terrain_base+= h;
+  /* query the terrain in chunks, to keep the buffers on the stack */
+  GeoPoint p[64];
+  short h[64];
+
+  VertexVector::const_iterator x = vs.begin(), end = vs.end();
+  while (x != end) {
+    unsigned n = 0;
+    for (; x != end && n < ARRAY_SIZE(p); ++x, ++n) {
+      const FlatGeoPoint av = (o+(*x))*fixed_half;
+      p[n] = parms.task_proj.unproject(av);
+    }
+
+    parms.terrain->GetHeights(p, h, n);
+
+    for (unsigned i = 0; i < n; ++i) {
+      if (RasterBuffer::is_water(h[i]))
+        /* water: assume 0m MSL */
+        parms.terrain_counter++;
+      else if (!RasterBuffer::is_invalid(h[i])) {
+        parms.terrain_counter++;
+        parms.terrain_base+= h[i];
+      }
     }
   }
   if (parms.terrain_counter)
@@ -344,12 +356,40 @@ FlatTriangleFanTree::check_gap(const AFlatGeoPoint& n,
 void ReachFan::reset() {
   root.clear();
   terrain_base = 0;
+  arrivals.clear();
+}
+
+bool
+ReachFan::is_unchanged(const AGeoPoint &origin, const RoutePolars &rpolars,
+                       const RasterMap *terrain) const
+{
+  if (arrivals.empty() || terrain != solve_terrain ||
+      !(origin == task_proj.get_center()) ||
+      origin.altitude != root.get_height() ||
+      terrain->GetSerial() != solve_terrain_serial ||
+      rpolars.safety_height() != solve_safety_height ||
+      rpolars.turning_reach() != solve_turning)
+    return false;
+
+  /* the polar and the wind are not stored; compare the glide arrival
+     at the root vertices with the one they were built with */
+  const FlatTriangleFan::VertexVector &vs = root.get_vertices();
+  const AFlatGeoPoint ao(vs[0], origin.altitude);
+  for (unsigned i = 0; i < arrivals.size(); ++i)
+    if (rpolars.calc_glide_arrival(ao, vs[i + 1], task_proj) != arrivals[i])
+      return false;
+
+  return true;
 }
 
 bool ReachFan::solve(const AGeoPoint origin,
                      const RoutePolars &rpolars,
                      const RasterMap* terrain,
                      const bool do_solve) {
+  if (do_solve && is_unchanged(origin, rpolars, terrain))
+    // same inputs as the last full solve, the reach is still valid
+    return true;
+
   reset();
 
   // initialise task_proj
@@ -373,6 +413,19 @@ bool ReachFan::solve(const AGeoPoint origin,
 
   if (do_solve) {
     root.fill_reach(ao, parms);
+
+    if (terrain != NULL) {
+      // remember the inputs, so the next solve() may be skipped
+      const FlatTriangleFan::VertexVector &vs = root.get_vertices();
+      arrivals.resize(vs.size() - 1);
+      for (unsigned i = 0; i < arrivals.size(); ++i)
+        arrivals[i] = rpolars.calc_glide_arrival(ao, vs[i + 1], task_proj);
+
+      solve_terrain = terrain;
+      solve_terrain_serial = terrain->GetSerial();
+      solve_safety_height = rpolars.safety_height();
+      solve_turning = rpolars.turning_reach();
+    }
   } else {
     root.dummy_reach(ao);
   }
@@ -70,6 +70,10 @@ public:
   short get_height() const {
     return height;
   }
+
+  const VertexVector &get_vertices() const {
+    return vs;
+  }
 };
 
 class TriangleFanVisitor;
@@ -151,8 +155,19 @@ class ReachFan {
   FlatTriangleFanTree root;
   short terrain_base;
 
+  /**
+   * Glide arrival height at each root vertex (except the origin) of
+   * the last full solve, used to detect changes of the polar or the
+   * wind.  Empty if the last solve can't be reused.
+   */
+  std::vector<short> arrivals;
+  const RasterMap *solve_terrain;
+  unsigned solve_terrain_serial;
+  short solve_safety_height;
+  bool solve_turning;
+
 public:
-  ReachFan():terrain_base(0) {};
+  ReachFan():terrain_base(0), solve_terrain(NULL) {};
 
   friend class PrintHelper;
 
@@ -176,6 +191,14 @@ public:
   short get_terrain_base() const {
     return terrain_base;
   }
+
+private:
+  /**
+   * Were the origin, the terrain and the polar of the last full solve
+   * the same as these?  If so, the reach need not be solved again.
+   */
+  bool is_unchanged(const AGeoPoint &origin, const RoutePolars &rpolars,
+                    const RasterMap *terrain) const;
 };
 
 #endif
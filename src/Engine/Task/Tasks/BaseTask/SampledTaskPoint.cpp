@@ -28,7 +28,8 @@ SampledTaskPoint::SampledTaskPoint(Type _type, const Waypoint & wp,
    boundary_scored(b_scored),
    search_max(GetLocation()),
    search_min(GetLocation()),
-   search_reference(GetLocation())
+   search_reference(GetLocation()),
+   search_serial(0)
 {
   nominal_points.push_back(search_reference);
 }
@@ -52,6 +53,7 @@ SampledTaskPoint::UpdateSampleNear(const AircraftState& state,
   // add sample to polygon
   SearchPoint sp(state.location, projection);
   sampled_points.push_back(sp);
+  InvalidateSearch();
 
   // re-compute convex hull
   bool retval = sampled_points.PruneInterior();
@@ -72,6 +74,7 @@ SampledTaskPoint::ClearSampleAllButLast(const AircraftState& ref_last,
     sampled_points.clear();
     SearchPoint sp(ref_last.location, projection);
     sampled_points.push_back(sp);
+    InvalidateSearch();
   }
 }
 
@@ -111,12 +114,14 @@ SampledTaskPoint::UpdateProjection(const TaskProjection &projection)
   nominal_points.Project(projection);
   sampled_points.Project(projection);
   boundary_points.Project(projection);
+  InvalidateSearch();
 }
 
 void
 SampledTaskPoint::Reset() 
 {
   sampled_points.clear();
+  InvalidateSearch();
 }
 
 const SearchPointVector& 
@@ -63,6 +63,13 @@ private:
   SearchPoint search_min;
   SearchPoint search_reference;
 
+  /**
+   * Incremented whenever one of the search point vectors is
+   * modified, allows solvers to detect which stages need to be
+   * searched again.
+   */
+  unsigned search_serial;
+
 public:
   /**
    * Constructor.  Clears boundary and interior samples on instantiation.
@@ -161,6 +168,14 @@ public:
     return boundary_scored;
   }
 
+  /**
+   * Returns a number which changes whenever the search points or
+   * the state they depend on are modified.
+   */
+  unsigned GetSearchSerial() const {
+    return search_serial;
+  }
+
 protected:
   /**
    * Clear all sample points and add the current state as a sample.
@@ -177,6 +192,14 @@ protected:
    */
   void SetSearchMin(const GeoPoint &location, const TaskProjection &projection);
 
+  /**
+   * Mark the search points as modified.  To be called by subclasses
+   * when state which affects the search results changes.
+   */
+  void InvalidateSearch() {
+    ++search_serial;
+  }
+
   /**
    * Retrieve boundary points polygon
    */
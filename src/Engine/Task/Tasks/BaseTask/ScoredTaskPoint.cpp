@@ -56,6 +56,8 @@ ScoredTaskPoint::TransitionExit(const AircraftState &ref_now,
     state_exited = ref_last;
   }
 
+  // the exit state decides whether the search result is saved
+  InvalidateSearch();
   return true;
 }
 
@@ -82,6 +82,10 @@ UpdateObservationZones(OrderedTask::OrderedTaskPointVector &points,
 void
 OrderedTask::update_geometry() 
 {
+  // task points may have been added, removed or replaced
+  dijkstra_min.Invalidate();
+  dijkstra_max.Invalidate();
+
   scan_start_finish();
 
   if (!has_start() || !task_points[0])
@@ -861,7 +865,7 @@ OrderedTask::OrderedTask(TaskEvents &te,
   active_factory(NULL),
   m_ordered_behaviour(tb.ordered_defaults),
   task_advance(m_ordered_behaviour),
-  dijkstra_min(*this, do_reserve),
+  dijkstra_min(*this),
   dijkstra_max(*this, do_reserve)
 {
   active_factory = new RTTaskFactory(*this, task_behaviour);
@@ -982,6 +986,12 @@ OrderedTask::get_tp_search_points(unsigned tp) const
   return task_points[tp]->GetSearchPoints();
 }
 
+unsigned
+OrderedTask::get_tp_search_serial(unsigned tp) const
+{
+  return task_points[tp]->GetSearchSerial();
+}
+
 void 
 OrderedTask::set_tp_search_min(unsigned tp, const SearchPoint &sol) 
 {
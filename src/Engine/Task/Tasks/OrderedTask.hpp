@@ -489,6 +489,17 @@ protected:
    */
   const SearchPointVector& get_tp_search_points(unsigned tp) const;
 
+  /**
+   * Retrieve the serial of a task point's search points, which
+   * changes whenever they are modified.
+   *
+   * @param tp Index of task point of query
+   *
+   * @return Search serial of the task point
+   */
+  gcc_pure
+  unsigned get_tp_search_serial(unsigned tp) const;
+
   /**
    * Set task point's minimum distance value (by TaskDijkstra).
    *
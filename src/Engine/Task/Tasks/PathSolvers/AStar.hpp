@@ -25,6 +25,7 @@ Copyright_License {
 #define ASTAR_HPP
 
 #include "Util/queue.hpp"
+#include "Util/PerfCounters.hpp"
 #include <assert.h>
 #include "Compiler.h"
 
@@ -36,10 +37,6 @@ Copyright_License {
 #include <map>
 #endif
 
-#ifdef INSTRUMENT_TASK
-extern long count_astar_links;
-#endif
-
 #define ASTAR_MINMAX_OFFSET 134217727
 
 #define ASTAR_QUEUE_SIZE 1024
@@ -220,9 +217,7 @@ public:
    * @param e Edge distance
    */
   void link(const Node &node, const Node &parent, const AStarPriorityValue &edge_value) {
-#ifdef INSTRUMENT_TASK
-    count_astar_links++;
-#endif
+    PerfCounters::Increment(PerfCounters::COUNT_ASTAR_LINKS);
     push(node, parent, get_node_value(parent) + edge_value.adjust(m_min));
     // note order of + here is important!
   }
@@ -24,16 +24,12 @@ Copyright_License {
 #ifndef DIJKSTRA_HPP
 #define DIJKSTRA_HPP
 
-#include "Util/SliceAllocator.hpp"
-
-#include <map>
-#include "Util/queue.hpp"
-#include <assert.h>
+#include "ScanTaskPoint.hpp"
+#include "Util/PerfCounters.hpp"
 #include "Compiler.h"
 
-#ifdef INSTRUMENT_TASK
-extern long count_dijkstra_links;
-#endif
+#include <vector>
+#include <assert.h>
 
 #define DIJKSTRA_MINMAX_OFFSET 134217727
 
@@ -43,49 +39,56 @@ extern long count_dijkstra_links;
  * Dijkstra search algorithm.
  * Modifications by John Wharington to track optimal solution
  * @see http://en.giswiki.net/wiki/Dijkstra%27s_algorithm
+ *
+ * The nodes are stages of a task or a contest, each with a number of
+ * points, which allows storing the state of each node in a flat
+ * array instead of a lookup tree.  The queue is a 4-ary heap of node
+ * indices; each node knows its position in the heap, so a cheaper
+ * path updates the existing entry instead of adding another one.
  */
-template <class Node> class Dijkstra {
+class Dijkstra {
   struct Edge {
-    Node parent;
+    /**
+     * The search which has initialised this object.  Objects from
+     * an older search are treated as unvisited.
+     */
+    unsigned generation;
 
     unsigned value;
 
-    Edge(Node _parent, unsigned _value):parent(_parent), value(_value) {}
-  };
-
-  typedef std::map<Node, Edge, std::less<Node>,
-                   GlobalSliceAllocator<std::pair<Node, unsigned>, 256u> > edge_map;
-  typedef typename edge_map::iterator edge_iterator;
-  typedef typename edge_map::const_iterator edge_const_iterator;
-
-  struct Value {
-    unsigned edge_value;
+    /**
+     * The position in #heap, or #NOT_QUEUED if this node is not in
+     * the queue.
+     */
+    unsigned position;
 
-    edge_iterator iterator;
+    ScanTaskPoint parent;
 
-    Value(unsigned _edge_value, edge_iterator _iterator)
-      :edge_value(_edge_value), iterator(_iterator) {}
+    Edge():generation(0), parent(0, 0) {}
   };
 
-  struct Rank : public std::binary_function<Value, Value, bool> {
-    gcc_pure
-    bool operator()(const Value& x, const Value& y) const {
-      return x.edge_value > y.edge_value;
-    }
-  };
+  static const unsigned NOT_QUEUED = 0 - 1;
 
   /**
-   * Stores the predecessor and value of each node.  It is updated by
-   * push(), if a value lower than the current one is found.
+   * Stores the predecessor and value of each node, indexed by
+   * get_index().  It is updated by push(), if a value lower than the
+   * current one is found.
    */
-  edge_map edges;
+  std::vector<Edge> edges;
 
   /**
-   * A sorted list of all possible node paths, lowest distance first.
+   * The queue of nodes to be processed, lowest value first.
    */
-  reservable_priority_queue<Value, std::vector<Value>, Rank> q;
+  std::vector<unsigned> heap;
 
-  edge_iterator cur;
+  /**
+   * The number of points in each stage of the current search.
+   */
+  unsigned width;
+
+  unsigned generation;
+
+  unsigned cur;
   const bool m_min;
 
 public:
@@ -95,19 +98,7 @@ public:
    * @param is_min Whether this algorithm will search for min or max distance
    */
   Dijkstra(const bool is_min = true, unsigned reserve_default=DIJKSTRA_QUEUE_SIZE) :
-    m_min(is_min) {
-    reserve(reserve_default);
-  }
-
-  /**
-   * Constructor
-   *
-   * @param n Node to start
-   * @param is_min Whether this algorithm will search for min or max distance
-   */
-  Dijkstra(const Node &node, const bool is_min = true, unsigned reserve_default=DIJKSTRA_QUEUE_SIZE) :
-    m_min(is_min) { 
-    push(node, node, 0);
+    width(0), generation(1), m_min(is_min) {
     reserve(reserve_default);
   }
 
@@ -115,9 +106,20 @@ public:
    * Resets as if constructed afresh
    *
    * @param n Node to start
+   * @param num_stages The number of stages in this search
+   * @param _width The maximum number of points in each stage
    */
-  void restart(const Node &node) {
+  void restart(const ScanTaskPoint &node, unsigned num_stages,
+               unsigned _width) {
+    assert(node.stage_number < num_stages);
+    assert(node.point_index < _width);
+
     clear();
+
+    width = _width;
+    if (edges.size() < num_stages * width)
+      edges.resize(num_stages * width);
+
     push(node, node, 0);
   }
 
@@ -125,12 +127,15 @@ public:
    * Clears the queues
    */
   void clear() {
-    // Clear the search queue
-    while (!q.empty())
-      q.pop();
-
-    // Clear edge_map
-    edges.clear();
+    heap.clear();
+
+    if (++generation == 0) {
+      /* wraparound: forget all old values the hard way */
+      for (std::vector<Edge>::iterator i = edges.begin(), end = edges.end();
+           i != end; ++i)
+        i->generation = 0;
+      generation = 1;
+    }
   }
 
   /**
@@ -140,7 +145,7 @@ public:
    */
   gcc_pure
   bool empty() const {
-    return q.empty();
+    return heap.empty();
   }
 
   /**
@@ -150,22 +155,26 @@ public:
    */
   gcc_pure
   unsigned queue_size() const {
-    return q.size();
+    return heap.size();
   }
 
   /**
-   * Return top element of queue for processing
+   * Remove the top element of queue for processing
    *
    * @return Node for processing
    */
-  const Node &pop() {
-    cur = q.top().iterator;
+  ScanTaskPoint pop() {
+    assert(!heap.empty());
 
-    do
-      q.pop();
-    while (!q.empty() && q.top().iterator->second.value < q.top().edge_value);
+    cur = heap.front();
+    edges[cur].position = NOT_QUEUED;
 
-    return cur->first;
+    const unsigned last = heap.back();
+    heap.pop_back();
+    if (!heap.empty())
+      sift_down(0, last);
+
+    return get_node(cur);
   }
 
   /**
@@ -175,11 +184,10 @@ public:
    * @param pn Predecessor of destination node
    * @param e Edge distance
    */
-  void link(const Node &node, const Node &parent, unsigned edge_value) {
-#ifdef INSTRUMENT_TASK
-    count_dijkstra_links++;
-#endif
-    push(node, parent, cur->second.value + adjust_edge_value(edge_value)); 
+  void link(const ScanTaskPoint &node, const ScanTaskPoint &parent,
+            unsigned edge_value) {
+    PerfCounters::Increment(PerfCounters::COUNT_DIJKSTRA_LINKS);
+    push(node, parent, edges[cur].value + adjust_edge_value(edge_value));
   }
 
   /**
@@ -190,25 +198,23 @@ public:
    * @return Predecessor node
    */
   gcc_pure
-  Node get_predecessor(const Node &node) const {
-    // Try to find the given node in the node_parent_map
-    edge_const_iterator it = edges.find(node);
-    if (it == edges.end())
-      // first entry
+  ScanTaskPoint get_predecessor(const ScanTaskPoint &node) const {
+    const unsigned index = get_index(node);
+    if (index >= edges.size() || edges[index].generation != generation)
       // If the node wasn't found
       // -> Return the given node itself
       return node;
     else
       // If the node was found
       // -> Return the parent node
-      return it->second.parent;
+      return edges[index].parent;
   }
 
   /**
    * Reserve queue size (if available)
    */
   void reserve(unsigned size) {
-    q.reserve(size);
+    heap.reserve(size);
   }
 
 private:
@@ -221,6 +227,75 @@ private:
     return m_min ? edge_value : DIJKSTRA_MINMAX_OFFSET - edge_value;
   }
 
+  gcc_pure
+  unsigned get_index(const ScanTaskPoint &node) const {
+    assert(node.point_index < width);
+
+    return node.stage_number * width + node.point_index;
+  }
+
+  gcc_pure
+  ScanTaskPoint get_node(unsigned index) const {
+    return ScanTaskPoint(index / width, index % width);
+  }
+
+  /**
+   * Move the node #index up from the hole at #position to its place
+   * in the heap.
+   */
+  void sift_up(unsigned position, unsigned index) {
+    const unsigned value = edges[index].value;
+    while (position > 0) {
+      const unsigned parent = (position - 1) / 4;
+      const unsigned parent_index = heap[parent];
+      if (edges[parent_index].value <= value)
+        break;
+
+      heap[position] = parent_index;
+      edges[parent_index].position = position;
+      position = parent;
+    }
+
+    heap[position] = index;
+    edges[index].position = position;
+  }
+
+  /**
+   * Move the node #index down from the hole at #position to its
+   * place in the heap.
+   */
+  void sift_down(unsigned position, unsigned index) {
+    const unsigned value = edges[index].value;
+    const unsigned size = heap.size();
+    while (true) {
+      const unsigned first = 4 * position + 1;
+      if (first >= size)
+        break;
+
+      const unsigned end = first + 4 < size ? first + 4 : size;
+      unsigned best = first;
+      unsigned best_value = edges[heap[first]].value;
+      for (unsigned child = first + 1; child < end; ++child) {
+        const unsigned child_value = edges[heap[child]].value;
+        if (child_value < best_value) {
+          best = child;
+          best_value = child_value;
+        }
+      }
+
+      if (best_value >= value)
+        break;
+
+      const unsigned best_index = heap[best];
+      heap[position] = best_index;
+      edges[best_index].position = position;
+      position = best;
+    }
+
+    heap[position] = index;
+    edges[index].position = position;
+  }
+
   /**
    * Add node to search queue
    *
@@ -228,25 +303,32 @@ private:
    * @param pn Previous node
    * @param e Edge distance (previous to this)
    */
-  void push(const Node &node, const Node &parent, unsigned edge_value=0) {
-    // Try to find the given node n in the edge_map
-    edge_iterator it = edges.find(node);
-    if (it == edges.end()) {
+  void push(const ScanTaskPoint &node, const ScanTaskPoint &parent,
+            unsigned edge_value=0) {
+    const unsigned index = get_index(node);
+    assert(index < edges.size());
+
+    Edge &edge = edges[index];
+    if (edge.generation != generation) {
       // first entry
       // If the node wasn't found
       // -> Insert a new node
-      it = edges.insert(std::make_pair(node, Edge(parent,
-                                                        edge_value))).first;
-    } else if (it->second.value > edge_value) {
-      // If the node was found and the new value is smaller
-      // -> Replace the value with the new one
-      it->second = Edge(parent, edge_value);
-    } else
+      edge.generation = generation;
+      edge.position = NOT_QUEUED;
+    } else if (edge.value <= edge_value)
       // If the node was found but the new value is higher or equal
       // -> Don't use this new leg
       return;
 
-    q.push(Value(edge_value, it));
+    // -> Replace the value with the new one
+    edge.value = edge_value;
+    edge.parent = parent;
+
+    if (edge.position == NOT_QUEUED) {
+      heap.push_back(index);
+      sift_up(heap.size() - 1, index);
+    } else
+      sift_up(edge.position, index);
   }
 };
 
@@ -27,15 +27,12 @@ Copyright_License {
 #include "Util/NonCopyable.hpp"
 #include "Dijkstra.hpp"
 #include "ScanTaskPoint.hpp"
+#include "Util/PerfCounters.hpp"
 #include "Compiler.h"
 
 #include <algorithm>
 #include <assert.h>
 
-#ifdef INSTRUMENT_TASK
-extern long count_dijkstra_queries;
-#endif
-
 /**
  * Abstract class for A* /Dijkstra searches of nav points, managing
  * edges in multiple stages (corresponding to turn points).
@@ -53,7 +50,7 @@ protected:
     MAX_STAGES = 16,
   };
 
-  Dijkstra<ScanTaskPoint> dijkstra;
+  Dijkstra dijkstra;
 
   /** Number of stages in search */
   unsigned num_stages;
@@ -167,9 +164,7 @@ protected:
    * @return True if algorithm returns a terminal path or no path found
    */
   bool distance_general(unsigned max_steps = 0 - 1) {
-#ifdef INSTRUMENT_TASK
-    count_dijkstra_queries++;
-#endif
+    PerfCounters::Increment(PerfCounters::COUNT_DIJKSTRA_QUERIES);
 
     while (!dijkstra.empty()) {
       const ScanTaskPoint destination = dijkstra.pop();
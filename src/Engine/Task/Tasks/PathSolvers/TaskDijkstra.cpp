@@ -25,45 +25,72 @@
 
 TaskDijkstra::TaskDijkstra(OrderedTask& _task, bool is_min, const bool do_reserve):
   NavDijkstra<SearchPoint> (is_min, 0, do_reserve? DIJKSTRA_QUEUE_SIZE: 0),
-  task(_task)
+  task(_task),
+  active_stage(0),
+  dirty_end(0),
+  active_changed(false),
+  stages_valid(false)
 {
+  std::fill(stage_points, stage_points + MAX_STAGES,
+            (const SearchPointVector *)NULL);
+  std::fill(stage_serials, stage_serials + MAX_STAGES, 0u);
 }
 
 bool
 TaskDijkstra::refresh_task()
 {
+  const unsigned old_num_stages = num_stages;
+  const unsigned old_active_stage = active_stage;
+
   set_stages(task.TaskSize());
-  if (num_stages < 2)
+  if (num_stages < 2) {
+    stages_valid = false;
     return false;
+  }
 
   active_stage = task.getActiveTaskPointIndex();
   calculate_sizes();
+
+  if (!stages_valid || num_stages != old_num_stages) {
+    dirty_end = num_stages;
+    active_changed = true;
+    stages_valid = true;
+  } else
+    active_changed = active_stage != old_active_stage;
+
   return true;
 }
 
 void
 TaskDijkstra::calculate_sizes()
 {
-  for (unsigned stage = 0; stage != num_stages; ++stage)
-    sp_sizes[stage] = task.get_tp_search_points(stage).size();
-}
-
-unsigned
-TaskDijkstra::get_size(const unsigned stage) const
-{
-  return sp_sizes[stage];
+  max_size = 1;
+  dirty_end = 0;
+  for (unsigned stage = 0; stage != num_stages; ++stage) {
+    const SearchPointVector &points = task.get_tp_search_points(stage);
+    const unsigned serial = task.get_tp_search_serial(stage);
+    if (&points != stage_points[stage] || serial != stage_serials[stage]) {
+      stage_points[stage] = &points;
+      stage_serials[stage] = serial;
+      dirty_end = stage + 1;
+    }
+
+    sp_sizes[stage] = points.size();
+    if (sp_sizes[stage] > max_size)
+      max_size = sp_sizes[stage];
+  }
 }
 
 const SearchPoint &
 TaskDijkstra::GetPointFast(const ScanTaskPoint &sp) const
 {
-  return task.get_tp_search_points(sp.stage_number)[sp.point_index];
+  return (*stage_points[sp.stage_number])[sp.point_index];
 }
 
 const SearchPoint &
 TaskDijkstra::get_point(const ScanTaskPoint &sp) const
 {
-  return task.get_tp_search_points(sp.stage_number)[sp.point_index];
+  return (*stage_points[sp.stage_number])[sp.point_index];
 }
 
 void
@@ -76,20 +103,6 @@ TaskDijkstra::add_edges(const ScanTaskPoint& curNode)
     dijkstra.link(destination, curNode, distance(curNode, destination));
 }
 
-void 
-TaskDijkstra::add_start_edges(const SearchPoint &currentLocation)
-{
-  // need to remove dummy first point
-  dijkstra.pop();
-
-  ScanTaskPoint destination(active_stage, 0);
-  const unsigned dsize = get_size(destination.stage_number);
-
-  for (; destination.point_index != dsize; ++destination.point_index)
-    dijkstra.link(destination, destination,
-                  distance(destination, currentLocation));
-}
-
 bool
 TaskDijkstra::run()
 {
@@ -25,6 +25,7 @@
 
 #include "NavDijkstra.hpp"
 #include "Navigation/SearchPoint.hpp"
+#include "Navigation/SearchPointVector.hpp"
 
 class OrderedTask;
 
@@ -52,9 +53,40 @@ protected:
   OrderedTask &task;
   unsigned active_stage;
 
+  /**
+   * One past the highest stage whose search points have changed
+   * since the previous refresh_task() call; zero if none has
+   * changed.
+   */
+  unsigned dirty_end;
+
+  /**
+   * Has the active stage changed since the previous refresh_task()
+   * call?
+   */
+  bool active_changed;
+
 private:
   unsigned sp_sizes[MAX_STAGES];
 
+  /** The largest value in #sp_sizes, but at least 1 */
+  unsigned max_size;
+
+  /**
+   * The search points of each stage, as seen by the previous
+   * refresh_task() call.
+   */
+  const SearchPointVector *stage_points[MAX_STAGES];
+
+  /**
+   * The search serial of each stage, as seen by the previous
+   * refresh_task() call.
+   */
+  unsigned stage_serials[MAX_STAGES];
+
+  /** Are #stage_points and #stage_serials up to date? */
+  bool stages_valid;
+
 public:
   /**
    * Constructor
@@ -66,6 +98,15 @@ public:
   TaskDijkstra(OrderedTask& _task, const bool is_min,
                const bool do_reserve=false);
 
+  /**
+   * Discard all cached state, so the next search starts from
+   * scratch.  Must be called after task points have been added,
+   * removed or replaced.
+   */
+  void Invalidate() {
+    stages_valid = false;
+  }
+
 protected:
   gcc_pure
   const SearchPoint &GetPointFast(const ScanTaskPoint &sp) const;
@@ -79,7 +120,17 @@ protected:
    */
   bool refresh_task();
 
-  void add_start_edges(const SearchPoint &loc);
+  /**
+   * Start a new search
+   */
+  void restart(const ScanTaskPoint &start) {
+    dijkstra.restart(start, num_stages, max_size);
+  }
+
+  gcc_pure
+  unsigned get_size(const unsigned stage) const {
+    return sp_sizes[stage];
+  }
 
   /** 
    * Distance function for free point
@@ -110,7 +161,6 @@ protected:
 
 private:
   void calculate_sizes();
-  unsigned get_size(const unsigned stage) const;
 
   void add_edges(const ScanTaskPoint &curNode);
 };
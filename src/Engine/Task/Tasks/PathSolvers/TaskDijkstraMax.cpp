@@ -24,19 +24,27 @@
 #include "Task/Tasks/OrderedTask.hpp"
 
 TaskDijkstraMax::TaskDijkstraMax(OrderedTask& _task, const bool do_reserve) :
-  TaskDijkstra(_task, false, do_reserve)
+  TaskDijkstra(_task, false, do_reserve),
+  saved(false)
 {
 }
 
 bool
 TaskDijkstraMax::distance_max()
 {
-  if (!refresh_task())
+  if (!refresh_task()) {
+    saved = false;
     return false;
+  }
+
+  if (saved && dirty_end == 0 && !active_changed)
+    /* the previous solution is still stored in the task points */
+    return true;
 
   const ScanTaskPoint start(0, 0);
-  dijkstra.restart(start);
-  return run();
+  restart(start);
+  saved = run();
+  return saved;
 }
 
 
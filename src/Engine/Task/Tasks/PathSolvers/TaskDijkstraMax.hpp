@@ -31,6 +31,13 @@
 class TaskDijkstraMax: 
   public TaskDijkstra
 {
+  /**
+   * Has the previous search been saved in the task points?  If so,
+   * and neither the search points nor the active stage have changed
+   * since, the search is skipped.
+   */
+  bool saved;
+
 public:
   TaskDijkstraMax(OrderedTask& _task, const bool do_reserve=false);
 
@@ -40,6 +47,9 @@ public:
    * in the corresponding task points for later accurate distance
    * measurement.
    *
+   * This is a no-op if nothing has changed since the previous
+   * search.
+   *
    * @return True if succeeded
    */
   bool distance_max();
@@ -22,26 +22,104 @@
 
 #include "TaskDijkstraMin.hpp"
 #include "Task/Tasks/OrderedTask.hpp"
+#include "Util/PerfCounters.hpp"
 
-TaskDijkstraMin::TaskDijkstraMin(OrderedTask& _task, const bool do_reserve) :
-  TaskDijkstra(_task, true, do_reserve)
+#include <limits.h>
+
+TaskDijkstraMin::TaskDijkstraMin(OrderedTask& _task) :
+  TaskDijkstra(_task, true),
+  valid_from(MAX_STAGES)
 {
 }
 
+void
+TaskDijkstraMin::UpdateStage(const unsigned stage)
+{
+  PerfCounters::Increment(PerfCounters::COUNT_TASK_STAGES);
+
+  const unsigned size = get_size(stage);
+  Stage &s = stages[stage];
+  s.cost.resize(size);
+  s.next.resize(size);
+
+  if (is_final(ScanTaskPoint(stage, 0))) {
+    std::fill(s.cost.begin(), s.cost.end(), 0u);
+    std::fill(s.next.begin(), s.next.end(), 0u);
+    return;
+  }
+
+  const Stage &n = stages[stage + 1];
+  const unsigned next_size = get_size(stage + 1);
+
+  for (ScanTaskPoint origin(stage, 0); origin.point_index != size;
+       ++origin.point_index) {
+    unsigned best_cost = UINT_MAX, best = 0;
+
+    for (ScanTaskPoint destination(stage + 1, 0);
+         destination.point_index != next_size; ++destination.point_index) {
+      const unsigned cost = distance(origin, destination) +
+        n.cost[destination.point_index];
+      /* on a tie, prefer the shorter leg, which is the one Dijkstra's
+         algorithm would have settled first */
+      if (cost < best_cost ||
+          (cost == best_cost &&
+           n.cost[destination.point_index] > n.cost[best])) {
+        best_cost = cost;
+        best = destination.point_index;
+      }
+    }
+
+    s.cost[origin.point_index] = best_cost;
+    s.next[origin.point_index] = best;
+  }
+}
+
 bool
 TaskDijkstraMin::distance_min(const SearchPoint &currentLocation)
 {
   if (!refresh_task())
     return false;
 
-  const ScanTaskPoint start(max(1, (int)active_stage) - 1, 0);
+  for (unsigned stage = active_stage; stage != num_stages; ++stage)
+    if (get_size(stage) == 0)
+      return false;
 
-  dijkstra.restart(start);
-  if (active_stage)
-    add_start_edges(currentLocation);
-  return run();
-}
+  /* the cached distances of a stage depend on the search points of
+     all subsequent stages */
+  if (valid_from < dirty_end)
+    valid_from = dirty_end;
+  if (valid_from > num_stages)
+    valid_from = num_stages;
+
+  for (; valid_from > active_stage; --valid_from)
+    UpdateStage(valid_from - 1);
 
+  unsigned index = 0;
+  if (active_stage) {
+    /* pick the active stage's search point with the shortest
+       distance via the aircraft location */
+    unsigned best_cost = UINT_MAX;
+    const Stage &a = stages[active_stage];
+    for (ScanTaskPoint sp(active_stage, 0);
+         sp.point_index != get_size(active_stage); ++sp.point_index) {
+      const unsigned cost = distance(sp, currentLocation) +
+        a.cost[sp.point_index];
+      if (cost < best_cost ||
+          (cost == best_cost && a.cost[sp.point_index] > a.cost[index])) {
+        best_cost = cost;
+        index = sp.point_index;
+      }
+    }
+  }
+
+  for (unsigned stage = active_stage; stage != num_stages; ++stage) {
+    solution[stage] = get_point(ScanTaskPoint(stage, index));
+    index = stages[stage].next[index];
+  }
+
+  save();
+  return true;
+}
 
 void
 TaskDijkstraMin::save()
@@ -49,4 +127,3 @@ TaskDijkstraMin::save()
   for (unsigned j = active_stage; j != num_stages; ++j)
     task.set_tp_search_min(j, solution[j]);
 }
-
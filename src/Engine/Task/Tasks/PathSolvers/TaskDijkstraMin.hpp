@@ -25,14 +25,37 @@
 
 #include "TaskDijkstra.hpp"
 
+#include <vector>
+
 /**
- * Specialisation of TaskDijkstra for minimum distance search
+ * Specialisation of TaskDijkstra for minimum distance search.
+ *
+ * Unlike the maximum search, the stages are not searched with
+ * Dijkstra's algorithm.  Since the aircraft location only affects
+ * the edges into the active stage, the minimum distance from each
+ * search point to the finish is cached per stage, and only stages
+ * whose search points (or those of a later stage) have changed are
+ * evaluated again.  During an AAT, this is usually just the active
+ * stage.
  */
 class TaskDijkstraMin: 
   public TaskDijkstra
 {
+  struct Stage {
+    /** Minimum distance from each search point to the finish */
+    std::vector<unsigned> cost;
+
+    /** Index of the next stage's search point on that path */
+    std::vector<unsigned> next;
+  };
+
+  Stage stages[MAX_STAGES];
+
+  /** All stages from this one on have an up-to-date #Stage */
+  unsigned valid_from;
+
 public:
-  TaskDijkstraMin(OrderedTask& _task, const bool do_reserve=false);
+  TaskDijkstraMin(OrderedTask& _task);
 
   /**
    * Search task points for targets within OZs to produce the
@@ -50,6 +73,11 @@ public:
   bool distance_min(const SearchPoint& location);
 
 private:
+  /**
+   * Calculate the #Stage of a stage from the one following it.
+   */
+  void UpdateStage(unsigned stage);
+
   virtual void save();
 };
 
@@ -27,7 +27,9 @@ Copyright_License {
 
 Trace::Trace(const unsigned _no_thin_time, const unsigned max_time,
              const unsigned max_points)
-  :chronological_list(ListHead::empty()),
+  :pool(NULL), delta_heap(NULL), heap_size(0),
+   chronological_list(ListHead::empty()),
+   free_list(ListHead::empty()),
    cached_size(0),
    m_max_time(max_time),
    no_thin_time(_no_thin_time),
@@ -35,25 +37,180 @@ Trace::Trace(const unsigned _no_thin_time, const unsigned max_time,
    m_opt_points((3*max_points)/4)
 {
   assert(max_points >= 4);
+
+  allocate_pool();
+}
+
+Trace::~Trace()
+{
+  delete[] delta_heap;
+  delete[] pool;
+}
+
+void
+Trace::allocate_pool()
+{
+  assert(chronological_list.IsEmpty());
+
+  delete[] delta_heap;
+  delete[] pool;
+
+  pool = new TraceDelta[m_max_points];
+  delta_heap = new TraceDelta *[m_max_points];
+  heap_size = 0;
+
+  free_list.Clear();
+  for (unsigned i = 0; i < m_max_points; ++i)
+    pool[i].InsertBefore(free_list);
 }
 
 void
 Trace::clear()
 {
-  assert(cached_size == delta_list.size());
+  assert(cached_size == heap_size);
   assert(cached_size == chronological_list.Count());
 
   m_average_delta_distance = 0;
   m_average_delta_time = 0;
 
-  delta_list.clear();
-  chronological_list.Clear();
+  while (!chronological_list.IsEmpty())
+    chronological_list.GetNext()->MoveAfter(free_list);
+
+  heap_size = 0;
   cached_size = 0;
 
-  assert(cached_size == delta_list.size());
+  assert(cached_size == heap_size);
   assert(cached_size == chronological_list.Count());
 }
 
+void
+Trace::CopyFrom(const Trace &other)
+{
+  assert(&other != this);
+  assert(other.cached_size == other.heap_size);
+  assert(other.cached_size == other.chronological_list.Count());
+
+  clear();
+
+  task_projection = other.task_projection;
+  m_max_time = other.m_max_time;
+  no_thin_time = other.no_thin_time;
+  m_opt_points = other.m_opt_points;
+  m_average_delta_time = other.m_average_delta_time;
+  m_average_delta_distance = other.m_average_delta_distance;
+
+  if (m_max_points != other.m_max_points) {
+    m_max_points = other.m_max_points;
+    allocate_pool();
+  }
+
+  /* the deltas only depend on the neighbours, which are the same in
+     the copy, so they can be copied as-is */
+  const ChronologicalConstIterator end = other.chronological_list.end();
+  for (ChronologicalConstIterator it = other.chronological_list.begin();
+       it != end; ++it) {
+    TraceDelta &td = insert(it->point);
+    td.elim_time = it->elim_time;
+    td.elim_distance = it->elim_distance;
+    td.delta_distance = it->delta_distance;
+    heap_update(td);
+  }
+
+  assert(cached_size == heap_size);
+  assert(cached_size == chronological_list.Count());
+}
+
+void
+Trace::heap_set(unsigned i, TraceDelta &td)
+{
+  assert(i < heap_size);
+
+  delta_heap[i] = &td;
+  td.heap_index = i;
+}
+
+void
+Trace::sift_up(unsigned i)
+{
+  assert(i < heap_size);
+
+  TraceDelta &td = *delta_heap[i];
+  while (i > 0) {
+    const unsigned parent = (i - 1) / 2;
+    if (!TraceDelta::DeltaRank(td, *delta_heap[parent]))
+      break;
+
+    heap_set(i, *delta_heap[parent]);
+    i = parent;
+  }
+
+  heap_set(i, td);
+}
+
+void
+Trace::sift_down(unsigned i)
+{
+  assert(i < heap_size);
+
+  TraceDelta &td = *delta_heap[i];
+  while (true) {
+    unsigned child = 2 * i + 1;
+    if (child >= heap_size)
+      break;
+
+    if (child + 1 < heap_size &&
+        TraceDelta::DeltaRank(*delta_heap[child + 1], *delta_heap[child]))
+      ++child;
+
+    if (!TraceDelta::DeltaRank(*delta_heap[child], td))
+      break;
+
+    heap_set(i, *delta_heap[child]);
+    i = child;
+  }
+
+  heap_set(i, td);
+}
+
+void
+Trace::heap_push(TraceDelta &td)
+{
+  assert(heap_size < m_max_points);
+
+  heap_set(heap_size++, td);
+  sift_up(td.heap_index);
+}
+
+void
+Trace::heap_remove(TraceDelta &td)
+{
+  assert(td.heap_index < heap_size);
+  assert(delta_heap[td.heap_index] == &td);
+
+  const unsigned i = td.heap_index;
+  td.heap_index = null_index;
+
+  --heap_size;
+  if (i == heap_size)
+    return;
+
+  /* move the last item into the gap, and restore the heap property
+     in whichever direction is necessary */
+  heap_set(i, *delta_heap[heap_size]);
+  heap_update(*delta_heap[i]);
+}
+
+void
+Trace::heap_update(TraceDelta &td)
+{
+  assert(td.heap_index < heap_size);
+
+  const unsigned i = td.heap_index;
+  sift_up(i);
+  if (td.heap_index == i)
+    sift_down(i);
+}
+
 unsigned
 Trace::get_recent_time(const unsigned t) const
 {
@@ -70,48 +227,31 @@ Trace::get_recent_time(const unsigned t) const
 void
 Trace::update_delta(TraceDelta &td)
 {
-  assert(cached_size == delta_list.size());
   assert(cached_size == chronological_list.Count());
 
   if (chronological_list.IsEdge(td))
     return;
 
-  const TraceDelta &previous = td.GetPrevious();
-  const TraceDelta &next = td.GetNext();
+  td.update(td.GetPrevious().point, td.GetNext().point);
 
-  TraceDelta temp_td = td;
-  temp_td.SetDisconnected();
-
-  td.Replace(temp_td);
-
-  // erase old one
-  delta_list.erase(td.delta_list_iterator);
-
-  // insert new in sorted position
-  temp_td.update(previous.point, next.point);
-  TraceDelta &new_td = insert(temp_td);
-  new_td.SetDisconnected();
-  temp_td.Replace(new_td);
+  /* items which are protected by erase_delta() are temporarily not
+     in the heap */
+  if (td.heap_index != null_index)
+    heap_update(td);
 }
 
 void
-Trace::erase_inside(TraceDelta::iterator it)
+Trace::erase_inside(TraceDelta &td)
 {
   assert(cached_size > 0);
-  assert(cached_size == delta_list.size());
   assert(cached_size == chronological_list.Count());
-  assert(it != delta_list.end());
-
-  const TraceDelta &td = *it;
   assert(!td.IsEdge());
 
-  TraceDelta &previous = const_cast<TraceDelta &>(td.GetPrevious());
-  TraceDelta &next = const_cast<TraceDelta &>(td.GetNext());
+  TraceDelta &previous = td.GetPrevious();
+  TraceDelta &next = td.GetNext();
 
   // now delete the item
-  td.RemoveConst();
-  delta_list.erase(it);
-  --cached_size;
+  dispose(td);
 
   // and update the deltas
   update_delta(previous);
@@ -121,7 +261,7 @@ Trace::erase_inside(TraceDelta::iterator it)
 bool
 Trace::erase_delta(const unsigned target_size, const unsigned recent)
 {
-  assert(cached_size == delta_list.size());
+  assert(cached_size == heap_size);
   assert(cached_size == chronological_list.Count());
 
   if (size() < 2)
@@ -130,22 +270,34 @@ Trace::erase_delta(const unsigned target_size, const unsigned recent)
   bool modified = false;
 
   const unsigned recent_time = get_recent_time(recent);
-  unsigned lsize = size();
-
-  TraceDelta::iterator candidate = delta_list.begin();
-  while (lsize > target_size) {
-    const TraceDelta &td = *candidate;
-    if (!td.IsEdge() && td.point.time < recent_time) {
-      erase_inside(candidate);
-      lsize--;
-      candidate = delta_list.begin(); // find new top
-      modified = true;
-    } else {
-      ++candidate;
-      // suppressed removal, skip it.
-    }
+
+  /* take the recent points out of the heap, so the top is always the
+     best candidate; they are a suffix of the chronological list */
+  for (TraceDelta *td = (TraceDelta *)chronological_list.GetPrevious();
+       td != &chronological_list && td->point.time >= recent_time;
+       td = &td->GetPrevious())
+    if (!td->IsEdge())
+      heap_remove(*td);
+
+  while (size() > target_size && heap_size > 0) {
+    TraceDelta &td = *delta_heap[0];
+    if (td.IsEdge())
+      /* edges are ranked last, so there is nothing left that may be
+         removed */
+      break;
+
+    erase_inside(td);
+    modified = true;
   }
 
+  for (TraceDelta *td = (TraceDelta *)chronological_list.GetPrevious();
+       td != &chronological_list && td->point.time >= recent_time;
+       td = &td->GetPrevious())
+    if (td->heap_index == null_index)
+      heap_push(*td);
+
+  assert(cached_size == heap_size);
+
   return modified;
 }
 
@@ -160,56 +312,78 @@ Trace::erase_earlier_than(const unsigned p_time)
 
   while (!chronological_list.IsEmpty() &&
          ((TraceDelta *)chronological_list.GetNext())->point.time < p_time) {
-    TraceDelta &td = *(TraceDelta *)chronological_list.GetNext();
-    td.Remove();
-    delta_list.erase(td.delta_list_iterator);
-    --cached_size;
-
+    dispose(*(TraceDelta *)chronological_list.GetNext());
     modified = true;
   }
 
   // need to set deltas for first point, only one of these
   // will occur (have to search for this point)
-  if (modified && !delta_list.empty())
+  if (modified && !chronological_list.IsEmpty())
     erase_start(*(TraceDelta *)chronological_list.GetNext());
 
   return modified;
 }
 
 Trace::TraceDelta &
-Trace::insert(const TraceDelta &td) {
-  TraceDelta::iterator it = delta_list.insert(td).first;
-
-  /* std::set doesn't allow modification of an item, but we
-     override that */
-  TraceDelta &new_td = const_cast<TraceDelta &>(*it);
-  new_td.delta_list_iterator = it;
-  return new_td;
+Trace::insert(const TracePoint &point)
+{
+  assert(!free_list.IsEmpty());
+
+  TraceDelta &td = *(TraceDelta *)free_list.GetNext();
+  td.Remove();
+  td.Set(point);
+  td.InsertBefore(chronological_list);
+  ++cached_size;
+
+  heap_push(td);
+  return td;
+}
+
+void
+Trace::dispose(TraceDelta &td)
+{
+  assert(cached_size > 0);
+
+  if (td.heap_index != null_index)
+    heap_remove(td);
+
+  td.MoveAfter(free_list);
+  --cached_size;
 }
 
 /**
  * Update start node (and neighbour) after min time pruning
  */
 void
-Trace::erase_start(TraceDelta &td_start) {
-  TraceDelta temp_td = td_start;
-  temp_td.SetDisconnected();
-  td_start.Replace(temp_td);
-
-  TraceDelta::iterator i_start = td_start.delta_list_iterator;
-  delta_list.erase(i_start);
-  temp_td.elim_distance = null_delta;
-  temp_td.elim_time = null_time;
-
-  TraceDelta &new_td = insert(temp_td);
-  new_td.SetDisconnected();
-  temp_td.Replace(new_td);
+Trace::erase_start(TraceDelta &td_start)
+{
+  td_start.elim_distance = null_delta;
+  td_start.elim_time = null_time;
+  heap_update(td_start);
+}
+
+void
+Trace::make_room()
+{
+  if (size() < m_max_points)
+    return;
+
+  /* same as optimise_if_old(), but be sure to make room even if all
+     points are within the "no thin" time window */
+  erase_earlier_than(get_min_time());
+  if (size() >= m_opt_points)
+    erase_delta(m_opt_points, no_thin_time);
+  if (size() >= m_max_points)
+    erase_delta(m_opt_points);
+
+  m_average_delta_distance = calc_average_delta_distance(no_thin_time);
+  m_average_delta_time = calc_average_delta_time(no_thin_time);
 }
 
 void
 Trace::append(const AircraftState& state)
 {
-  assert(cached_size == delta_list.size());
+  assert(cached_size == heap_size);
   assert(cached_size == chronological_list.Count());
 
   if (empty()) {
@@ -225,13 +399,12 @@ Trace::append(const AircraftState& state)
     // only add one item per two seconds
     return;
 
+  make_room();
+
   TracePoint tp(state);
   tp.project(task_projection);
 
   TraceDelta &td = insert(tp);
-  td.InsertBefore(chronological_list);
-
-  ++cached_size;
 
   if (!chronological_list.IsFirst(td))
     update_delta(td.GetPrevious());
@@ -294,7 +467,7 @@ Trace::calc_average_delta_time(const unsigned no_thin) const
 bool
 Trace::optimise_if_old()
 {
-  assert(cached_size == delta_list.size());
+  assert(cached_size == heap_size);
   assert(cached_size == chronological_list.Count());
 
   if (size() >= m_max_points) {
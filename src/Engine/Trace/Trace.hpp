@@ -25,16 +25,18 @@ Copyright_License {
 #define TRACE_HPP
 
 #include "Util/NonCopyable.hpp"
-#include "Util/SliceAllocator.hpp"
 #include "Util/ListHead.hpp"
 #include "Util/CastIterator.hpp"
 #include "Navigation/TracePoint.hpp"
 #include "Navigation/TaskProjection.hpp"
 #include "Compiler.h"
 
-#include <set>
+#include <algorithm>
+
 #include <assert.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 struct AircraftState;
 
@@ -82,38 +84,23 @@ class Trace : private NonCopyable
       return false;
     }
 
-    struct DeltaRankOp {
-      bool operator()(const TraceDelta &s1, const TraceDelta &s2) {
-        return DeltaRank(s1, s2);
-      }
-    };
-
-    typedef std::set<TraceDelta, DeltaRankOp,
-                     GlobalSliceAllocator<TraceDelta, 256u> > List;
-    typedef List::iterator iterator;
-    typedef List::const_iterator const_iterator;
-
     TracePoint point;
 
     unsigned elim_time;
     unsigned elim_distance;
     unsigned delta_distance;
 
-    iterator delta_list_iterator;
-
-    TraceDelta(const TracePoint &p)
-      :point(p),
-       elim_time(null_time), elim_distance(null_delta),
-       delta_distance(0) {}
-
-    TraceDelta(const TracePoint &p_last, const TracePoint &p,
-               const TracePoint &p_next)
-      :point(p),
-       elim_time(time_metric(p_last, p, p_next)),
-       elim_distance(distance_metric(p_last, p, p_next)),
-       delta_distance(p.flat_distance(p_last))
-    {
-      assert(elim_distance != null_delta);
+    /**
+     * The position of this item in #delta_heap, or #null_index if it
+     * is not in the heap.
+     */
+    unsigned heap_index;
+
+    void Set(const TracePoint &p) {
+      point = p;
+      elim_time = null_time;
+      elim_distance = null_delta;
+      delta_distance = 0;
     }
 
     /**
@@ -184,16 +171,30 @@ class Trace : private NonCopyable
 
   typedef CastIterator<const TraceDelta, ListHead::const_iterator> ChronologicalConstIterator;
 
-  TraceDelta::List delta_list;
+  /**
+   * Storage for all items; the ones not in use are linked in
+   * #free_list.  It is allocated once with #m_max_points elements.
+   */
+  TraceDelta *pool;
+
+  /**
+   * A binary min-heap ordered by TraceDelta::DeltaRank(), i.e. the
+   * first item is the best candidate for thinning.  Each item knows
+   * its position (TraceDelta::heap_index).
+   */
+  TraceDelta **delta_heap;
+  unsigned heap_size;
+
   ListHead chronological_list;
+  ListHead free_list;
   unsigned cached_size;
 
   TaskProjection task_projection;
 
-  const unsigned m_max_time;
-  const unsigned no_thin_time;
-  const unsigned m_max_points;
-  const unsigned m_opt_points;
+  unsigned m_max_time;
+  unsigned no_thin_time;
+  unsigned m_max_points;
+  unsigned m_opt_points;
 
   unsigned m_average_delta_time;
   unsigned m_average_delta_distance;
@@ -211,6 +212,8 @@ public:
         const unsigned max_time = null_time,
         const unsigned max_points = 1000);
 
+  ~Trace();
+
 protected:
   /**
    * Find recent time after which points should not be culled
@@ -224,25 +227,20 @@ protected:
   unsigned get_recent_time(const unsigned t) const;
 
   /**
-   * Update delta values for specified item in the delta list and the
-   * tree.  This repositions the item after into its sorted position.
+   * Update delta values for specified item, and move it to its new
+   * position in the heap.
    *
-   * @param it Item to update
-   * @param tree Tree containing leaf
-   *
-   * @return Iterator to updated item
+   * @param td Item to update
    */
   void update_delta(TraceDelta &td);
 
   /**
-   * Erase a non-edge item from delta list and tree, updating
-   * deltas in the process.  This invalidates the calling iterator.
-   *
-   * @param it Item to erase
-   * @param tree Tree to remove from
+   * Erase a non-edge item from the heap and the chronological list,
+   * updating deltas of its neighbours in the process.
    *
+   * @param td Item to erase
    */
-  void erase_inside(TraceDelta::iterator it);
+  void erase_inside(TraceDelta &td);
 
   /**
    * Erase elements based on delta metric until the size is
@@ -272,17 +270,50 @@ protected:
    */
   bool erase_earlier_than(const unsigned p_time);
 
-  TraceDelta &insert(const TraceDelta &td);
+  /**
+   * Take an item from the pool, append it to the chronological list
+   * and add it to the heap.
+   */
+  TraceDelta &insert(const TracePoint &point);
+
+  /**
+   * Remove an item from the chronological list and the heap, and
+   * return it to the pool.
+   */
+  void dispose(TraceDelta &td);
 
   /**
    * Update start node (and neighbour) after min time pruning
    */
   void erase_start(TraceDelta &td_start);
 
+private:
+  void allocate_pool();
+
+  void heap_push(TraceDelta &td);
+  void heap_remove(TraceDelta &td);
+  void heap_update(TraceDelta &td);
+  void heap_set(unsigned i, TraceDelta &td);
+  void sift_up(unsigned i);
+  void sift_down(unsigned i);
+
+  /**
+   * Make room for a new item if the pool is exhausted, because
+   * optimise_if_old() has not been called often enough.
+   */
+  void make_room();
+
 public:
   /**
-   * Add trace to internal store.  Call optimise() periodically
-   * to balance tree for faster queries
+   * Add trace to internal store.  Call optimise_if_old()
+   * regularly, to thin the trace when it is full.
+   *
+   * The trace never holds more than #m_max_points items.  If
+   * optimise_if_old() is called after each append(), it thins the
+   * trace when it reaches that size, and append() never has to.
+   * Otherwise, append() thins a full trace to #m_opt_points before
+   * adding the new point; this ignores the "no thin" window if
+   * nothing else can be removed.
    *
    * @param state Aircraft state to log point for
    */
@@ -293,6 +324,13 @@ public:
    */
   void clear();
 
+  /**
+   * Replace the contents of this object with a copy of another
+   * trace, including its parameters.  This allows another thread to
+   * work on a private snapshot while the original keeps growing.
+   */
+  void CopyFrom(const Trace &other);
+
   unsigned GetMaxSize() const {
     return m_max_points;
   }
@@ -361,6 +399,7 @@ private:
   unsigned calc_average_delta_time(const unsigned no_thin) const;
 
   static const unsigned null_delta = 0 - 1;
+  static const unsigned null_index = 0 - 1;
 
 public:
   static const unsigned null_time = 0 - 1;
@@ -0,0 +1,205 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "PerfCounters.hpp"
+
+#ifndef PERF_COUNTERS_TLS
+#include "Thread/Local.hpp"
+#endif
+
+#include <string.h>
+
+namespace PerfCounters {
+  static Block blocks[NUM_CONTEXTS];
+
+#ifdef PERF_COUNTERS_TLS
+  __thread Block *current_block;
+#else
+  /**
+   * Points to the calling thread's block.  This is a function-local
+   * static, so it is available to static constructors which use
+   * the counters.
+   */
+  static ThreadLocal &
+  GetCurrentBlockPointer()
+  {
+    static ThreadLocal current;
+    return current;
+  }
+#endif
+}
+
+void
+PerfCounters::Block::Clear()
+{
+  memset(this, 0, sizeof(*this));
+}
+
+void
+PerfCounters::Block::Add(const Block &other)
+{
+  for (unsigned i = 0; i < NUM_COUNTERS; ++i)
+    counters[i] += other.counters[i];
+
+  for (unsigned i = 0; i < NUM_TIMERS; ++i) {
+    TimerValue &a = timers[i];
+    const TimerValue &b = other.timers[i];
+
+    a.count += b.count;
+    a.total += b.total;
+    if (b.max > a.max)
+      a.max = b.max;
+    a.over_budget += b.over_budget;
+  }
+}
+
+void
+PerfCounters::SetContext(Context context)
+{
+  SetBlock(&blocks[context]);
+}
+
+void
+PerfCounters::SetBlock(Block *block)
+{
+#ifdef PERF_COUNTERS_TLS
+  current_block = block;
+#else
+  GetCurrentBlockPointer().Set(block);
+#endif
+}
+
+void
+PerfCounters::Merge(Context context, const Block &src)
+{
+  blocks[context].Add(src);
+}
+
+PerfCounters::Block &
+PerfCounters::Other()
+{
+  return blocks[CONTEXT_OTHER];
+}
+
+#ifndef PERF_COUNTERS_TLS
+
+PerfCounters::Block &
+PerfCounters::Current()
+{
+  Block *block = (Block *)GetCurrentBlockPointer().Get();
+  return block != NULL ? *block : Other();
+}
+
+#endif
+
+void
+PerfCounters::AddTime(Timer timer, unsigned ms)
+{
+  TimerValue &value = Current().timers[timer];
+  ++value.count;
+  value.total += ms;
+  if (ms > value.max)
+    value.max = ms;
+  if (ms > GetBudget(timer))
+    ++value.over_budget;
+}
+
+void
+PerfCounters::Collect(Context context, Block &dest)
+{
+  dest = blocks[context];
+}
+
+void
+PerfCounters::Reset()
+{
+  for (unsigned i = 0; i < NUM_CONTEXTS; ++i)
+    blocks[i].Clear();
+}
+
+const TCHAR *
+PerfCounters::GetName(Counter counter)
+{
+  static const TCHAR *const names[NUM_COUNTERS] = {
+    _T("distance_bearing"),
+    _T("maccready"),
+    _T("airspace_queries"),
+    _T("airspace_intersections"),
+    _T("waypoint_queries"),
+    _T("dijkstra_queries"),
+    _T("dijkstra_links"),
+    _T("task_stages"),
+    _T("astar_links"),
+    _T("contest_solve"),
+    _T("contest_trace"),
+  };
+
+  return names[counter];
+}
+
+const TCHAR *
+PerfCounters::GetName(Timer timer)
+{
+  static const TCHAR *const names[NUM_TIMERS] = {
+    _T("gps"),
+    _T("idle"),
+    _T("logging"),
+    _T("task"),
+    _T("airspace_warning"),
+    _T("merge"),
+    _T("draw"),
+    _T("map_idle"),
+    _T("contest"),
+  };
+
+  return names[timer];
+}
+
+const TCHAR *
+PerfCounters::GetName(Context context)
+{
+  static const TCHAR *const names[NUM_CONTEXTS] = {
+    _T("other"),
+    _T("calculation"),
+    _T("merge"),
+    _T("draw"),
+    _T("contest"),
+    _T("pool"),
+  };
+
+  return names[context];
+}
+
+unsigned
+PerfCounters::GetBudget(Timer timer)
+{
+  switch (timer) {
+  case TIMER_MERGE:
+    /* the merge thread runs up to every 150 ms */
+    return 150;
+
+  default:
+    /* GlideComputer::ProcessGPS() schedules an "idle" call every
+       500 ms */
+    return 500;
+  }
+}
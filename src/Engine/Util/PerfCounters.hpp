@@ -0,0 +1,210 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_PERF_COUNTERS_HPP
+#define XCSOAR_PERF_COUNTERS_HPP
+
+#include "Compiler.h"
+
+#include <tchar.h>
+
+/*
+ * Where the compiler supports it, the calling thread's block is
+ * cached in a __thread variable, which makes Increment() an inline
+ * load and add.  Elsewhere, it falls back to #ThreadLocal.
+ */
+#if defined(HAVE_POSIX) && !defined(ANDROID) && !defined(__APPLE__) && \
+  GCC_VERSION >= 30300
+#define PERF_COUNTERS_TLS
+#endif
+
+/**
+ * Cheap event counters and stage timers which are always compiled
+ * in.  Each thread which calls SetContext() gets its own block of
+ * values, so incrementing needs neither a lock nor an atomic
+ * operation; other threads share the #CONTEXT_OTHER block, whose
+ * values are only approximate.  The blocks are read without locking
+ * by Collect(), which is good enough for statistics.
+ */
+namespace PerfCounters {
+  enum Counter {
+    COUNT_DISTANCE_BEARING,
+    COUNT_MACCREADY,
+    COUNT_AIRSPACE_QUERIES,
+    COUNT_AIRSPACE_INTERSECTIONS,
+    COUNT_WAYPOINT_QUERIES,
+    COUNT_DIJKSTRA_QUERIES,
+    COUNT_DIJKSTRA_LINKS,
+    COUNT_TASK_STAGES,
+    COUNT_ASTAR_LINKS,
+    COUNT_CONTEST_SOLVE,
+    COUNT_CONTEST_TRACE,
+    NUM_COUNTERS
+  };
+
+  enum Timer {
+    TIMER_GPS,
+    TIMER_IDLE,
+    TIMER_LOGGING,
+    TIMER_TASK,
+    TIMER_AIRSPACE_WARNING,
+    TIMER_MERGE,
+    TIMER_DRAW,
+    TIMER_MAP_IDLE,
+    TIMER_CONTEST,
+    NUM_TIMERS
+  };
+
+  enum Context {
+    CONTEXT_OTHER,
+    CONTEXT_CALCULATION,
+    CONTEXT_MERGE,
+    CONTEXT_DRAW,
+    CONTEXT_CONTEST,
+
+    /**
+     * The worker threads of all #ThreadPool instances.  Each worker
+     * counts into a private block, which is added to this context
+     * with Merge() when the worker has finished its parts of a job.
+     */
+    CONTEXT_POOL,
+
+    NUM_CONTEXTS
+  };
+
+  struct TimerValue {
+    /** The number of samples */
+    unsigned count;
+
+    /** The sum of all samples [ms] */
+    unsigned long total;
+
+    /** The longest sample [ms] */
+    unsigned max;
+
+    /** The number of samples which exceeded the budget [ms] */
+    unsigned over_budget;
+  };
+
+  struct Block {
+    unsigned long counters[NUM_COUNTERS];
+    TimerValue timers[NUM_TIMERS];
+
+    void Clear();
+
+    /**
+     * Add the values of another block to this one.
+     */
+    void Add(const Block &other);
+  };
+
+  /**
+   * Declare the calling thread's context.  Call this once at the
+   * beginning of the thread function.
+   */
+  void SetContext(Context context);
+
+  /**
+   * Let the calling thread count into a private block.  The caller
+   * is responsible for passing its values on with Merge().
+   */
+  void SetBlock(Block *block);
+
+  /**
+   * Add the values of a private block to a context.  Calls for the
+   * same context must be serialised by the caller.
+   */
+  void Merge(Context context, const Block &src);
+
+  /**
+   * Returns the #CONTEXT_OTHER block, which is used by threads
+   * without a context.
+   */
+  gcc_const
+  Block &Other();
+
+#ifdef PERF_COUNTERS_TLS
+  /**
+   * The calling thread's block, or NULL if it has none.  Use
+   * Current() instead of accessing this variable.
+   */
+  extern __thread Block *current_block;
+
+  /**
+   * Returns the calling thread's block.
+   */
+  static inline Block &
+  Current()
+  {
+    Block *block = current_block;
+    return gcc_likely(block != NULL) ? *block : Other();
+  }
+#else
+  /**
+   * Returns the calling thread's block.
+   */
+  Block &Current();
+#endif
+
+  static inline void
+  Increment(Counter counter)
+  {
+    ++Current().counters[counter];
+  }
+
+  /**
+   * Record the duration of one run of a stage.
+   *
+   * @param ms the duration [ms]
+   */
+  void AddTime(Timer timer, unsigned ms);
+
+  /**
+   * Copy the values of one context.  This may be called by any
+   * thread.
+   */
+  void Collect(Context context, Block &dest);
+
+  /**
+   * Reset all values.  Must not be called while other threads are
+   * using the counters.
+   */
+  void Reset();
+
+  gcc_const
+  const TCHAR *GetName(Counter counter);
+
+  gcc_const
+  const TCHAR *GetName(Timer timer);
+
+  gcc_const
+  const TCHAR *GetName(Context context);
+
+  /**
+   * Returns the duration [ms] which a stage should not exceed.  This
+   * is the period of the calculation thread's "idle" calls.
+   */
+  gcc_const
+  unsigned GetBudget(Timer timer);
+}
+
+#endif
@@ -23,9 +23,7 @@
 #include "Waypoints.hpp"
 #include "WaypointVisitor.hpp"
 #include "StringUtil.hpp"
-
-// global, used for test harness
-unsigned n_queries = 0;
+#include "Util/PerfCounters.hpp"
 
 /**
  * Container accessor to allow a WaypointVisitor to visit WaypointEnvelopes 
@@ -173,9 +171,7 @@ Waypoints::get_nearest(const GeoPoint &loc, fixed range) const
   std::pair<WaypointTree::const_iterator, WaypointTree::distance_type> found =
     waypoint_tree.FindNearest(bb_target, mrange);
 
-#ifdef INSTRUMENT_TASK
-  n_queries++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_WAYPOINT_QUERIES);
 
   if (found.first == waypoint_tree.end())
     return NULL;
@@ -195,9 +191,7 @@ Waypoints::get_nearest_landable(const GeoPoint &loc, fixed range) const
   std::pair<WaypointTree::const_iterator, WaypointTree::distance_type> found =
       waypoint_tree.FindNearestIf(bb_target, mrange, LandablePredicate());
 
-#ifdef INSTRUMENT_TASK
-  n_queries++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_WAYPOINT_QUERIES);
 
   if (found.first == waypoint_tree.end())
     return NULL;
@@ -286,9 +280,7 @@ Waypoints::visit_within_range(const GeoPoint &loc, const fixed range,
 
   waypoint_tree.VisitWithinRange(bb_target, mrange, wve);
 
-#ifdef INSTRUMENT_TASK
-  n_queries++;
-#endif
+  PerfCounters::Increment(PerfCounters::COUNT_WAYPOINT_QUERIES);
 }
 
 void
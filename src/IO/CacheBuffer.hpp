@@ -0,0 +1,117 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_IO_CACHE_BUFFER_HPP
+#define XCSOAR_IO_CACHE_BUFFER_HPP
+
+#include "Util/tstring.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Helpers for binary cache files which are written and read in one
+ * piece.  The format is not portable; it is only meant for files
+ * managed by #FileCache.
+ */
+
+/**
+ * Appends values to a memory buffer, so the whole cache can be
+ * written with one call.
+ */
+class CacheWriter {
+  std::vector<uint8_t> &buffer;
+
+public:
+  CacheWriter(std::vector<uint8_t> &_buffer):buffer(_buffer) {}
+
+  void Write(const void *p, size_t size) {
+    const uint8_t *q = (const uint8_t *)p;
+    buffer.insert(buffer.end(), q, q + size);
+  }
+
+  template<typename T>
+  void Write(const T &value) {
+    Write(&value, sizeof(value));
+  }
+
+  /**
+   * Writes a string with a 16 bit length prefix; longer strings are
+   * truncated.
+   */
+  void WriteString(const tstring &value) {
+    const uint16_t length = std::min(value.length(), (size_t)0xffff);
+    Write(length);
+    Write(value.data(), length * sizeof(TCHAR));
+  }
+};
+
+/**
+ * Reads values from a memory buffer, checking for truncation.
+ */
+class CacheReader {
+  const uint8_t *p, *end;
+
+public:
+  CacheReader(const std::vector<uint8_t> &buffer)
+    :p(&buffer[0]), end(&buffer[0] + buffer.size()) {}
+
+  bool Read(void *dest, size_t size) {
+    if (GetRemaining() < size)
+      return false;
+
+    memcpy(dest, p, size);
+    p += size;
+    return true;
+  }
+
+  template<typename T>
+  bool Read(T &value) {
+    return Read(&value, sizeof(value));
+  }
+
+  bool ReadString(tstring &value) {
+    uint16_t length;
+    if (!Read(length) || GetRemaining() < length * sizeof(TCHAR))
+      return false;
+
+    /* records are packed, so the characters may not be aligned for
+       TCHAR; copy the bytes instead of reading them in place */
+    value.resize(length);
+    if (length > 0)
+      memcpy(&value[0], p, length * sizeof(TCHAR));
+    p += length * sizeof(TCHAR);
+    return true;
+  }
+
+  size_t GetRemaining() const {
+    return end - p;
+  }
+
+  bool IsEnd() const {
+    return p == end;
+  }
+};
+
+#endif
@@ -93,7 +93,7 @@ FileCache::~FileCache() {
   free(cache_path);
 }
 
-inline size_t
+size_t
 FileCache::path_buffer_size(const TCHAR *name) const
 {
   return cache_path_length + _tcslen(name) + 2;
@@ -116,7 +116,8 @@ FileCache::flush(const TCHAR *name)
 }
 
 FILE *
-FileCache::load(const TCHAR *name, const TCHAR *original_path)
+FileCache::open(const TCHAR *name, const TCHAR *original_path,
+                const TCHAR *mode)
 {
   struct file_info original_info;
   if (!get_regular_file_info(original_path, &original_info))
@@ -134,7 +135,7 @@ FileCache::load(const TCHAR *name, const TCHAR *original_path)
     return NULL;
   }
 #endif
-  FILE *file = _tfopen(path, _T("rb"));
+  FILE *file = _tfopen(path, mode);
   if (file == NULL)
     return NULL;
 
@@ -152,6 +153,18 @@ FileCache::load(const TCHAR *name, const TCHAR *original_path)
   return file;
 }
 
+FILE *
+FileCache::load(const TCHAR *name, const TCHAR *original_path)
+{
+  return open(name, original_path, _T("rb"));
+}
+
+FILE *
+FileCache::update(const TCHAR *name, const TCHAR *original_path)
+{
+  return open(name, original_path, _T("r+b"));
+}
+
 FILE *
 FileCache::save(const TCHAR *name, const TCHAR *original_path)
 {
@@ -35,14 +35,23 @@ public:
   FileCache(const TCHAR *_cache_path);
   ~FileCache();
 
-protected:
   size_t path_buffer_size(const TCHAR *name) const;
   const TCHAR *make_cache_path(TCHAR *buffer, const TCHAR *name) const;
 
+protected:
+  FILE *open(const TCHAR *name, const TCHAR *original_path,
+             const TCHAR *mode);
+
 public:
   void flush(const TCHAR *name);
   FILE *load(const TCHAR *name, const TCHAR *original_path);
 
+  /**
+   * Like load(), but opens the cache file for reading and writing, to
+   * allow in-place updates of a file which was created with save().
+   */
+  FILE *update(const TCHAR *name, const TCHAR *original_path);
+
   FILE *save(const TCHAR *name, const TCHAR *original_path);
   bool commit(const TCHAR *name, FILE *file);
   void cancel(const TCHAR *name, FILE *file);
@@ -51,6 +51,12 @@ bool CommonInterface::movement_detected = false;
 bool ActionInterface::doForceShutdown = false;
 
 InterfaceBlackboard CommonInterface::blackboard;
+
+/**
+ * The DeviceBlackboard serials of the data copied by the last
+ * ExchangeDeviceBlackboard() call.
+ */
+static unsigned device_basic_serial, device_calculated_serial;
 StatusMessageList CommonInterface::status_messages;
 MainWindow CommonInterface::main_window(status_messages);
 
@@ -77,13 +83,20 @@ void
 XCSoarInterface::ExchangeDeviceBlackboard()
 {
   ScopeLock protect(device_blackboard.mutex);
-  ReadBlackboardBasic(device_blackboard.Basic());
 
-  const NMEAInfo &real = device_blackboard.RealState();
-  movement_detected = real.connected && real.gps.real &&
-    real.MovementDetected();
+  if (device_blackboard.GetBasicSerial() != device_basic_serial) {
+    device_basic_serial = device_blackboard.GetBasicSerial();
+    ReadBlackboardBasic(device_blackboard.Basic());
 
-  ReadBlackboardCalculated(device_blackboard.Calculated());
+    const NMEAInfo &real = device_blackboard.RealState();
+    movement_detected = real.connected && real.gps.real &&
+      real.MovementDetected();
+  }
+
+  if (device_blackboard.GetCalculatedSerial() != device_calculated_serial) {
+    device_calculated_serial = device_blackboard.GetCalculatedSerial();
+    ReadBlackboardCalculated(device_blackboard.Calculated());
+  }
 
   device_blackboard.ReadSettingsComputer(SettingsComputer());
 }
@@ -24,6 +24,7 @@ Copyright_License {
 #include "GlueMapWindow.hpp"
 #include "Components.hpp"
 #include "DrawThread.hpp"
+#include "Protection.hpp"
 #include "DeviceBlackboard.hpp"
 #include "Look/Look.hpp"
 
@@ -35,6 +36,7 @@ GlueMapWindow::GlueMapWindow(const Look &look)
    drag_mode(DRAG_NONE),
    ignore_single_click(false),
    DisplayMode(DM_CRUISE),
+   basic_serial(0), calculated_serial(0),
    thermal_band_renderer(look.thermal_band, look.chart)
 {
 }
@@ -77,10 +79,21 @@ GlueMapWindow::SetSettingsComputer(const SETTINGS_COMPUTER &new_value)
 void
 GlueMapWindow::ExchangeBlackboard()
 {
-  /* copy device_blackboard to MapWindow */
+  /* copy device_blackboard to MapWindow, but only the parts which
+     have changed since the last frame */
 
   device_blackboard.mutex.Lock();
-  ReadBlackboard(device_blackboard.Basic(), device_blackboard.Calculated());
+
+  if (device_blackboard.GetBasicSerial() != basic_serial) {
+    basic_serial = device_blackboard.GetBasicSerial();
+    ReadBlackboardBasic(device_blackboard.Basic());
+  }
+
+  if (device_blackboard.GetCalculatedSerial() != calculated_serial) {
+    calculated_serial = device_blackboard.GetCalculatedSerial();
+    ReadBlackboardCalculated(device_blackboard.Calculated());
+  }
+
   device_blackboard.mutex.Unlock();
 
 #ifndef ENABLE_OPENGL
@@ -106,6 +119,19 @@ GlueMapWindow::FullRedraw()
 #endif
 }
 
+void
+GlueMapWindow::OnTerrainLoaded()
+{
+  /* this is called by the TerrainLoader thread; don't touch the
+     window directly, only schedule a redraw */
+#ifdef ENABLE_OPENGL
+  TriggerCalculatedUpdate();
+#else
+  if (draw_thread != NULL)
+    draw_thread->TriggerRedraw();
+#endif
+}
+
 void
 GlueMapWindow::QuickRedraw()
 {
@@ -92,6 +92,12 @@ class GlueMapWindow : public MapWindow {
 
   OffsetHistory offsetHistory;
 
+  /**
+   * The DeviceBlackboard serials of the data copied by the last
+   * ExchangeBlackboard() call.
+   */
+  unsigned basic_serial, calculated_serial;
+
 #ifndef ENABLE_OPENGL
   /**
    * This mutex protects the attributes that are read by the
@@ -188,6 +194,9 @@ protected:
   virtual void on_paint(Canvas &canvas);
   virtual void on_paint_buffer(Canvas& canvas);
 
+  /* virtual methods from class MapWindow */
+  virtual void OnTerrainLoaded();
+
 private:
   void DrawMapScale(Canvas &canvas, const PixelRect &rc,
                     const MapWindowProjection &projection) const;
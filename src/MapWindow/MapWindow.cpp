@@ -26,14 +26,33 @@ Copyright_License {
 #include "Topography/TopographyStore.hpp"
 #include "Topography/TopographyRenderer.hpp"
 #include "Terrain/RasterTerrain.hpp"
+#include "Terrain/TerrainLoader.hpp"
 #include "Terrain/RasterWeather.hpp"
 #include "Task/ProtectedTaskManager.hpp"
 #include "Engine/Math/Earth.hpp"
 #include "Units/Units.hpp"
 #include "Operation.hpp"
 
+#include <assert.h>
 #include <tchar.h>
 
+/**
+ * The #TerrainLoader of a #MapWindow, which notifies the window when
+ * new tiles are available.
+ */
+class MapTerrainLoader : public TerrainLoader {
+  MapWindow &map;
+
+public:
+  MapTerrainLoader(MapWindow &_map, RasterTerrain &terrain)
+    :TerrainLoader(terrain), map(_map) {}
+
+protected:
+  virtual void OnTilesLoaded() {
+    map.OnTerrainLoaded();
+  }
+};
+
 /**
  * Constructor of the MapWindow class
  */
@@ -47,6 +66,7 @@ MapWindow::MapWindow(const WaypointLook &_waypoint_look,
    topography(NULL), topography_renderer(NULL),
    terrain(NULL),
    terrain_radius(fixed_zero),
+   terrain_loader(NULL),
    weather(NULL),
    task_look(_task_look),
    aircraft_look(_aircraft_look),
@@ -64,6 +84,7 @@ MapWindow::MapWindow(const WaypointLook &_waypoint_look,
 
 MapWindow::~MapWindow()
 {
+  StopTerrainLoader();
   delete topography_renderer;
 }
 
@@ -136,16 +157,14 @@ MapWindow::UpdateTerrain()
 
   // always service terrain even if it's not used by the map,
   // because it's used by other calculations
-  RasterTerrain::ExclusiveLease lease(*terrain);
-  lease->SetViewCenter(location, radius);
-  if (lease->IsDirty())
-    terrain_radius = fixed_zero;
-  else {
-    terrain_radius = radius;
-    terrain_center = location;
-  }
+  assert(terrain_loader != NULL);
+  terrain_loader->SetViewCenter(location, radius);
+  terrain_radius = radius;
+  terrain_center = location;
 
-  return lease->IsDirty();
+  /* the TerrainLoader keeps loading until all tiles are there, no
+     need to call us again */
+  return false;
 }
 
 bool
@@ -200,13 +219,33 @@ MapWindow::set_topography(TopographyStore *_topography)
     : NULL;
 }
 
+void
+MapWindow::StopTerrainLoader()
+{
+  if (terrain_loader == NULL)
+    return;
+
+  terrain_loader->BeginStop();
+  terrain_loader->Join();
+  delete terrain_loader;
+  terrain_loader = NULL;
+}
+
 void
 MapWindow::set_terrain(RasterTerrain *_terrain)
 {
+  StopTerrainLoader();
+
   terrain = _terrain;
   terrain_center = GeoPoint(Angle::zero(),
                             Angle::zero());
+  terrain_radius = fixed_zero;
   m_background.set_terrain(_terrain);
+
+  if (terrain != NULL) {
+    terrain_loader = new MapTerrainLoader(*this, *terrain);
+    terrain_loader->Start();
+  }
 }
 
 void
@@ -49,6 +49,7 @@ class TopographyStore;
 class TopographyRenderer;
 class RasterTerrain;
 class RasterWeather;
+class TerrainLoader;
 class Marks;
 class Waypoints;
 struct Waypoint;
@@ -122,6 +123,12 @@ protected:
   GeoPoint terrain_center;
   fixed terrain_radius;
 
+  /**
+   * Loads terrain tiles for the current view in background.  Exists
+   * only while #terrain is set.
+   */
+  TerrainLoader *terrain_loader;
+
   RasterWeather *weather;
 
   const TaskLook &task_look;
@@ -164,6 +171,7 @@ protected:
   ScreenStopWatch draw_sw;
 
   friend class DrawThread;
+  friend class MapTerrainLoader;
 
 public:
   MapWindow(const WaypointLook &waypoint_look,
@@ -209,6 +217,12 @@ public:
   }
 
   void set_topography(TopographyStore *_topography);
+
+  /**
+   * Set the terrain, and start a #TerrainLoader for it.  When
+   * replacing the terrain, call this with NULL before deleting the
+   * old object.
+   */
   void set_terrain(RasterTerrain *_terrain);
   void set_weather(RasterWeather *_weather);
 
@@ -267,14 +281,26 @@ public:
    */
   virtual void Render(Canvas &canvas, const PixelRect &rc);
 
+private:
+  void StopTerrainLoader();
+
 protected:
   unsigned UpdateTopography(unsigned max_update=1024);
 
   /**
+   * Schedule loading the terrain tiles for the current view.  The
+   * tiles are loaded by the #TerrainLoader thread.
+   *
    * @return true if UpdateTerrain() should be called again
    */
   bool UpdateTerrain();
 
+  /**
+   * Called by the #TerrainLoader thread after new terrain tiles have
+   * become available.  The default implementation does nothing.
+   */
+  virtual void OnTerrainLoaded() {}
+
   /**
    * @return true if UpdateWeather() should be called again
    */
@@ -45,3 +45,15 @@ MapWindowBlackboard::ReadBlackboard(const MoreData &nmea_info,
   calculated_info = derived_info;
 }
 
+void
+MapWindowBlackboard::ReadBlackboardBasic(const MoreData &nmea_info)
+{
+  gps_info = nmea_info;
+}
+
+void
+MapWindowBlackboard::ReadBlackboardCalculated(const DerivedInfo &derived_info)
+{
+  calculated_info = derived_info;
+}
+
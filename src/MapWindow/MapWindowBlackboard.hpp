@@ -41,6 +41,8 @@ class MapWindowBlackboard:
 protected:
   void ReadBlackboard(const MoreData &nmea_info,
                       const DerivedInfo &derived_info);
+  void ReadBlackboardBasic(const MoreData &nmea_info);
+  void ReadBlackboardCalculated(const DerivedInfo &derived_info);
   void ReadSettingsComputer(const SETTINGS_COMPUTER &settings);
   void ReadSettingsMap(const SETTINGS_MAP &settings);
 };
@@ -25,6 +25,7 @@ Copyright_License {
 #include "DeviceBlackboard.hpp"
 #include "Protection.hpp"
 #include "NMEA/MoreData.hpp"
+#include "PerfLog.hpp"
 
 MergeThread::MergeThread(DeviceBlackboard &_device_blackboard)
   :WorkerThread(150, 50, 20),
@@ -34,9 +35,18 @@ MergeThread::MergeThread(DeviceBlackboard &_device_blackboard)
   last_any.Reset();
 }
 
+void
+MergeThread::Run()
+{
+  PerfCounters::SetContext(PerfCounters::CONTEXT_MERGE);
+
+  WorkerThread::Run();
+}
+
 void
 MergeThread::Tick()
 {
+  ScopePerfTimer timer(PerfCounters::TIMER_MERGE);
   ScopeLock protect(device_blackboard.mutex);
 
   device_blackboard.Merge();
@@ -65,6 +65,7 @@ public:
   }
 
 protected:
+  virtual void Run();
   virtual void Tick();
 };
 
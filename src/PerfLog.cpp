@@ -0,0 +1,75 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "PerfLog.hpp"
+#include "LogFile.hpp"
+#include "LocalPath.hpp"
+#include "IO/TextWriter.hpp"
+
+#include <windef.h> // for MAX_PATH
+
+using namespace PerfCounters;
+
+void
+LogPerfCounters()
+{
+  TCHAR path[MAX_PATH];
+  LocalPath(path, _T("xcsoar-perf.csv"));
+
+  TextWriter writer(path);
+  if (!writer.error())
+    writer.writeln("context,kind,name,count,total_ms,max_ms,over_budget");
+
+  for (unsigned c = 0; c < NUM_CONTEXTS; ++c) {
+    const Context context = (Context)c;
+    Block block;
+    Collect(context, block);
+
+    for (unsigned i = 0; i < NUM_COUNTERS; ++i) {
+      const unsigned long count = block.counters[i];
+      if (count == 0)
+        continue;
+
+      const TCHAR *name = GetName((Counter)i);
+      LogStartUp(_T("perf %s %s %lu"), GetName(context), name, count);
+      if (!writer.error())
+        writer.printfln(_T("%s,counter,%s,%lu,,,"),
+                        GetName(context), name, count);
+    }
+
+    for (unsigned i = 0; i < NUM_TIMERS; ++i) {
+      const TimerValue &value = block.timers[i];
+      if (value.count == 0)
+        continue;
+
+      const TCHAR *name = GetName((Timer)i);
+      LogStartUp(_T("perf %s %s n=%u avg=%lu max=%u over=%u"),
+                 GetName(context), name, value.count,
+                 value.total / value.count, value.max, value.over_budget);
+      if (!writer.error())
+        writer.printfln(_T("%s,timer,%s,%u,%lu,%u,%u"),
+                        GetName(context), name, value.count,
+                        value.total, value.max, value.over_budget);
+    }
+  }
+}
@@ -41,6 +41,7 @@ Copyright_License {
 #include "Task/ProtectedTaskManager.hpp"
 #include "GPSClock.hpp"
 #include "Operation.hpp"
+#include "PerfLog.hpp"
 
 #ifdef _WIN32_WCE
 void
@@ -150,6 +151,10 @@ ProcessTimer::SystemProcessTimer()
   SystemClockTimer();
 
   CheckDisplayTimeOut(false);
+
+  static PeriodClock perf_clock;
+  if (perf_clock.check_update(10 * 60 * 1000))
+    LogPerfCounters();
 }
 
 static void
@@ -28,6 +28,7 @@ Copyright_License {
 #include "Components.hpp"
 #include "Computer/GlideComputer.hpp"
 #include "CalculationThread.hpp"
+#include "Computer/ContestThread.hpp"
 #include "MergeThread.hpp"
 #include "DrawThread.hpp"
 
@@ -91,6 +92,11 @@ void CreateCalculationThread(void) {
   merge_thread->Trigger();
 
   calculation_thread = new CalculationThread(*glide_computer);
+
+  /* the contest optimiser runs in its own low-priority thread, fed
+     by the calculation thread */
+  contest_thread = new ContestThread(glide_computer->GetTraceComputer());
+  glide_computer->SetContestThread(contest_thread);
 }
 
 void
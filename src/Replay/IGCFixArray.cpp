@@ -0,0 +1,187 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Replay/IGCFixArray.hpp"
+#include "OS/FileMapping.hpp"
+
+#include <string.h>
+
+IGCFixArray::IGCFixArray()
+  :header_available(false), date_available(false)
+{
+}
+
+/**
+ * Empty the vector and release its memory (which clear() does not).
+ */
+template<typename T>
+static void
+Free(std::vector<T> &v)
+{
+  std::vector<T>().swap(v);
+}
+
+void
+IGCFixArray::Clear()
+{
+  header_available = false;
+  date_available = false;
+  extensions.clear();
+
+  Free(time);
+  Free(latitude);
+  Free(longitude);
+  Free(pressure_altitude);
+  Free(gps_altitude);
+  Free(extension_values);
+}
+
+bool
+IGCFixArray::Load(const TCHAR *path)
+{
+  FileMapping map(path);
+  if (map.error())
+    return false;
+
+  Parse((const char *)map.data(), map.size());
+  return true;
+}
+
+void
+IGCFixArray::Parse(const char *data, size_t length)
+{
+  /* a "B" record without extensions is 35 bytes plus the line
+     terminator; reserving for that (almost) avoids reallocation */
+  const size_t estimate = size() + length / 37;
+  time.reserve(estimate);
+  latitude.reserve(estimate);
+  longitude.reserve(estimate);
+  pressure_altitude.reserve(estimate);
+  gps_altitude.reserve(estimate);
+
+  const char *const end = data + length;
+  while (data < end) {
+    const char *eol = (const char *)memchr(data, '\n', end - data);
+    if (eol == NULL)
+      eol = end;
+
+    size_t line_length = eol - data;
+    if (line_length > 0 && data[line_length - 1] == '\r')
+      --line_length;
+
+    ParseLine(data, line_length);
+
+    data = eol + 1;
+  }
+}
+
+/**
+ * Copy a line to a null-terminated buffer, for the parsers which
+ * need one.  Long lines are truncated.
+ */
+static const char *
+TerminateLine(char *buffer, size_t buffer_size,
+              const char *line, size_t length)
+{
+  if (length >= buffer_size)
+    length = buffer_size - 1;
+
+  memcpy(buffer, line, length);
+  buffer[length] = 0;
+  return buffer;
+}
+
+void
+IGCFixArray::ParseLine(const char *line, size_t length)
+{
+  if (length == 0)
+    return;
+
+  char buffer[256];
+
+  switch (line[0]) {
+  case 'B': {
+    IGCRawFix fix;
+    if (!IGCDecodeFix(line, length, fix))
+      return;
+
+    time.push_back(fix.time);
+    latitude.push_back(fix.latitude);
+    longitude.push_back(fix.longitude);
+    pressure_altitude.push_back(fix.pressure_altitude);
+    gps_altitude.push_back(fix.gps_altitude);
+
+    for (unsigned i = 0; i < extensions.size(); ++i)
+      extension_values.push_back(IGCDecodeExtension(line, length,
+                                                    extensions[i]));
+    break;
+  }
+
+  case 'I':
+    /* the extensions may not change once there are fixes, because
+       all rows of #extension_values must have the same length */
+    if (empty())
+      IGCParseExtensions(TerminateLine(buffer, sizeof(buffer),
+                                       line, length),
+                         extensions);
+    break;
+
+  case 'A':
+    if (!header_available)
+      header_available =
+        IGCParseHeader(TerminateLine(buffer, sizeof(buffer), line, length),
+                       header);
+    break;
+
+  case 'H':
+    if (!date_available)
+      date_available =
+        IGCParseDate(TerminateLine(buffer, sizeof(buffer), line, length),
+                     date);
+    break;
+  }
+}
+
+void
+IGCFixArray::GetRaw(unsigned i, IGCRawFix &fix) const
+{
+  fix.time = time[i];
+  fix.latitude = latitude[i];
+  fix.longitude = longitude[i];
+  fix.pressure_altitude = pressure_altitude[i];
+  fix.gps_altitude = gps_altitude[i];
+}
+
+void
+IGCFixArray::Get(unsigned i, IGCFix &fix) const
+{
+  IGCRawFix raw;
+  GetRaw(i, raw);
+  IGCConvertFix(raw, fix);
+
+  fix.ClearExtensions();
+  for (unsigned j = 0; j < extensions.size(); ++j) {
+    const IGCExtension &extension = extensions[j];
+    if (extension.field != NULL)
+      fix.*extension.field = GetExtension(j, i);
+  }
+}
@@ -0,0 +1,120 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_IGC_FIX_ARRAY_HPP
+#define XCSOAR_IGC_FIX_ARRAY_HPP
+
+#include "Replay/IGCParser.hpp"
+#include "Compiler.h"
+
+#include <vector>
+
+#include <tchar.h>
+#include <stddef.h>
+
+/**
+ * All "B" records of an IGC file, decoded in one pass.  The fixes are
+ * stored as a structure of arrays of integers in the units of the
+ * file, which is compact and cheap to fill; Get() converts one of
+ * them to an #IGCFix.
+ */
+class IGCFixArray {
+  IGCHeader header;
+  bool header_available;
+
+  BrokenDate date;
+  bool date_available;
+
+  IGCExtensions extensions;
+
+  std::vector<unsigned> time;
+  std::vector<int> latitude, longitude;
+  std::vector<int> pressure_altitude, gps_altitude;
+
+  /**
+   * The extension values, one row of extensions.size() values per
+   * fix.
+   */
+  std::vector<int> extension_values;
+
+public:
+  IGCFixArray();
+
+  void Clear();
+
+  /**
+   * Memory-map the file and decode it with Parse().
+   *
+   * @return false if the file could not be opened
+   */
+  bool Load(const TCHAR *path);
+
+  /**
+   * Decode the contents of an IGC file, appending all valid "B"
+   * records.  The data does not need to be null-terminated.
+   */
+  void Parse(const char *data, size_t length);
+
+  const IGCHeader *GetHeader() const {
+    return header_available ? &header : NULL;
+  }
+
+  const BrokenDate *GetDate() const {
+    return date_available ? &date : NULL;
+  }
+
+  const IGCExtensions &GetExtensions() const {
+    return extensions;
+  }
+
+  unsigned size() const {
+    return time.size();
+  }
+
+  bool empty() const {
+    return time.empty();
+  }
+
+  /**
+   * Returns the second of day (UTC) of the specified fix.
+   */
+  unsigned GetTime(unsigned i) const {
+    return time[i];
+  }
+
+  /**
+   * Returns the value of an extension column (see
+   * IGCExtensions::Find()), or -1 if it was not recorded.
+   */
+  int GetExtension(unsigned column, unsigned i) const {
+    return extension_values[i * extensions.size() + column];
+  }
+
+  void GetRaw(unsigned i, IGCRawFix &fix) const;
+
+  void Get(unsigned i, IGCFix &fix) const;
+
+private:
+  void ParseLine(const char *line, size_t length);
+};
+
+#endif
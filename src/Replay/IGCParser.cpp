@@ -102,47 +102,222 @@ IGCParseDate(const char *line, BrokenDate &date)
   return date.Plausible();
 }
 
+/**
+ * Parse a fixed number of decimal digits.  Unlike sscanf() and
+ * strtoul(), this skips no whitespace and accepts no sign, which is
+ * what the fixed-width IGC fields need.  A null terminator is not a
+ * digit, so this never reads past the end of a C string.
+ */
+static inline bool
+ReadDecimal(const char *p, unsigned n, unsigned &value_r)
+{
+  unsigned value = 0;
+  for (const char *end = p + n; p != end; ++p) {
+    const unsigned digit = (unsigned char)*p - '0';
+    if (digit >= 10)
+      return false;
+
+    value = value * 10 + digit;
+  }
+
+  value_r = value;
+  return true;
+}
+
+/**
+ * Parse a 5 character altitude field, which may be negative (e.g.
+ * "-0012").
+ */
+static inline bool
+ReadAltitude(const char *p, int &value_r)
+{
+  unsigned value;
+  if (*p == '-') {
+    if (!ReadDecimal(p + 1, 4, value))
+      return false;
+
+    value_r = -(int)value;
+  } else {
+    if (!ReadDecimal(p, 5, value))
+      return false;
+
+    value_r = (int)value;
+  }
+
+  return true;
+}
+
+int
+IGCExtensions::Find(const char *code) const
+{
+  for (unsigned i = 0; i < size(); ++i)
+    if (memcmp((*this)[i].code, code, 3) == 0)
+      return i;
+
+  return -1;
+}
+
+static const struct {
+  char code[4];
+  int IGCFix::*field;
+} known_extensions[] = {
+  { "ENL", &IGCFix::enl },
+  { "RPM", &IGCFix::rpm },
+  { "TRT", &IGCFix::trt },
+  { "GSP", &IGCFix::gsp },
+  { "TAS", &IGCFix::tas },
+  { "IAS", &IGCFix::ias },
+  { "SIU", &IGCFix::siu },
+  { "FXA", &IGCFix::fxa },
+};
+
 bool
-IGCParseFix(const char *buffer, IGCFix &fix)
+IGCParseExtensions(const char *line, IGCExtensions &extensions)
+{
+  /* sample: "I033638FXA3940SIU4143ENL" */
+
+  unsigned count;
+  if (line[0] != 'I' || !ReadDecimal(line + 1, 2, count))
+    return false;
+
+  extensions.clear();
+  line += 3;
+
+  for (unsigned i = 0; i < count; ++i, line += 7) {
+    unsigned start, finish;
+    if (!ReadDecimal(line, 2, start) || !ReadDecimal(line + 2, 2, finish) ||
+        line[4] == 0 || line[5] == 0 || line[6] == 0)
+      return false;
+
+    /* the first extension cannot start before byte 36, which
+       follows the mandatory fields */
+    if (start < 36 || finish < start || extensions.full())
+      continue;
+
+    IGCExtension &extension = extensions.append();
+    extension.start = start - 1;
+    extension.length = finish - start + 1;
+    memcpy(extension.code, line + 4, 3);
+    extension.code[3] = 0;
+
+    extension.field = NULL;
+    for (unsigned j = 0; j < sizeof(known_extensions) / sizeof(known_extensions[0]); ++j)
+      if (memcmp(known_extensions[j].code, extension.code, 3) == 0)
+        extension.field = known_extensions[j].field;
+  }
+
+  return true;
+}
+
+bool
+IGCDecodeFix(const char *line, size_t length, IGCRawFix &fix)
 {
-  int DegLat, DegLon;
-  int MinLat, MinLon;
-  char NoS, EoW;
-  int iAltitude, iPressureAltitude;
-  int Hour = 0;
-  int Minute = 0;
-  int Second = 0;
-  int lfound =
-      sscanf(buffer, "B%02d%02d%02d%02d%05d%c%03d%05d%cA%05d%05d",
-      &Hour, &Minute, &Second, &DegLat, &MinLat, &NoS, &DegLon,
-      &MinLon, &EoW, &iPressureAltitude, &iAltitude);
-
-  if (lfound == EOF)
+  /* sample: "B1122385103117N00742367EA0049000487"; the fields are at
+     fixed positions */
+
+  if (length < 35 || line[0] != 'B')
     return false;
 
-  if (lfound != 11)
+  unsigned hour, minute, second;
+  if (!ReadDecimal(line + 1, 2, hour) ||
+      !ReadDecimal(line + 3, 2, minute) ||
+      !ReadDecimal(line + 5, 2, second))
     return false;
 
-  fixed Latitude = fixed(DegLat) + fixed(MinLat) / 60000;
-  if (NoS == 'S')
-    Latitude = -Latitude;
+  unsigned lat_degrees, lat_minutes, lon_degrees, lon_minutes;
+  if (!ReadDecimal(line + 7, 2, lat_degrees) ||
+      !ReadDecimal(line + 9, 5, lat_minutes) ||
+      (line[14] != 'N' && line[14] != 'S') ||
+      !ReadDecimal(line + 15, 3, lon_degrees) ||
+      !ReadDecimal(line + 18, 5, lon_minutes) ||
+      (line[23] != 'E' && line[23] != 'W'))
+    return false;
+
+  /* only "A" (3D) fixes are used */
+  if (line[24] != 'A')
+    return false;
+
+  if (!ReadAltitude(line + 25, fix.pressure_altitude) ||
+      !ReadAltitude(line + 30, fix.gps_altitude))
+    return false;
 
-  fixed Longitude = fixed(DegLon) + fixed(MinLon) / 60000;
-  if (EoW == 'W')
-    Longitude = -Longitude;
+  fix.time = hour * 3600 + minute * 60 + second;
 
-  fix.location.Latitude = Angle::degrees(Latitude);
-  fix.location.Longitude = Angle::degrees(Longitude);
+  fix.latitude = lat_degrees * 60000 + lat_minutes;
+  if (line[14] == 'S')
+    fix.latitude = -fix.latitude;
 
-  fix.gps_altitude = fixed(iAltitude);
-  fix.pressure_altitude = fixed(iPressureAltitude);
+  fix.longitude = lon_degrees * 60000 + lon_minutes;
+  if (line[23] == 'W')
+    fix.longitude = -fix.longitude;
 
   // some loggers drop out GPS altitude, so when this happens, revert
   // to pressure altitude
-  if ((iPressureAltitude != 0) && (iAltitude==0)) {
+  if (fix.pressure_altitude != 0 && fix.gps_altitude == 0)
     fix.gps_altitude = fix.pressure_altitude;
+
+  return true;
+}
+
+int
+IGCDecodeExtension(const char *line, size_t length,
+                   const IGCExtension &extension)
+{
+  unsigned value;
+  if (extension.start + extension.length > length ||
+      !ReadDecimal(line + extension.start, extension.length, value))
+    return -1;
+
+  return value;
+}
+
+/**
+ * Convert 1/1000 arc minutes to degrees.
+ */
+static fixed
+ConvertAngle(int value)
+{
+  const unsigned absolute = value < 0 ? -value : value;
+  const fixed degrees = fixed(absolute / 60000) +
+    fixed(absolute % 60000) / 60000;
+  return value < 0 ? -degrees : degrees;
+}
+
+void
+IGCConvertFix(const IGCRawFix &raw, IGCFix &fix)
+{
+  fix.time = BrokenTime(raw.time / 3600, (raw.time / 60) % 60,
+                        raw.time % 60);
+  fix.location.Latitude = Angle::degrees(ConvertAngle(raw.latitude));
+  fix.location.Longitude = Angle::degrees(ConvertAngle(raw.longitude));
+  fix.pressure_altitude = fixed(raw.pressure_altitude);
+  fix.gps_altitude = fixed(raw.gps_altitude);
+}
+
+bool
+IGCParseFix(const char *buffer, const IGCExtensions &extensions,
+            IGCFix &fix)
+{
+  const size_t length = strlen(buffer);
+
+  IGCRawFix raw;
+  if (!IGCDecodeFix(buffer, length, raw))
+    return false;
+
+  IGCConvertFix(raw, fix);
+
+  fix.ClearExtensions();
+  for (unsigned i = 0; i < extensions.size(); ++i) {
+    const IGCExtension &extension = extensions[i];
+    if (extension.field != NULL)
+      fix.*extension.field = IGCDecodeExtension(buffer, length, extension);
   }
 
-  fix.time = BrokenTime(Hour, Minute, Second);
   return true;
 }
+
+bool
+IGCParseFix(const char *buffer, IGCFix &fix)
+{
+  return IGCParseFix(buffer, IGCExtensions(), fix);
+}
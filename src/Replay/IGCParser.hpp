@@ -25,11 +25,14 @@ Copyright_License {
 #define XCSOAR_IGC_PARSER_HPP
 
 #include "Util/StaticString.hpp"
+#include "Util/StaticArray.hpp"
 #include "Math/fixed.hpp"
 #include "Engine/Navigation/GeoPoint.hpp"
 #include "DateTime.hpp"
+#include "Compiler.h"
 
 #include <tchar.h>
+#include <stddef.h>
 
 struct IGCHeader {
   /**
@@ -54,6 +57,74 @@ struct IGCFix {
   GeoPoint location;
 
   fixed gps_altitude, pressure_altitude;
+
+  /**
+   * Values of well-known "B" record extensions (declared by the "I"
+   * record), in the units of the IGC file.  -1 means the value was
+   * not recorded.
+   */
+  int enl, rpm, trt, gsp, tas, ias, siu, fxa;
+
+  void ClearExtensions() {
+    enl = rpm = trt = gsp = tas = ias = siu = fxa = -1;
+  }
+};
+
+/**
+ * One optional field appended to each "B" record, as declared by the
+ * "I" record.
+ */
+struct IGCExtension {
+  /**
+   * The position of the field in the "B" record (0-based, unlike the
+   * 1-based columns in the "I" record).
+   */
+  unsigned start;
+
+  /**
+   * The number of digits.
+   */
+  unsigned length;
+
+  /**
+   * 3-letter code, e.g. "ENL".
+   */
+  char code[4];
+
+  /**
+   * The #IGCFix attribute this extension is stored in, or NULL if
+   * the code is not known.
+   */
+  int IGCFix::*field;
+};
+
+struct IGCExtensions : public StaticArray<IGCExtension, 16> {
+  /**
+   * Returns the index of the extension with the specified code, or
+   * -1 if there is none.
+   */
+  gcc_pure
+  int Find(const char *code) const;
+};
+
+/**
+ * The mandatory fields of an IGC "B" record, as integers in the units
+ * of the file.  This is the compact form used for bulk decoding; see
+ * #IGCFixArray.
+ */
+struct IGCRawFix {
+  /**
+   * Second of day (UTC).
+   */
+  unsigned time;
+
+  /**
+   * Latitude and longitude in 1/1000 arc minutes, negative for south
+   * and west.
+   */
+  int latitude, longitude;
+
+  int pressure_altitude, gps_altitude;
 };
 
 /**
@@ -72,6 +143,44 @@ IGCParseHeader(const char *line, IGCHeader &header);
 bool
 IGCParseDate(const char *line, BrokenDate &date);
 
+/**
+ * Parse an IGC "I" record, which declares the extensions of all
+ * following "B" records.
+ *
+ * @return true on success, false if the line was not recognized
+ */
+bool
+IGCParseExtensions(const char *line, IGCExtensions &extensions);
+
+/**
+ * Decode the mandatory fields of an IGC "B" record.  The line does
+ * not need to be null-terminated.
+ *
+ * @param length the length of the line, not including the line
+ * terminator
+ * @return true on success, false if the line was not recognized
+ */
+bool
+IGCDecodeFix(const char *line, size_t length, IGCRawFix &fix);
+
+/**
+ * Decode one extension value of a "B" record.
+ *
+ * @return the value, or -1 if the record is too short or the field is
+ * malformed
+ */
+gcc_pure
+int
+IGCDecodeExtension(const char *line, size_t length,
+                   const IGCExtension &extension);
+
+/**
+ * Convert a decoded "B" record to an #IGCFix.  The extension fields
+ * are not touched.
+ */
+void
+IGCConvertFix(const IGCRawFix &raw, IGCFix &fix);
+
 /**
  * Parse an IGC "B" record.
  *
@@ -80,4 +189,13 @@ IGCParseDate(const char *line, BrokenDate &date);
 bool
 IGCParseFix(const char *buffer, IGCFix &fix);
 
+/**
+ * Parse an IGC "B" record, including the specified extensions.
+ *
+ * @return true on success, false if the line was not recognized
+ */
+bool
+IGCParseFix(const char *buffer, const IGCExtensions &extensions,
+            IGCFix &fix);
+
 #endif
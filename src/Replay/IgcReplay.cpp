@@ -32,28 +32,19 @@
 IgcReplay::IgcReplay() :
   AbstractReplay(),
   cli(fixed(0.98)),
-  reader(NULL)
+  next_fix(0)
 {
   FileName[0] = _T('\0');
 }
 
-bool
-IgcReplay::ScanBuffer(const char *buffer, IGCFix &fix)
-{
-  return IGCParseFix(buffer, fix);
-}
-
 bool
 IgcReplay::ReadPoint(IGCFix &fix)
 {
-  char *buffer;
-
-  while ((buffer = reader->read()) != NULL) {
-    if (ScanBuffer(buffer, fix))
-      return true;
-  }
+  if (next_fix >= fixes.size())
+    return false;
 
-  return false;
+  fixes.Get(next_fix++, fix);
+  return true;
 }
 
 bool
@@ -156,25 +147,17 @@ IgcReplay::Update()
 bool
 IgcReplay::OpenFile()
 {
-  if (reader)
-    return true;
-
   if (string_is_empty(FileName))
     return false;
 
-  reader = new FileLineReaderA(FileName);
-  if (!reader->error())
-    return true;
-
-  return false;
+  fixes.Clear();
+  next_fix = 0;
+  return fixes.Load(FileName);
 }
 
 void
 IgcReplay::CloseFile()
 {
-  if (!reader)
-    return;
-
-  delete reader;
-  reader = NULL;
+  fixes.Clear();
+  next_fix = 0;
 }
@@ -27,7 +27,7 @@ Copyright_License {
 #include "Math/fixed.hpp"
 #include "AbstractReplay.hpp"
 #include "Replay/CatmullRomInterpolator.hpp"
-#include "IO/FileLineReader.hpp"
+#include "Replay/IGCFixArray.hpp"
 
 #include <tchar.h>
 #include <windef.h> /* for MAX_PATH */
@@ -42,7 +42,17 @@ class IgcReplay: public AbstractReplay
   CatmullRomInterpolator cli;
 
   TCHAR FileName[MAX_PATH];
-  FileLineReaderA *reader;
+
+  /**
+   * The fixes of the file being replayed, decoded by OpenFile().
+   */
+  IGCFixArray fixes;
+
+  /**
+   * The index of the next fix in #fixes.  Only valid while
+   * #Enabled.
+   */
+  unsigned next_fix;
 
 protected:
   fixed t_simulation;
@@ -67,8 +77,6 @@ protected:
                           const fixed speed, const Angle bearing,
                           const fixed alt, const fixed baroalt, const fixed t) = 0;
 
-  bool ScanBuffer(const char *buffer, IGCFix &fix);
-
   bool ReadPoint(IGCFix &fix);
 
 private:
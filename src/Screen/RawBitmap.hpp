@@ -160,6 +160,17 @@ public:
 #endif
   }
 
+  /**
+   * Returns a pointer to the specified row, counting from the top.
+   */
+  BGRColor *GetRow(unsigned y) {
+#ifndef USE_GDI
+    return buffer + y * corrected_width;
+#else
+    return buffer + (height - 1 - y) * corrected_width;
+#endif
+  }
+
   /**
    * Returns a pointer to the row below the current one.
    */
@@ -203,7 +214,12 @@ public:
     return height;
   }
 
+  /**
+   * Stretch the top left part of the bitmap to the specified
+   * rectangle of the #Canvas.  The position may be negative.
+   */
   void stretch_to(unsigned width, unsigned height, Canvas &dest_canvas,
+                  int dest_x, int dest_y,
                   unsigned dest_width, unsigned dest_height) const {
 #ifdef ENABLE_OPENGL
     texture->bind();
@@ -224,23 +240,23 @@ public:
 
     OpenGL::glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
     GLEnable scope(GL_TEXTURE_2D);
-    dest_canvas.stretch(0, 0, dest_width, dest_height,
+    dest_canvas.stretch(dest_x, dest_y, dest_width, dest_height,
                         *texture, 0, 0, width, height);
 #elif defined(ENABLE_SDL)
     Canvas src_canvas(surface);
-    dest_canvas.stretch(0, 0, dest_width, dest_height,
+    dest_canvas.stretch(dest_x, dest_y, dest_width, dest_height,
                         src_canvas, 0, 0, width, height);
 #elif defined(_WIN32_WCE) && _WIN32_WCE < 0x0400
     /* StretchDIBits() is bugged on PPC2002, workaround follows */
     HDC source_dc = ::CreateCompatibleDC(dest_canvas);
     ::SelectObject(source_dc, bitmap);
-    ::StretchBlt(dest_canvas, 0, 0,
+    ::StretchBlt(dest_canvas, dest_x, dest_y,
                  dest_width, dest_height,
                  source_dc, 0, 0, width, height,
                  SRCCOPY);
     ::DeleteDC(source_dc);
 #else
-    ::StretchDIBits(dest_canvas, 0, 0,
+    ::StretchDIBits(dest_canvas, dest_x, dest_y,
                     dest_width, dest_height,
                     0, GetHeight() - height, width, height,
                     buffer, &bi, DIB_RGB_COLORS, SRCCOPY);
@@ -24,9 +24,12 @@ Copyright_License {
 #include "HeightMatrix.hpp"
 #include "RasterMap.hpp"
 #include "WindowProjection.hpp"
+#include "Thread/ThreadPool.hpp"
 
 #include <algorithm>
+
 #include <assert.h>
+#include <stdlib.h>
 
 void
 HeightMatrix::SetSize(size_t _size)
@@ -53,6 +56,80 @@ HeightMatrix::SetSize(unsigned width, unsigned height,
           (height + quantisation_pixels - 1) / quantisation_pixels);
 }
 
+/**
+ * Scans rows or columns of a #HeightMatrix.  Cell (x,y) is sampled
+ * at the screen position (origin_x + x * quantisation_pixels,
+ * origin_y + y * quantisation_pixels).
+ */
+class HeightMatrixScanner : public ThreadPool::Job {
+  const RasterMap &map;
+  const WindowProjection &projection;
+  const unsigned quantisation_pixels;
+  const bool interpolate;
+
+  short *const data;
+  const unsigned width, height;
+
+  const int origin_x, origin_y;
+
+  /**
+   * The number of rows scanned by one call to RunPart().
+   */
+  const unsigned band_height;
+
+public:
+  HeightMatrixScanner(const RasterMap &_map,
+                      const WindowProjection &_projection,
+                      unsigned _quantisation_pixels, bool _interpolate,
+                      short *_data, unsigned _width, unsigned _height,
+                      int _origin_x, int _origin_y,
+                      unsigned _band_height)
+    :map(_map), projection(_projection),
+     quantisation_pixels(_quantisation_pixels), interpolate(_interpolate),
+     data(_data), width(_width), height(_height),
+     origin_x(_origin_x), origin_y(_origin_y),
+     band_height(_band_height) {}
+
+  unsigned GetBandCount() const {
+    return (height + band_height - 1) / band_height;
+  }
+
+  void ScanRows(unsigned start_row, unsigned end_row) const {
+    const int x0 = origin_x;
+    const int x1 = origin_x + width * quantisation_pixels;
+
+    for (unsigned row = start_row; row < end_row; ++row) {
+      const int y = origin_y + row * quantisation_pixels;
+      map.ScanLine(projection.ScreenToGeo(x0, y),
+                   projection.ScreenToGeo(x1, y),
+                   data + row * width, width, interpolate);
+    }
+  }
+
+  void ScanColumns(unsigned start_column, unsigned end_column) const {
+    const int y0 = origin_y;
+    const int y1 = origin_y + height * quantisation_pixels;
+
+    AllocatedArray<short> buffer(height);
+
+    for (unsigned column = start_column; column < end_column; ++column) {
+      const int x = origin_x + column * quantisation_pixels;
+      map.ScanLine(projection.ScreenToGeo(x, y0),
+                   projection.ScreenToGeo(x, y1),
+                   buffer.begin(), height, interpolate);
+
+      short *p = data + column;
+      for (unsigned row = 0; row < height; ++row, p += width)
+        *p = buffer[row];
+    }
+  }
+
+  virtual void RunPart(unsigned part) {
+    const unsigned start_row = part * band_height;
+    ScanRows(start_row, std::min(start_row + band_height, height));
+  }
+};
+
 void
 HeightMatrix::Fill(const RasterMap &map, const WindowProjection &projection,
                    unsigned quantisation_pixels, bool interpolate)
@@ -63,10 +140,84 @@ HeightMatrix::Fill(const RasterMap &map, const WindowProjection &projection,
   SetSize((screen_width + quantisation_pixels - 1) / quantisation_pixels,
           (screen_height + quantisation_pixels - 1) / quantisation_pixels);
 
-  for (unsigned y = 0; y < screen_height; y += quantisation_pixels) {
-    short *p = data.begin() + y * width / quantisation_pixels;
-    map.ScanLine(projection.ScreenToGeo(0, y),
-                 projection.ScreenToGeo(screen_width, y),
-                 p, width, interpolate);
+  HeightMatrixScanner scanner(map, projection, quantisation_pixels,
+                              interpolate, data.begin(), width, height,
+                              0, 0, height);
+  scanner.ScanRows(0, height);
+}
+
+void
+HeightMatrix::Fill(const RasterMap &map, const WindowProjection &projection,
+                   unsigned quantisation_pixels, bool interpolate,
+                   ThreadPool &pool)
+{
+  const unsigned screen_width = projection.GetScreenWidth();
+  const unsigned screen_height = projection.GetScreenHeight();
+
+  SetSize((screen_width + quantisation_pixels - 1) / quantisation_pixels,
+          (screen_height + quantisation_pixels - 1) / quantisation_pixels);
+
+  /* a few bands per thread, so a thread which finishes early (the
+     upper part of the screen may be outside of the terrain file) can
+     take over some of the work of the others */
+  const unsigned n_bands = pool.GetConcurrency() * 4;
+  const unsigned band_height = std::max((height + n_bands - 1) / n_bands,
+                                        1u);
+
+  HeightMatrixScanner scanner(map, projection, quantisation_pixels,
+                              interpolate, data.begin(), width, height,
+                              0, 0, band_height);
+  pool.Run(scanner, scanner.GetBandCount());
+}
+
+void
+HeightMatrix::Scroll(const RasterMap &map, const WindowProjection &projection,
+                     int origin_x, int origin_y,
+                     unsigned quantisation_pixels, bool interpolate,
+                     int dx, int dy)
+{
+  assert((unsigned)abs(dx) < width);
+  assert((unsigned)abs(dy) < height);
+
+  /* move the existing cells */
+
+  const unsigned row_length = width - abs(dx);
+  const unsigned dest_column = dx < 0 ? -dx : 0;
+  const unsigned src_column = dx > 0 ? dx : 0;
+
+  if (dy > 0) {
+    for (unsigned y = 0; y < height - dy; ++y)
+      std::copy(GetRow(y + dy) + src_column,
+                GetRow(y + dy) + src_column + row_length,
+                data.begin() + y * width + dest_column);
+  } else if (dy < 0) {
+    for (unsigned y = height - 1; y >= (unsigned)-dy; --y)
+      std::copy(GetRow(y + dy) + src_column,
+                GetRow(y + dy) + src_column + row_length,
+                data.begin() + y * width + dest_column);
+  } else if (dx != 0) {
+    for (unsigned y = 0; y < height; ++y) {
+      short *row = data.begin() + y * width;
+      if (dx > 0)
+        std::copy(row + src_column, row + width, row);
+      else
+        std::copy_backward(row, row + row_length, row + width);
+    }
   }
+
+  /* scan the exposed cells */
+
+  HeightMatrixScanner scanner(map, projection, quantisation_pixels,
+                              interpolate, data.begin(), width, height,
+                              origin_x, origin_y, height);
+
+  if (dy > 0)
+    scanner.ScanRows(height - dy, height);
+  else if (dy < 0)
+    scanner.ScanRows(0, -dy);
+
+  if (dx > 0)
+    scanner.ScanColumns(width - dx, width);
+  else if (dx < 0)
+    scanner.ScanColumns(0, -dx);
 }
@@ -30,6 +30,7 @@ Copyright_License {
 
 class RasterMap;
 class WindowProjection;
+class ThreadPool;
 
 class HeightMatrix : private NonCopyable {
   AllocatedArray<short> data;
@@ -50,6 +51,32 @@ public:
   void Fill(const RasterMap &map, const WindowProjection &map_projection,
             unsigned quantisation_pixels, bool interpolate);
 
+  /**
+   * Like Fill(), but split the matrix into horizontal bands which
+   * are scanned by the specified #ThreadPool.  The caller must hold a
+   * read lock on the #RasterMap.
+   */
+  void Fill(const RasterMap &map, const WindowProjection &map_projection,
+            unsigned quantisation_pixels, bool interpolate,
+            ThreadPool &pool);
+
+  /**
+   * Move the contents of the matrix, and scan only the cells which
+   * have become exposed.  Afterwards, cell (x,y) contains what was
+   * cell (x+dx, y+dy) before.
+   *
+   * @param projection the projection which was used to fill the
+   * matrix
+   * @param origin_x the screen position of the new cell (0,0) in
+   * #projection
+   * @param origin_y the screen position of the new cell (0,0) in
+   * #projection
+   */
+  void Scroll(const RasterMap &map, const WindowProjection &projection,
+              int origin_x, int origin_y,
+              unsigned quantisation_pixels, bool interpolate,
+              int dx, int dy);
+
   unsigned get_width() const {
     return width;
   }
@@ -87,6 +87,10 @@ public:
     data.Reset();
   }
 
+  void swap(RasterBuffer &other) {
+    data.Swap(other.data);
+  }
+
   void resize(unsigned _width, unsigned _height);
 
   gcc_pure
@@ -26,8 +26,10 @@ Copyright_License {
 #include "Geo/GeoClip.hpp"
 #include "OS/PathName.hpp"
 #include "IO/FileCache.hpp"
+#include "Util/Macros.hpp"
 
 #include <algorithm>
+#include <vector>
 #include <assert.h>
 #include <string.h>
 
@@ -61,6 +63,10 @@ RasterMap::RasterMap(const TCHAR *_path, const TCHAR *world_file,
     }
   }
 
+  if (cache != NULL)
+    /* keep decoded tiles on disk, to avoid decoding them again */
+    raster_tile_cache.OpenTileStore(*cache, _T("terrain_tiles"), _path);
+
   projection.set(raster_tile_cache.GetBounds(),
                  raster_tile_cache.GetWidth() * 256,
                  raster_tile_cache.GetHeight() * 256);
@@ -78,9 +84,18 @@ angle_to_pixel(Angle value, Angle start, Angle end, unsigned width)
 
 void
 RasterMap::SetViewCenter(const GeoPoint &location, fixed radius)
+{
+  if (PrepareTiles(location, radius)) {
+    LoadTiles();
+    PublishTiles();
+  }
+}
+
+bool
+RasterMap::PrepareTiles(const GeoPoint &location, fixed radius)
 {
   if (!raster_tile_cache.GetInitialised())
-    return;
+    return false;
 
   const GeoBounds &bounds = raster_tile_cache.GetBounds();
 
@@ -90,8 +105,8 @@ RasterMap::SetViewCenter(const GeoPoint &location, fixed radius)
   int y = angle_to_pixel(location.Latitude, bounds.north, bounds.south,
                          raster_tile_cache.GetHeight());
 
-  raster_tile_cache.UpdateTiles(path, x, y,
-                                projection.distance_pixels(radius) / 256);
+  return raster_tile_cache.PollTiles(x, y,
+                                     projection.distance_pixels(radius) / 256);
 }
 
 short
@@ -101,6 +116,26 @@ RasterMap::GetHeight(const GeoPoint &location) const
   return raster_tile_cache.GetHeight(pt.x, pt.y);
 }
 
+void
+RasterMap::GetHeights(const GeoPoint *locations, short *heights,
+                      unsigned n) const
+{
+  /* small batches are projected on the stack, larger ones all at
+     once so RasterTileCache::GetHeights() can group them by tile */
+  RasterLocation buffer[64];
+  std::vector<RasterLocation> allocated;
+  RasterLocation *projected = buffer;
+  if (n > ARRAY_SIZE(buffer)) {
+    allocated.resize(n);
+    projected = &allocated[0];
+  }
+
+  for (unsigned i = 0; i < n; ++i)
+    projected[i] = projection.project(locations[i]) >> 8;
+
+  raster_tile_cache.GetHeights(projected, heights, n);
+}
+
 short
 RasterMap::GetInterpolatedHeight(const GeoPoint &location) const
 {
@@ -59,8 +59,56 @@ public:
     return raster_tile_cache.GetBounds().center();
   }
 
+  const GeoBounds &GetBounds() const {
+    return raster_tile_cache.GetBounds();
+  }
+
+  /**
+   * The size of the whole raster [pixels]; together with the bounds,
+   * this describes the resolution of the terrain file.
+   */
+  unsigned GetRasterWidth() const {
+    return raster_tile_cache.GetWidth();
+  }
+
+  unsigned GetRasterHeight() const {
+    return raster_tile_cache.GetHeight();
+  }
+
   void SetViewCenter(const GeoPoint &location, fixed radius);
 
+  /**
+   * The first step of SetViewCenter(): determine which tiles need to
+   * be loaded.  The caller must hold an exclusive lock.
+   *
+   * @return true if LoadTiles() and PublishTiles() should be called
+   */
+  bool PrepareTiles(const GeoPoint &location, fixed radius);
+
+  /**
+   * The second step of SetViewCenter(): decode the tiles.  This is
+   * the expensive part, and it may run while other threads read from
+   * this object; see RasterTileCache::LoadTiles().
+   */
+  void LoadTiles() {
+    raster_tile_cache.LoadTiles(path);
+  }
+
+  /**
+   * The third step of SetViewCenter(): make the loaded tiles visible.
+   * The caller must hold an exclusive lock.
+   */
+  void PublishTiles() {
+    raster_tile_cache.PublishTiles();
+  }
+
+  /**
+   * @see RasterTileCache::GetSerial()
+   */
+  unsigned GetSerial() const {
+    return raster_tile_cache.GetSerial();
+  }
+
   /**
    * Determines if SetViewCenter() should be called again to continue
    * loading.
@@ -86,6 +134,17 @@ public:
   gcc_pure
   short GetHeight(const GeoPoint &location) const;
 
+  /**
+   * Determine the non-interpolated heights at many locations at once.
+   * This is cheaper than calling GetHeight() for each of them.
+   *
+   * @param locations the locations
+   * @param heights the destination buffer
+   * @param n the number of locations
+   */
+  void GetHeights(const GeoPoint *locations, short *heights,
+                  unsigned n) const;
+
   /**
    * Determine the interpolated height at the specified location.
    */
@@ -23,17 +23,19 @@ Copyright_License {
 
 #include "Terrain/RasterRenderer.hpp"
 #include "Terrain/RasterMap.hpp"
+#include "Terrain/SlopeShading.hpp"
 #include "Math/Earth.hpp"
-#include "Math/FastMath.h"
 #include "Screen/Ramp.hpp"
 #include "Screen/Layout.hpp"
 #include "WindowProjection.hpp"
 #include "Asset.hpp"
 
+#include <algorithm>
+
 #include <assert.h>
 #include <stdint.h>
-
-//#define FAST_RSQRT
+#include <stdlib.h>
+#include <string.h>
 
 static inline unsigned
 MIX(unsigned x, unsigned y, unsigned i)
@@ -62,11 +64,18 @@ TerrainShading(const short illum, uint8_t &r, uint8_t &g, uint8_t &b)
 
 RasterRenderer::RasterRenderer()
   :quantisation_pixels(2),
-   image(NULL)
+   image(NULL),
+   scan_map(NULL),
+   scroll_x(0), scroll_y(0),
+   image_valid(false)
 {
+  screen_offset.x = screen_offset.y = 0;
+
   // scale quantisation_pixels so resolution is not too high on large displays
   if (is_embedded())
     quantisation_pixels = Layout::FastScale(quantisation_pixels);
+
+  scan_pool.SetConcurrency(std::min(ThreadPool::GetProcessorCount(), 4u));
 }
 
 
@@ -75,6 +84,57 @@ RasterRenderer::~RasterRenderer()
   delete image;
 }
 
+/**
+ * Divide and round to the nearest integer (also for negative
+ * numbers).
+ */
+gcc_const
+static int
+RoundDivide(int a, int b)
+{
+  return a >= 0
+    ? (a + b / 2) / b
+    : -((-a + b / 2) / b);
+}
+
+bool
+RasterRenderer::CheckScroll(const RasterMap &map,
+                            const WindowProjection &projection,
+                            RasterPoint &new_offset,
+                            RasterPoint &new_screen_offset) const
+{
+  if (scan_map != &map || scan_serial != map.GetSerial() ||
+      projection.GetScreenWidth() != scan_projection.GetScreenWidth() ||
+      projection.GetScreenHeight() != scan_projection.GetScreenHeight() ||
+      projection.GetScale() != scan_projection.GetScale() ||
+      projection.GetScreenAngle() != scan_projection.GetScreenAngle())
+    /* not a pure translation, or the terrain has changed */
+    return false;
+
+  /* where has the old projection's origin moved to? */
+  const RasterPoint origin = projection.GeoToScreen(scan_projection.GetGeoLocation());
+  const RasterPoint &old_origin = scan_projection.GetScreenOrigin();
+
+  /* the new matrix origin, in cells of the old projection */
+  new_offset.x = RoundDivide(old_origin.x - origin.x, quantisation_pixels);
+  new_offset.y = RoundDivide(old_origin.y - origin.y, quantisation_pixels);
+
+  /* the part of the movement which was rounded away */
+  new_screen_offset.x = new_offset.x * (int)quantisation_pixels
+    - (old_origin.x - origin.x);
+  new_screen_offset.y = new_offset.y * (int)quantisation_pixels
+    - (old_origin.y - origin.y);
+
+  /* scan everything if the view has moved too far away from the
+     projection of the last full scan; this limits the error caused
+     by the rounding and by the projection's distortion */
+  const int width = height_matrix.get_width();
+  const int height = height_matrix.get_height();
+  return abs(new_offset.x) < width && abs(new_offset.y) < height &&
+    abs(new_offset.x - scan_offset.x) < width &&
+    abs(new_offset.y - scan_offset.y) < height;
+}
+
 void
 RasterRenderer::ScanMap(const RasterMap &map, const WindowProjection &projection)
 {
@@ -107,7 +167,38 @@ RasterRenderer::ScanMap(const RasterMap &map, const WindowProjection &projection
     /* disable slope shading when zoomed out very far (too tiny) */
     quantisation_effective = 0;
 
-  height_matrix.Fill(map, projection, quantisation_pixels, true);
+  RasterPoint new_offset;
+  if (CheckScroll(map, projection, new_offset, screen_offset)) {
+    /* the view was only moved: reuse the existing heights */
+    const int dx = new_offset.x - scan_offset.x;
+    const int dy = new_offset.y - scan_offset.y;
+    if (dx == 0 && dy == 0)
+      return;
+
+    scan_offset = new_offset;
+    height_matrix.Scroll(map, scan_projection,
+                         scan_offset.x * (int)quantisation_pixels,
+                         scan_offset.y * (int)quantisation_pixels,
+                         quantisation_pixels, true, dx, dy);
+
+    if (scroll_x != 0 || scroll_y != 0)
+      /* GenerateImage() has not been called since the last scroll;
+         the bookkeeping is not worth it, redraw everything */
+      image_valid = false;
+
+    scroll_x = dx;
+    scroll_y = dy;
+    return;
+  }
+
+  height_matrix.Fill(map, projection, quantisation_pixels, true, scan_pool);
+
+  scan_map = &map;
+  scan_serial = map.GetSerial();
+  scan_projection = projection;
+  scan_offset.x = scan_offset.y = 0;
+  screen_offset.x = screen_offset.y = 0;
+  image_valid = false;
 }
 
 void
@@ -122,30 +213,201 @@ RasterRenderer::GenerateImage(bool do_shading,
     delete image;
     image = new RawBitmap(height_matrix.get_width(),
                           height_matrix.get_height());
+    image_valid = false;
   }
 
   if (quantisation_effective == 0)
     do_shading = false;
 
+  const unsigned height_slope_factor = max(1, (int)pixel_size);
+
+  if (image_valid &&
+      do_shading == image_do_shading &&
+      height_scale == image_height_scale &&
+      (!do_shading ||
+       (contrast == image_contrast && brightness == image_brightness &&
+        sunazimuth == image_sunazimuth &&
+        quantisation_effective == image_quantisation_effective &&
+        height_slope_factor == image_height_slope_factor))) {
+    /* only the view has moved since the last call: move the image
+       and generate only the exposed parts */
+    GenerateScrolledImage(do_shading, height_scale, contrast, brightness,
+                          sunazimuth);
+    scroll_x = scroll_y = 0;
+    return;
+  }
+
+  PixelRect rc;
+  rc.left = 0;
+  rc.top = 0;
+  rc.right = height_matrix.get_width();
+  rc.bottom = height_matrix.get_height();
+  GenerateImage(do_shading, height_scale, contrast, brightness, sunazimuth,
+                rc);
+
+  image_valid = true;
+  image_do_shading = do_shading;
+  image_height_scale = height_scale;
+  image_contrast = contrast;
+  image_brightness = brightness;
+  image_sunazimuth = sunazimuth;
+  image_quantisation_effective = quantisation_effective;
+  image_height_slope_factor = height_slope_factor;
+  scroll_x = scroll_y = 0;
+}
+
+void
+RasterRenderer::GenerateImage(bool do_shading, unsigned height_scale,
+                              int contrast, int brightness,
+                              const Angle sunazimuth, const PixelRect &rc)
+{
+  if (rc.left >= rc.right || rc.top >= rc.bottom)
+    return;
+
   if (do_shading)
     GenerateSlopeImage(height_scale, contrast, brightness,
-                       sunazimuth);
+                       sunazimuth, rc);
   else
-    GenerateUnshadedImage(height_scale);
+    GenerateUnshadedImage(height_scale, rc);
+}
+
+/**
+ * Move the contents of the bitmap: afterwards, pixel (x,y) contains
+ * what was pixel (x+dx, y+dy) before.
+ */
+static void
+ScrollBitmap(RawBitmap &bitmap, unsigned width, unsigned height,
+             int dx, int dy)
+{
+  assert((unsigned)abs(dx) < width);
+  assert((unsigned)abs(dy) < height);
+
+  const unsigned row_length = width - abs(dx);
+  const unsigned dest_column = dx < 0 ? -dx : 0;
+  const unsigned src_column = dx > 0 ? dx : 0;
+
+  if (dy > 0) {
+    for (unsigned y = 0; y < height - dy; ++y)
+      memcpy(bitmap.GetRow(y) + dest_column,
+             bitmap.GetRow(y + dy) + src_column,
+             row_length * sizeof(BGRColor));
+  } else if (dy < 0) {
+    for (unsigned y = height - 1; y >= (unsigned)-dy; --y)
+      memcpy(bitmap.GetRow(y) + dest_column,
+             bitmap.GetRow(y + dy) + src_column,
+             row_length * sizeof(BGRColor));
+  } else if (dx != 0) {
+    for (unsigned y = 0; y < height; ++y) {
+      BGRColor *row = bitmap.GetRow(y);
+      memmove(row + dest_column, row + src_column,
+              row_length * sizeof(BGRColor));
+    }
+  }
 }
 
 void
-RasterRenderer::GenerateUnshadedImage(unsigned height_scale)
+RasterRenderer::GenerateScrolledImage(bool do_shading, unsigned height_scale,
+                                      int contrast, int brightness,
+                                      const Angle sunazimuth)
+{
+  const int width = height_matrix.get_width();
+  const int height = height_matrix.get_height();
+
+  ScrollBitmap(*image, width, height, scroll_x, scroll_y);
+
+  /* the slope shading of a pixel depends on its neighbours, and near
+     the border, it is calculated differently; regenerate those
+     pixels, too */
+  const int margin = do_shading ? quantisation_effective : 0;
+
+  PixelRect rc;
+
+  /* exposed rows */
+  if (scroll_y != 0) {
+    rc.left = 0;
+    rc.right = width;
+    if (scroll_y > 0) {
+      rc.top = std::max(height - scroll_y - margin, 0);
+      rc.bottom = height;
+    } else {
+      rc.top = 0;
+      rc.bottom = std::min(-scroll_y + margin, height);
+    }
+
+    GenerateImage(do_shading, height_scale, contrast, brightness,
+                  sunazimuth, rc);
+  }
+
+  /* exposed columns */
+  if (scroll_x != 0) {
+    rc.top = 0;
+    rc.bottom = height;
+    if (scroll_x > 0) {
+      rc.left = std::max(width - scroll_x - margin, 0);
+      rc.right = width;
+    } else {
+      rc.left = 0;
+      rc.right = std::min(-scroll_x + margin, width);
+    }
+
+    GenerateImage(do_shading, height_scale, contrast, brightness,
+                  sunazimuth, rc);
+  }
+
+  if (margin > 0) {
+    /* the other borders */
+
+    if (scroll_y >= 0) {
+      rc.left = 0;
+      rc.right = width;
+      rc.top = 0;
+      rc.bottom = std::min(margin, height);
+      GenerateImage(do_shading, height_scale, contrast, brightness,
+                    sunazimuth, rc);
+    }
+
+    if (scroll_y <= 0) {
+      rc.left = 0;
+      rc.right = width;
+      rc.top = std::max(height - margin, 0);
+      rc.bottom = height;
+      GenerateImage(do_shading, height_scale, contrast, brightness,
+                    sunazimuth, rc);
+    }
+
+    if (scroll_x >= 0) {
+      rc.left = 0;
+      rc.right = std::min(margin, width);
+      rc.top = 0;
+      rc.bottom = height;
+      GenerateImage(do_shading, height_scale, contrast, brightness,
+                    sunazimuth, rc);
+    }
+
+    if (scroll_x <= 0) {
+      rc.left = std::max(width - margin, 0);
+      rc.right = width;
+      rc.top = 0;
+      rc.bottom = height;
+      GenerateImage(do_shading, height_scale, contrast, brightness,
+                    sunazimuth, rc);
+    }
+  }
+
+  image->SetDirty();
+}
+
+void
+RasterRenderer::GenerateUnshadedImage(unsigned height_scale,
+                                      const PixelRect &rc)
 {
-  const short *src = height_matrix.GetData();
   const BGRColor *oColorBuf = color_table + 64 * 256;
-  BGRColor *dest = image->GetTopRow();
 
-  for (unsigned y = height_matrix.get_height(); y > 0; --y) {
-    BGRColor *p = dest;
-    dest = image->GetNextRow(dest);
+  for (int y = rc.top; y < rc.bottom; ++y) {
+    const short *src = height_matrix.GetRow(y) + rc.left;
+    BGRColor *p = image->GetRow(y) + rc.left;
 
-    for (unsigned x = height_matrix.get_width(); x > 0; --x) {
+    for (int x = rc.left; x < rc.right; ++x) {
       short h = *src++;
       if (gcc_likely(!RasterBuffer::is_special(h))) {
         if (h < 0)
@@ -174,7 +436,8 @@ RasterRenderer::GenerateUnshadedImage(unsigned height_scale)
 void
 RasterRenderer::GenerateSlopeImage(unsigned height_scale,
                                    int contrast,
-                                   const int sx, const int sy, const int sz)
+                                   const int sx, const int sy, const int sz,
+                                   const PixelRect &rc)
 {
   assert(quantisation_effective > 0);
 
@@ -186,21 +449,19 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
 
   const unsigned height_slope_factor = max(1, (int)pixel_size);
 
-  const short *src = height_matrix.GetData();
+  /* the interior columns have both X samples inside the matrix; their
+     slope is calculated by SlopeShadingRow() for the whole row at
+     once */
+  const int interior_left = std::max(rc.left, border.left);
+  const int interior_right = std::min(rc.right, border.right);
+  const unsigned interior_width = interior_right > interior_left
+    ? interior_right - interior_left
+    : 0;
+  slope_buffer.grow_discard(interior_width);
+
   const BGRColor *oColorBuf = color_table + 64 * 256;
-#ifdef FAST_RSQRT
-  const short szindex = sz*contrast/128;
-  const short sval_min = szindex-64;
-  const short sval_max = szindex+63;
-  const BGRColor *szColorBuf = color_table + (64- szindex) * 256;
-  const int sx_c = sx*contrast>>7;
-  const int sy_c = sy*contrast>>7;
-  const int sz_c = sz*contrast>>7;
-#endif
-
-  BGRColor *dest = image->GetTopRow();
-
-  for (unsigned y = 0; y < height_matrix.get_height(); ++y) {
+
+  for (unsigned y = rc.top; y < (unsigned)rc.bottom; ++y) {
     const unsigned row_plus_index = y < (unsigned)border.bottom
       ? quantisation_effective
       : height_matrix.get_height() - 1 - y;
@@ -212,10 +473,24 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
 
     const unsigned p31 = row_plus_index + row_minus_index;
 
-    BGRColor *p = dest;
-    dest = image->GetNextRow(dest);
+    const short *src = height_matrix.GetRow(y);
+
+    // Y direction
+    assert(src - row_minus_offset >= height_matrix.GetData());
+    assert(src + height_matrix.get_width() - 1 + row_plus_offset <
+           height_matrix.GetDataEnd());
 
-    for (unsigned x = 0; x < height_matrix.get_width(); ++x, ++src) {
+    if (interior_width > 0)
+      SlopeShadingRow(slope_buffer.begin(), src + interior_left,
+                      interior_width,
+                      row_minus_offset, row_plus_offset,
+                      quantisation_effective, p31, height_slope_factor,
+                      sx, sy, sz, contrast);
+
+    BGRColor *p = image->GetRow(y) + rc.left;
+    src += rc.left;
+
+    for (unsigned x = rc.left; x < (unsigned)rc.right; ++x, ++src) {
       short h = *src;
       if (gcc_likely(!RasterBuffer::is_special(h))) {
         if (h < 0)
@@ -225,11 +500,11 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
 
         // no need to calculate slope if undefined height or sea level
 
-        // Y direction
-        assert(src - row_minus_offset >= height_matrix.GetData());
-        assert(src + row_plus_offset >= height_matrix.GetData());
-        assert(src - row_minus_offset < height_matrix.GetDataEnd());
-        assert(src + row_plus_offset < height_matrix.GetDataEnd());
+        if (gcc_likely(x >= (unsigned)interior_left &&
+                       x < (unsigned)interior_right)) {
+          *p++ = oColorBuf[h + 256 * slope_buffer[x - interior_left]];
+          continue;
+        }
 
         // X direction
 
@@ -259,39 +534,12 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
           continue;
         }
 
-        const int p32 = h_above - h_below;
-        const int p22 = h_right - h_left;
-
         const unsigned p20 = column_plus_index + column_minus_index;
-
-        const int dd0 = p22 * p31;
-        const int dd1 = p20 * p32;
-        const int dd2 = p20 * p31 * height_slope_factor;
-#ifndef FAST_RSQRT
-        const int num = (dd2 * sz + dd0 * sx + dd1 * sy);
-        const int mag = (dd0 * dd0 + dd1 * dd1 + dd2 * dd2);
-#ifdef FIXED_MATH
-        const int sval = num / (int)isqrt4(mag);
-#else
-        const int sval = num / (int)sqrt((fixed)mag);
-#endif
-        int sindex = (sval - sz) * contrast / 128;
-        if (gcc_unlikely(sindex < -64))
-          sindex = -64;
-        if (gcc_unlikely(sindex > 63))
-          sindex = 63;
-        *p++ = oColorBuf[h + 256*sindex];
-#else
-        const int num = (dd2 * sz_c + dd0 * sx_c + dd1 * sy_c);
-        const int sval = i_normalise_mag3(num, dd0, dd1, dd2);
-        if (gcc_unlikely(sval<=sval_min))
-          *p++ = color_table[h];
-        else if (gcc_unlikely(sval >= sval_max))
-          *p++ = color_table[h + 127*256];
-        else
-          *p++ = szColorBuf[h + (sval*256)];
-
-#endif
+        const int sindex = SlopeShadingIndex(h_right - h_left,
+                                             h_above - h_below,
+                                             p20, p31, height_slope_factor,
+                                             sx, sy, sz, contrast);
+        *p++ = oColorBuf[h + 256 * sindex];
       } else if (RasterBuffer::is_water(h)) {
         // we're in the water, so look up the color for water
         *p++ = oColorBuf[255];
@@ -308,7 +556,8 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
 void
 RasterRenderer::GenerateSlopeImage(unsigned height_scale,
                                    int contrast, int brightness,
-                                   const Angle sunazimuth)
+                                   const Angle sunazimuth,
+                                   const PixelRect &rc)
 {
   const Angle fudgeelevation =
     Angle::degrees(fixed(10.0 + 80.0 * brightness / 255.0));
@@ -318,13 +567,15 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
   const int sz = (int)(255 * fudgeelevation.fastsine());
 
   GenerateSlopeImage(height_scale, contrast,
-                     sx, sy, sz);
+                     sx, sy, sz, rc);
 }
 
 void
 RasterRenderer::ColorTable(const ColorRamp *color_ramp, bool do_water,
                            unsigned height_scale, int interp_levels)
 {
+  image_valid = false;
+
   for (int i = 0; i < 256; i++) {
     for (int mag = -64; mag < 64; mag++) {
       uint8_t r, g, b;
@@ -27,12 +27,17 @@ Copyright_License {
 #include "Terrain/HeightMatrix.hpp"
 #include "Screen/RawBitmap.hpp"
 #include "Util/NonCopyable.hpp"
+#include "Util/AllocatedArray.hpp"
+#include "Thread/ThreadPool.hpp"
+#include "Screen/Point.hpp"
+#include "WindowProjection.hpp"
+
+#include <stdint.h>
 
 #define NUM_COLOR_RAMP_LEVELS 13
 
 class Canvas;
 class RasterMap;
-class WindowProjection;
 struct ColorRamp;
 
 class RasterRenderer : private NonCopyable {
@@ -48,14 +53,84 @@ class RasterRenderer : private NonCopyable {
   HeightMatrix height_matrix;
   RawBitmap *image;
 
+  /**
+   * The threads which fill the #height_matrix in ScanMap().
+   */
+  ThreadPool scan_pool;
+
+  /**
+   * The slope shading indexes of one row, used by
+   * GenerateSlopeImage().
+   */
+  AllocatedArray<int8_t> slope_buffer;
+
   fixed pixel_size;
 
+  /**
+   * The map which was scanned by the last full ScanMap() call.  This
+   * is only used to compare pointers, and is never dereferenced.
+   */
+  const RasterMap *scan_map;
+
+  /**
+   * The RasterMap::GetSerial() value of the last full scan.
+   */
+  unsigned scan_serial;
+
+  /**
+   * The projection of the last full scan.  Subsequent scans which
+   * only move the view are done relative to this projection, and
+   * only the exposed rows and columns are scanned.
+   */
+  WindowProjection scan_projection;
+
+  /**
+   * The position of the #height_matrix origin relative to
+   * #scan_projection, in cells.
+   */
+  RasterPoint scan_offset;
+
+  /**
+   * The screen position of the #height_matrix origin in the current
+   * projection, in pixels.  #scan_offset is rounded to whole cells;
+   * this keeps the remainder, which is at most half a cell.
+   */
+  RasterPoint screen_offset;
+
+  /**
+   * The number of cells the #height_matrix was moved by ScanMap()
+   * since the last GenerateImage() call.
+   */
+  int scroll_x, scroll_y;
+
+  /**
+   * Does the #image contain the current #height_matrix (apart from
+   * #scroll_x and #scroll_y), generated with the following
+   * parameters?
+   */
+  bool image_valid;
+
+  bool image_do_shading;
+  unsigned image_height_scale;
+  int image_contrast, image_brightness;
+  Angle image_sunazimuth;
+  unsigned image_quantisation_effective;
+  unsigned image_height_slope_factor;
+
   BGRColor color_table[256 * 128];
 
 public:
   RasterRenderer();
   ~RasterRenderer();
 
+  /**
+   * Set the number of threads used by ScanMap().  The default is one
+   * per processor, up to 4; 1 scans in the calling thread only.
+   */
+  void SetScanConcurrency(unsigned concurrency) {
+    scan_pool.SetConcurrency(concurrency);
+  }
+
   unsigned GetQuantisation() const {
     return quantisation_pixels;
   }
@@ -94,24 +169,62 @@ public:
     return *image;
   }
 
+  /**
+   * Returns the screen position where the #image must be drawn, in
+   * pixels.  This is non-zero after the view was moved by a fraction
+   * of a cell.
+   */
+  const RasterPoint &GetScreenOffset() const {
+    return screen_offset;
+  }
+
 protected:
+  /**
+   * Check whether the new projection differs from #scan_projection
+   * only by a translation, i.e. whether the #height_matrix can be
+   * scrolled.
+   *
+   * @param new_offset returns the new #scan_offset
+   * @param new_screen_offset returns the new #screen_offset
+   */
+  gcc_pure
+  bool CheckScroll(const RasterMap &map, const WindowProjection &projection,
+                   RasterPoint &new_offset,
+                   RasterPoint &new_screen_offset) const;
+
+  /**
+   * Convert the specified part of the height matrix into the image.
+   */
+  void GenerateImage(bool do_shading, unsigned height_scale,
+                     int contrast, int brightness, const Angle sunazimuth,
+                     const PixelRect &rc);
+
+  /**
+   * Move the image by #scroll_x and #scroll_y, and generate the
+   * exposed parts.
+   */
+  void GenerateScrolledImage(bool do_shading, unsigned height_scale,
+                             int contrast, int brightness,
+                             const Angle sunazimuth);
+
   /**
    * Convert the height matrix into the image, without shading.
    */
-  void GenerateUnshadedImage(unsigned height_scale);
+  void GenerateUnshadedImage(unsigned height_scale, const PixelRect &rc);
 
   /**
    * Convert the height matrix into the image, with slope shading.
    */
   void GenerateSlopeImage(unsigned height_scale, int contrast,
-                          const int sx, const int sy, const int sz);
+                          const int sx, const int sy, const int sz,
+                          const PixelRect &rc);
 
   /**
    * Convert the height matrix into the image, with slope shading.
    */
   void GenerateSlopeImage(unsigned height_scale,
                           int contrast, int brightness,
-                          const Angle sunazimuth);
+                          const Angle sunazimuth, const PixelRect &rc);
 };
 
 #endif
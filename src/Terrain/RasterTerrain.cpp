@@ -55,3 +55,21 @@ RasterTerrain::OpenTerrain(FileCache *cache, OperationEnvironment &operation)
 
   return rt;
 }
+
+bool
+RasterTerrain::UpdateTiles(const GeoPoint &location, fixed radius)
+{
+  {
+    ExclusiveLease lease(*this);
+    if (!lease->PrepareTiles(location, radius))
+      return false;
+  }
+
+  /* the expensive part: decode without holding the lock, the new
+     tiles are not visible to readers yet */
+  map.LoadTiles();
+
+  ExclusiveLease lease(*this);
+  lease->PublishTiles();
+  return true;
+}
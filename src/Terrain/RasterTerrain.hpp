@@ -74,10 +74,70 @@ public:
     return lease->GetHeight(location);
   }
 
+  /**
+   * Look up the heights of many locations, and hold the lock only
+   * once.
+   *
+   * @see RasterMap::GetHeights()
+   */
+  void GetTerrainHeights(const GeoPoint *locations, short *heights,
+                         unsigned n) const {
+    Lease lease(*this);
+    lease->GetHeights(locations, heights, n);
+  }
+
   GeoPoint GetTerrainCenter() const {
     return map.GetMapCenter();
   }
 
+  const GeoBounds &GetTerrainBounds() const {
+    return map.GetBounds();
+  }
+
+  /**
+   * @see RasterMap::GetRasterWidth()
+   */
+  unsigned GetRasterWidth() const {
+    return map.GetRasterWidth();
+  }
+
+  unsigned GetRasterHeight() const {
+    return map.GetRasterHeight();
+  }
+
+  /**
+   * Load the tiles around the specified location.  Unlike
+   * RasterMap::SetViewCenter(), this holds the lock only while
+   * selecting and publishing tiles, but not while decoding them;
+   * until then, readers use the overview.
+   *
+   * This method must not be called by more than one thread at a
+   * time; usually, it is only called by the #TerrainLoader.
+   *
+   * @return true if new tiles have been loaded
+   */
+  bool UpdateTiles(const GeoPoint &location, fixed radius);
+
+  /**
+   * Are there still tiles scheduled to be loaded?
+   *
+   * @see RasterMap::IsDirty()
+   */
+  gcc_pure
+  bool IsDirty() const {
+    Lease lease(*this);
+    return lease->IsDirty();
+  }
+
+  /**
+   * @see RasterMap::GetSerial()
+   */
+  gcc_pure
+  unsigned GetSerial() const {
+    Lease lease(*this);
+    return lease->GetSerial();
+  }
+
 };
 
 #endif
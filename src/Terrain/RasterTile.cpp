@@ -28,10 +28,12 @@ Copyright_License {
 #include "IO/ZipLineReader.hpp"
 #include "Operation.hpp"
 #include "Math/FastMath.h"
+#include "Thread/FastMutex.hpp"
 
 #include <stdlib.h>
 #include <algorithm>
 #include <limits.h>
+#include <vector>
 
 using std::min;
 using std::max;
@@ -61,13 +63,10 @@ RasterTile::LoadCache(FILE *file)
 }
 
 void
-RasterTile::Enable()
+RasterTile::EnablePending()
 {
-  if (!width || !height) {
-    Disable();
-  } else {
-    buffer.resize(width, height);
-  }
+  if (width > 0 && height > 0)
+    pending.resize(width, height);
 }
 
 short
@@ -133,7 +132,7 @@ short*
 RasterTileCache::GetImageBuffer(unsigned index)
 {
   if (TileRequest(index))
-    return tiles.GetLinear(index).GetImageBuffer();
+    return tiles.GetLinear(index).GetPendingBuffer();
 
   return NULL;
 }
@@ -142,6 +141,11 @@ void
 RasterTileCache::SetTile(unsigned index,
                          int xstart, int ystart, int xend, int yend)
 {
+  if (!scan_overview)
+    /* the tile geometry is already known; don't modify it while
+       other threads may be reading */
+    return;
+
   if (!segments.empty() && segments.last().tile < 0)
     /* link current marker segment with this tile */
     segments.last().tile = index;
@@ -200,6 +204,8 @@ RasterTileCache::PollTiles(int x, int y, unsigned radius)
     /* dispose all tiles which are out of range */
     for (unsigned i = MAX_ACTIVE_TILES; i < RequestTiles.size(); ++i) {
       RasterTile &tile = tiles.GetLinear(RequestTiles[i]);
+      if (tile.IsEnabled())
+        ++serial;
       tile.Disable();
     }
 
@@ -235,8 +241,8 @@ RasterTileCache::TileRequest(unsigned index)
   if (!tile.is_requested())
     return false;
 
-  tile.Enable();
-  return true; // want to load this one!
+  tile.EnablePending();
+  return tile.IsPending(); // want to load this one!
 }
 
 short
@@ -250,9 +256,95 @@ RasterTileCache::GetHeight(unsigned px, unsigned py) const
   if (tile.IsEnabled())
     return tile.GetHeight(px, py);
 
-  // still not found, so go to overview
-  return Overview.get_interpolated(px << (SUBPIXEL_BITS - OVERVIEW_BITS),
-                                   py << (SUBPIXEL_BITS - OVERVIEW_BITS));
+  // still not found, so go to the finest pyramid level
+  return pyramid[0].get_interpolated(px << (SUBPIXEL_BITS - PYRAMID_BITS),
+                                     py << (SUBPIXEL_BITS - PYRAMID_BITS));
+}
+
+inline short
+RasterTileCache::GetTileHeight(const RasterTile &tile,
+                               unsigned px, unsigned py) const
+{
+  return tile.IsEnabled()
+    ? tile.GetHeight(px, py)
+    : pyramid[0].get_interpolated(px << (SUBPIXEL_BITS - PYRAMID_BITS),
+                                  py << (SUBPIXEL_BITS - PYRAMID_BITS));
+}
+
+void
+RasterTileCache::GetHeights(const RasterLocation *locations, short *heights,
+                            unsigned n) const
+{
+  if (n < MIN_GROUPED_HEIGHTS) {
+    /* the tile of the previous location, and its pixel range; samples
+       are usually ordered along a line or a polygon, so the next one
+       is likely to be in the same tile */
+    const RasterTile *tile = NULL;
+    unsigned tile_left = 0, tile_top = 0, tile_right = 0, tile_bottom = 0;
+
+    for (unsigned i = 0; i < n; ++i) {
+      const unsigned px = locations[i].x, py = locations[i].y;
+      if (px >= width || py >= height) {
+        // outside overall bounds
+        heights[i] = RasterBuffer::TERRAIN_INVALID;
+        continue;
+      }
+
+      if (px < tile_left || px >= tile_right ||
+          py < tile_top || py >= tile_bottom) {
+        const unsigned tile_x = px / tile_width, tile_y = py / tile_height;
+        tile = &tiles.Get(tile_x, tile_y);
+        tile_left = tile_x * tile_width;
+        tile_right = tile_left + tile_width;
+        tile_top = tile_y * tile_height;
+        tile_bottom = tile_top + tile_height;
+      }
+
+      heights[i] = GetTileHeight(*tile, px, py);
+    }
+
+    return;
+  }
+
+  /* visit the locations tile by tile (counting sort by tile number),
+     so each tile is looked up once and its data is read while it is
+     in the CPU cache */
+  const unsigned n_tiles = tiles.GetWidth() * tiles.GetHeight();
+  std::vector<unsigned> tile_of(n), end(n_tiles + 1, 0), order(n);
+
+  for (unsigned i = 0; i < n; ++i) {
+    const unsigned px = locations[i].x, py = locations[i].y;
+    if (px >= width || py >= height) {
+      // outside overall bounds
+      heights[i] = RasterBuffer::TERRAIN_INVALID;
+      tile_of[i] = n_tiles;
+      continue;
+    }
+
+    tile_of[i] = (py / tile_height) * tiles.GetWidth() + px / tile_width;
+    ++end[tile_of[i] + 1];
+  }
+
+  /* end[t] is the start of tile t's range in #order */
+  for (unsigned t = 1; t < n_tiles; ++t)
+    end[t + 1] += end[t];
+
+  /* ... and after this loop, the end of it */
+  for (unsigned i = 0; i < n; ++i)
+    if (tile_of[i] < n_tiles)
+      order[end[tile_of[i]]++] = i;
+
+  for (unsigned t = 0, j = 0; t < n_tiles; ++t) {
+    if (j == end[t])
+      continue;
+
+    const RasterTile &tile = tiles.Get(t % tiles.GetWidth(),
+                                       t / tiles.GetWidth());
+    for (; j < end[t]; ++j) {
+      const unsigned i = order[j];
+      heights[i] = GetTileHeight(tile, locations[i].x, locations[i].y);
+    }
+  }
 }
 
 short
@@ -270,9 +362,9 @@ RasterTileCache::GetInterpolatedHeight(unsigned int lx, unsigned int ly) const
   if (tile.IsEnabled())
     return tile.GetInterpolatedHeight(px, py, ix, iy);
 
-  // still not found, so go to overview
-  return Overview.get_interpolated(lx >> OVERVIEW_BITS,
-                                   ly >> OVERVIEW_BITS);
+  // still not found, so go to the finest pyramid level
+  return pyramid[0].get_interpolated(lx >> PYRAMID_BITS,
+                                     ly >> PYRAMID_BITS);
 }
 
 void
@@ -280,12 +372,20 @@ RasterTileCache::SetSize(unsigned _width, unsigned _height,
                          unsigned _tile_width, unsigned _tile_height,
                          unsigned tile_columns, unsigned tile_rows)
 {
+  if (!scan_overview)
+    /* the raster geometry is already known; don't modify it while
+       other threads may be reading */
+    return;
+
   width = _width;
   height = _height;
   tile_width = _tile_width;
   tile_height = _tile_height;
 
-  Overview.resize(width >> OVERVIEW_BITS, height >> OVERVIEW_BITS);
+  for (unsigned i = 0; i < NUM_PYRAMID_LEVELS; ++i)
+    pyramid[i].resize(width >> (PYRAMID_BITS + i),
+                      height >> (PYRAMID_BITS + i));
+
   overview_width_fine = width << SUBPIXEL_BITS;
   overview_height_fine = height << SUBPIXEL_BITS;
 
@@ -296,6 +396,10 @@ void
 RasterTileCache::SetLatLonBounds(double _lon_min, double _lon_max,
                                  double _lat_min, double _lat_max)
 {
+  if (!scan_overview)
+    /* see SetSize() */
+    return;
+
   bounds.west = Angle::degrees(fixed(min(_lon_min, _lon_max)));
   bounds.east = Angle::degrees(fixed(max(_lon_min, _lon_max)));
   bounds.north = Angle::degrees(fixed(max(_lat_min, _lat_max)));
@@ -303,9 +407,22 @@ RasterTileCache::SetLatLonBounds(double _lon_min, double _lon_max,
   bounds_initialised = true;
 }
 
+/**
+ * The source for initial RasterTileCache::serial values, so a new
+ * object at the address of a deleted one doesn't appear unchanged.
+ */
+static unsigned next_serial;
+
+RasterTileCache::RasterTileCache()
+  :serial(++next_serial), operation(NULL)
+{
+  Reset();
+}
+
 void
 RasterTileCache::Reset()
 {
+  ++serial;
   width = 0;
   height = 0;
   initialised = false;
@@ -313,12 +430,44 @@ RasterTileCache::Reset()
   segments.clear();
   scan_overview = true;
 
-  Overview.reset();
+  tile_store.Close();
+
+  for (unsigned i = 0; i < NUM_PYRAMID_LEVELS; ++i)
+    pyramid[i].reset();
 
   for (unsigned i = 0; i < tiles.GetSize(); i++)
     tiles.GetLinear(i).Disable();
 }
 
+void
+RasterTileCache::BuildPyramid()
+{
+  /* libjasper has filled the finest level; each coarser level
+     contains every other pixel of the preceding one, which is the
+     same subsampling libjasper does */
+  for (unsigned i = 1; i < NUM_PYRAMID_LEVELS; ++i) {
+    const RasterBuffer &src = pyramid[i - 1];
+    RasterBuffer &dest = pyramid[i];
+
+    short *p = dest.get_data();
+    for (unsigned y = 0; y < dest.get_height(); ++y) {
+      const short *q = src.get_data_at(0, y * 2);
+      for (unsigned x = 0; x < dest.get_width(); ++x, q += 2)
+        *p++ = *q;
+    }
+  }
+}
+
+unsigned
+RasterTileCache::SpacingToPyramidBits(unsigned spacing)
+{
+  unsigned bits = 0;
+  while (bits < OVERVIEW_BITS && spacing >= (2u << bits))
+    ++bits;
+
+  return bits >= PYRAMID_BITS ? bits : 0;
+}
+
 gcc_pure
 const RasterTileCache::MarkerSegmentInfo *
 RasterTileCache::FindMarkerSegment(long file_offset) const
@@ -396,16 +545,29 @@ RasterTileCache::MarkerSegment(long file_offset, unsigned id)
 
 extern RasterTileCache *raster_tile_current;
 
+/**
+ * Protects #raster_tile_current, because libjasper reports to one
+ * global RasterTileCache, and terrain and weather may be loaded by
+ * different threads.
+ */
+static FastMutex jasper_mutex;
+
 void
 RasterTileCache::LoadJPG2000(const char *jp2_filename)
 {
   jas_stream_t *in;
 
+  jasper_mutex.Lock();
   raster_tile_current = this;
 
   in = jas_stream_fopen(jp2_filename, "rb");
   if (!in) {
-    Reset();
+    jasper_mutex.Unlock();
+
+    if (scan_overview)
+      Reset();
+    /* else: the requested tiles will be disabled by PublishTiles();
+       don't touch anything else, other threads may be reading */
     return;
   }
 
@@ -414,6 +576,7 @@ RasterTileCache::LoadJPG2000(const char *jp2_filename)
 
   jp2_decode(in, scan_overview ? "xcsoar=2" : "xcsoar=1");
   jas_stream_close(in);
+  jasper_mutex.Unlock();
 }
 
 bool
@@ -486,11 +649,15 @@ RasterTileCache::LoadOverview(const char *path, const TCHAR *world_file,
   Reset();
 
   LoadJPG2000(path);
-  scan_overview = false;
+
+  if (initialised)
+    BuildPyramid();
 
   if (initialised && world_file != NULL)
     LoadWorldFile(world_file);
 
+  scan_overview = false;
+
   if (initialised && !bounds_initialised)
     initialised = false;
 
@@ -507,28 +674,97 @@ RasterTileCache::UpdateTiles(const char *path, int x, int y, unsigned radius)
   if (!PollTiles(x, y, radius))
     return;
 
+  LoadTiles(path);
+  PublishTiles();
+}
+
+void
+RasterTileCache::LoadTiles(const char *path)
+{
+  if (!LoadStoredTiles())
+    return;
+
   LoadJPG2000(path);
 
-  /* permanently disable the requested tiles which are still not
-     loaded, to prevent trying to reload them over and over in a busy
-     loop */
+  /* remember the decoded tiles for the next time */
+  for (unsigned i = 0; i < RequestTiles.size(); ++i) {
+    RasterTile &tile = tiles.GetLinear(RequestTiles[i]);
+    if (tile.is_requested() && tile.IsPending())
+      tile_store.Store(RequestTiles[i], tile.GetPendingBuffer(),
+                       tile.width * tile.height);
+  }
+}
+
+void
+RasterTileCache::PublishTiles()
+{
   for (unsigned i = 0; i < RequestTiles.size(); ++i) {
     RasterTile &tile = tiles.GetLinear(RequestTiles[i]);
-    if (tile.is_requested() && !tile.IsEnabled())
+    if (tile.IsPending()) {
+      tile.Publish();
+      ++serial;
+    } else if (tile.is_requested())
+      /* permanently disable the requested tiles which are still not
+         loaded, to prevent trying to reload them over and over in a
+         busy loop */
       tile.Clear();
   }
 }
 
 bool
-RasterTileCache::SaveCache(FILE *file) const
+RasterTileCache::LoadStoredTiles()
+{
+  bool remaining = false;
+
+  for (unsigned i = 0; i < RequestTiles.size(); ++i) {
+    const unsigned index = RequestTiles[i];
+    RasterTile &tile = tiles.GetLinear(index);
+    if (!tile.is_requested())
+      continue;
+
+    if (tile_store.IsPresent(index)) {
+      tile.EnablePending();
+      if (tile.IsPending() &&
+          tile_store.Load(index, tile.GetPendingBuffer(),
+                          tile.width * tile.height)) {
+        tile.clear_request();
+        continue;
+      }
+
+      tile.pending.reset();
+    }
+
+    remaining = true;
+  }
+
+  return remaining;
+}
+
+bool
+RasterTileCache::OpenTileStore(FileCache &cache, const TCHAR *name,
+                               const TCHAR *original_path)
 {
   if (!initialised)
     return false;
 
+  CacheHeader header;
+  MakeCacheHeader(header);
+
+  return tile_store.Open(cache, name, original_path,
+                         &header, sizeof(header), tiles.GetSize(),
+                         tile_width * tile_height * sizeof(short));
+}
+
+void
+RasterTileCache::MakeCacheHeader(CacheHeader &header) const
+{
   assert(bounds_initialised);
 
-  /* save metadata */
-  CacheHeader header;
+  /* the header is compared with memcmp() by the tile store; its
+     members are laid out without padding bytes, so it is enough to
+     initialise all of them */
+  header = CacheHeader();
+
   header.version = CacheHeader::VERSION;
   header.width = width;
   header.height = height;
@@ -537,7 +773,19 @@ RasterTileCache::SaveCache(FILE *file) const
   header.tile_columns = tiles.GetWidth();
   header.tile_rows = tiles.GetHeight();
   header.num_marker_segments = segments.size();
+  header.pyramid_bits = PYRAMID_BITS;
   header.bounds = bounds;
+}
+
+bool
+RasterTileCache::SaveCache(FILE *file) const
+{
+  if (!initialised)
+    return false;
+
+  /* save metadata */
+  CacheHeader header;
+  MakeCacheHeader(header);
 
   if (fwrite(&header, sizeof(header), 1, file) != 1 ||
       /* .. and segments */
@@ -556,11 +804,14 @@ RasterTileCache::SaveCache(FILE *file) const
   if (fwrite(&i, sizeof(i), 1, file) != 1)
     return false;
 
-  /* save overview */
-  size_t overview_size = Overview.get_width() * Overview.get_height();
-  if (fwrite(Overview.get_data(), sizeof(*Overview.get_data()),
-             overview_size, file) != overview_size)
-    return false;
+  /* save pyramid */
+  for (unsigned i = 0; i < NUM_PYRAMID_LEVELS; ++i) {
+    const RasterBuffer &level = pyramid[i];
+    size_t level_size = level.get_width() * level.get_height();
+    if (fwrite(level.get_data(), sizeof(*level.get_data()),
+               level_size, file) != level_size)
+      return false;
+  }
 
   /* done */
   return true;
@@ -579,6 +830,7 @@ RasterTileCache::LoadCache(FILE *file)
       header.height < 1024 || header.height > 1024 * 1024 ||
       header.num_marker_segments < 4 ||
       header.num_marker_segments > segments.capacity() ||
+      header.pyramid_bits != PYRAMID_BITS ||
       header.bounds.empty())
     return false;
 
@@ -611,11 +863,14 @@ RasterTileCache::LoadCache(FILE *file)
       return false;
   }
 
-  /* load overview */
-  size_t overview_size = Overview.get_width() * Overview.get_height();
-  if (fread(Overview.get_data(), sizeof(*Overview.get_data()),
-            overview_size, file) != overview_size)
-    return false;
+  /* load pyramid */
+  for (unsigned i = 0; i < NUM_PYRAMID_LEVELS; ++i) {
+    RasterBuffer &level = pyramid[i];
+    size_t level_size = level.get_width() * level.get_height();
+    if (fread(level.get_data(), sizeof(*level.get_data()),
+              level_size, file) != level_size)
+      return false;
+  }
 
   initialised = true;
   scan_overview = false;
@@ -898,14 +1153,14 @@ RasterTileCache::ScanTileLine(GridLocation start, GridLocation end,
                   buffer + start.index, end.index - start.index,
                   interpolate);
   else
-    /* need range checking in the overview buffer because its size may
+    /* need range checking in the pyramid buffer because its size may
        be rounded down, and then the "fine" location may exceed its
        bounds */
-    Overview.ScanLineChecked(start.x >> OVERVIEW_BITS,
-                             start.y >> OVERVIEW_BITS,
-                             end.x >> OVERVIEW_BITS, end.y >> OVERVIEW_BITS,
-                             buffer + start.index, end.index - start.index,
-                             interpolate);
+    pyramid[0].ScanLineChecked(start.x >> PYRAMID_BITS,
+                               start.y >> PYRAMID_BITS,
+                               end.x >> PYRAMID_BITS, end.y >> PYRAMID_BITS,
+                               buffer + start.index, end.index - start.index,
+                               interpolate);
 }
 
 void
@@ -919,6 +1174,20 @@ RasterTileCache::ScanLine(const RasterLocation _start,
   assert(_end.y < height << 8);
   assert(size >= 2);
 
+  /* if the samples are far apart, the tiles' resolution is wasted:
+     scan the pyramid level which matches the sample spacing */
+  const unsigned spacing =
+    std::max(abs((int)_end.x - (int)_start.x),
+             abs((int)_end.y - (int)_start.y))
+    / ((size - 1) << SUBPIXEL_BITS);
+  const unsigned bits = SpacingToPyramidBits(spacing);
+  if (bits > 0) {
+    GetPyramidLevel(bits).ScanLineChecked(_start.x >> bits, _start.y >> bits,
+                                          _end.x >> bits, _end.y >> bits,
+                                          buffer, size, interpolate);
+    return;
+  }
+
   const GridRay ray(tile_width << 8, tile_height << 8, _start, _end, size);
   assert(ray.size == size);
   assert(ray.start.index == 0);
@@ -951,11 +1220,8 @@ RasterTileCache::FirstIntersection(int x0, int y0,
     // origin is outside overall bounds
     return false;
 
-  // remember index of active tile, so we dont need to scan each each time
-  // (unless the guess fails)
-  int tile_index = -1;
-
-  h_origin = std::max(h_origin, GetFieldDirect(x0, y0, tile_index));
+  unsigned bits = 0;
+  h_origin = std::max(h_origin, GetFieldDirect(x0, y0, bits));
   h_dest = std::max(h_dest, h_origin);
 
   // line algorithm parameters
@@ -969,8 +1235,8 @@ RasterTileCache::FirstIntersection(int x0, int y0,
   const int max_steps = (dx+dy);
   // calculate number of fine steps to produce a step on the overview field
   const int step_fine = std::max(1, max_steps >> INTERSECT_BITS);
-  // number of steps for update to the overview map
-  const int step_coarse = std::max(1<< OVERVIEW_BITS, step_fine);
+  // the coarsest pyramid level which is good enough for step_fine
+  const unsigned step_bits = SpacingToPyramidBits(step_fine);
 
   // number of steps to be cleared after climbing over obstruction
   const int intersect_steps = 32;
@@ -985,7 +1251,7 @@ RasterTileCache::FirstIntersection(int x0, int y0,
 
 #ifdef DEBUG_TILE
   printf("# max steps %d\n", max_steps);
-  printf("# step coarse %d\n", step_coarse);
+  printf("# step bits %u\n", step_bits);
   printf("# step fine %d\n", step_fine);
 #endif
 
@@ -1019,8 +1285,11 @@ RasterTileCache::FirstIntersection(int x0, int y0,
       if ((_x >= width) || (_y >= height))
         break; // outside bounds
 
-      h_terrain = GetFieldDirect(x_int, y_int, tile_index)+h_safety;
-      step_counter = tile_index<0? step_coarse: step_fine;
+      bits = step_bits;
+      h_terrain = GetFieldDirect(x_int, y_int, bits)+h_safety;
+      step_counter = bits > 0
+        ? std::max(1 << OVERVIEW_BITS, step_fine)
+        : step_fine;
 
       // calculate height of glide so far
       const short dh = (short)((total_steps*slope_fact)>>RASTER_SLOPE_FACT);
@@ -1131,24 +1400,38 @@ RasterTileCache::FirstIntersection(int x0, int y0,
 #define ACCURATE_TERRAIN_INTERSECTION
 
 short
-RasterTileCache::GetFieldDirect(const unsigned px, const unsigned py, int& tile_index) const
+RasterTileCache::GetFieldDirect(const unsigned px, const unsigned py,
+                                unsigned &bits) const
 {
+  if ((px >= width) || (py >= height))
+    // outside overall bounds
+    return RasterBuffer::TERRAIN_INVALID;
+
 #ifdef ACCURATE_TERRAIN_INTERSECTION
 
-  const RasterTile &tile = tiles.Get(px / tile_width, py / tile_height);
-  if (tile.IsEnabled())
-    return tile.GetHeight(px, py);
+  if (bits == 0) {
+    const RasterTile &tile = tiles.Get(px / tile_width, py / tile_height);
+    if (tile.IsEnabled())
+      return tile.GetHeight(px, py);
 
-#endif
+    // still not found, so go to the finest pyramid level
+    bits = PYRAMID_BITS;
+  }
 
-  // still not found, so go to overview
-  tile_index = -1;
+#else
 
-  if ((px >= width) || (py >= height))
-    // outside overall bounds
+  if (bits < PYRAMID_BITS)
+    bits = PYRAMID_BITS;
+
+#endif
+
+  const RasterBuffer &level = GetPyramidLevel(bits);
+  const unsigned x = px >> bits, y = py >> bits;
+  if (x >= level.get_width() || y >= level.get_height())
+    /* the pyramid size is rounded down */
     return RasterBuffer::TERRAIN_INVALID;
 
-  return Overview.get(px >> OVERVIEW_BITS, py >> OVERVIEW_BITS);
+  return level.get(x, y);
 }
 
 RasterLocation
@@ -1165,9 +1448,7 @@ RasterTileCache::Intersection(int x0, int y0,
     return RasterLocation(_x, _y);
   }
 
-  // remember index of active tile, so we dont need to scan each each time
-  // (unless the guess fails)
-  int tile_index = -1;
+  unsigned bits;
 
   // line algorithm parameters
   const int dx = abs(x1-x0);
@@ -1185,8 +1466,8 @@ RasterTileCache::Intersection(int x0, int y0,
 
   // number of steps for update to the fine map
   const int step_fine = std::max(1, refine_step);
-  // number of steps for update to the overview map
-  const int step_coarse = std::max(1<< OVERVIEW_BITS, step_fine);
+  // the coarsest pyramid level which is good enough for step_fine
+  const unsigned step_bits = SpacingToPyramidBits(step_fine);
 
   // counter for steps to reach next position to be checked on the field.
   unsigned step_counter = 0;
@@ -1195,7 +1476,7 @@ RasterTileCache::Intersection(int x0, int y0,
 
 #ifdef DEBUG_TILE
   printf("# max steps %d\n", max_steps);
-  printf("# step coarse %d\n", step_coarse);
+  printf("# step bits %u\n", step_bits);
   printf("# step fine %d\n", step_fine);
 #endif
 
@@ -1213,8 +1494,11 @@ RasterTileCache::Intersection(int x0, int y0,
       if ((_x >= width) || (_y >= height))
         break; // outside bounds
 
-      h_terrain = GetFieldDirect(_x, _y, tile_index);
-      step_counter = tile_index<0? step_coarse: step_fine;
+      bits = step_bits;
+      h_terrain = GetFieldDirect(_x, _y, bits);
+      step_counter = bits > 0
+        ? std::max(1 << OVERVIEW_BITS, step_fine)
+        : step_fine;
 
       // calculate height of glide so far
       const short dh = (short)((total_steps*slope_fact)>>RASTER_SLOPE_FACT);
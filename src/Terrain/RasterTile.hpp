@@ -24,6 +24,7 @@ Copyright_License {
 #define XCSOAR_RASTERTILE_HPP
 
 #include "Terrain/RasterBuffer.hpp"
+#include "Terrain/RasterTileStore.hpp"
 #include "Geo/GeoBounds.hpp"
 #include "Util/NonCopyable.hpp"
 #include "Util/StaticArray.hpp"
@@ -38,6 +39,7 @@ Copyright_License {
 struct RasterLocation;
 struct GridLocation;
 class OperationEnvironment;
+class FileCache;
 
 class RasterTile : private NonCopyable {
   struct MetaData {
@@ -58,6 +60,13 @@ public:
 
   RasterBuffer buffer;
 
+  /**
+   * The buffer which receives the decoded tile.  It is moved to
+   * #buffer by Publish(), so readers never see a partially loaded
+   * tile.
+   */
+  RasterBuffer pending;
+
 public:
   RasterTile()
     :xstart(0), ystart(0), xend(0), yend(0),
@@ -110,7 +119,6 @@ public:
     buffer.reset();
   }
 
-  void Enable();
   bool IsEnabled() const {
     return buffer.defined();
   }
@@ -118,6 +126,27 @@ public:
     return !buffer.defined();
   }
 
+  /**
+   * Allocate the #pending buffer, to be filled by the decoder.
+   */
+  void EnablePending();
+
+  bool IsPending() const {
+    return pending.defined();
+  }
+
+  short *GetPendingBuffer() {
+    return pending.get_data();
+  }
+
+  /**
+   * Make the #pending buffer visible to readers.
+   */
+  void Publish() {
+    buffer.swap(pending);
+    pending.reset();
+  }
+
   /**
    * Determine the non-interpolated height at the specified pixel
    * location.
@@ -141,10 +170,6 @@ public:
   short GetInterpolatedHeight(unsigned x, unsigned y,
                               unsigned ix, unsigned iy) const;
 
-  inline short* GetImageBuffer() {
-    return buffer.get_data();
-  }
-
   bool VisibilityChanged(int view_x, int view_y, unsigned view_radius);
 
   void ScanLine(unsigned ax, unsigned ay, unsigned bx, unsigned by,
@@ -175,10 +200,29 @@ class RasterTileCache : private NonCopyable {
 
   /**
    * The width and height of the terrain bitmap is shifted by this
-   * number of bits to determine the overview size.
+   * number of bits to determine the overview size, i.e. the coarsest
+   * level of the pyramid.
    */
   static const unsigned OVERVIEW_BITS = 4;
 
+  /**
+   * The width and height of the terrain bitmap is shifted by this
+   * number of bits to determine the size of the finest pyramid level.
+   * Each following level has half the width and height, up to
+   * #OVERVIEW_BITS.
+   *
+   * With 3 bits, the pyramid takes 1/64 + 1/256 of the raster; each
+   * finer level would multiply that by four.
+   */
+#if !defined(_WIN32_WCE) || (_WIN32_WCE >= 0x0400 && !defined(GNAV))
+  static const unsigned PYRAMID_BITS = 3;
+#else
+  // old Windows CE and Altair: the overview only
+  static const unsigned PYRAMID_BITS = 4;
+#endif
+
+  static const unsigned NUM_PYRAMID_LEVELS = OVERVIEW_BITS - PYRAMID_BITS + 1;
+
   /**
    * Target number of steps in intersection searches; total distance
    * is shifted by this number of bits
@@ -217,9 +261,9 @@ protected:
   struct CacheHeader {
     enum {
 #ifdef FIXED_MATH
-      VERSION = 0x6,
+      VERSION = 0x8,
 #else
-      VERSION = 0x7,
+      VERSION = 0x9,
 #endif
     };
 
@@ -228,6 +272,7 @@ protected:
     unsigned short tile_width, tile_height;
     unsigned tile_columns, tile_rows;
     unsigned num_marker_segments;
+    unsigned pyramid_bits;
     GeoBounds bounds;
   };
 
@@ -238,10 +283,25 @@ protected:
 
   bool dirty;
 
+  /**
+   * Changes whenever the height data changes, e.g. when tiles are
+   * loaded or discarded.  This allows renderers to check whether
+   * cached results are still valid.
+   */
+  unsigned serial;
+
   AllocatedGrid<RasterTile> tiles;
   unsigned short tile_width, tile_height;
 
-  RasterBuffer Overview;
+  /**
+   * Subsampled copies of the whole terrain: level i contains every
+   * (2^(PYRAMID_BITS+i))th pixel of each row and column.  They are
+   * built while the file is scanned during startup, and are used
+   * where no tile is loaded, and where the requested sample spacing
+   * is coarse enough.  The last one is the "overview".
+   */
+  RasterBuffer pyramid[NUM_PYRAMID_LEVELS];
+
   bool scan_overview;
   unsigned int width, height;
   unsigned int overview_width_fine, overview_height_fine;
@@ -257,20 +317,65 @@ protected:
    */
   StaticArray<unsigned short, MAX_RTC_TILES> RequestTiles;
 
+  /**
+   * Optional on-disk store of decoded tiles.  Tiles found there are
+   * not decoded again by libjasper.
+   */
+  RasterTileStore tile_store;
+
   /**
    * Progress callbacks for loading the file during startup.
    */
   OperationEnvironment *operation;
 
 public:
-  RasterTileCache():operation(NULL) {
-    Reset();
-  }
+  RasterTileCache();
 
 protected:
+  /**
+   * Returns the pyramid level which is subsampled by the specified
+   * number of bits.
+   */
+  const RasterBuffer &GetPyramidLevel(unsigned bits) const {
+    assert(bits >= PYRAMID_BITS);
+    assert(bits <= OVERVIEW_BITS);
+
+    return pyramid[bits - PYRAMID_BITS];
+  }
+
+  const RasterBuffer &GetOverviewBuffer() const {
+    return GetPyramidLevel(OVERVIEW_BITS);
+  }
+
+  /**
+   * Determine the coarsest pyramid level which is still at least as
+   * fine as the specified sample spacing.
+   *
+   * @param spacing the distance between two samples in pixels
+   * @return the number of bits of the pyramid level, or 0 if the
+   * spacing is too small for the pyramid (i.e. tiles should be used)
+   */
+  gcc_const
+  static unsigned SpacingToPyramidBits(unsigned spacing);
+
+  /**
+   * Fill the coarser pyramid levels from the finest one.
+   */
+  void BuildPyramid();
+
   void ScanTileLine(GridLocation start, GridLocation end,
                     short *buffer, unsigned size, bool interpolate) const;
 
+  /**
+   * The minimum number of locations for which GetHeights() sorts them
+   * by tile; below this, sorting costs more than it saves (see
+   * BenchmarkTerrain).
+   */
+  static const unsigned MIN_GROUPED_HEIGHTS = 1024;
+
+  gcc_pure
+  short GetTileHeight(const RasterTile &tile, unsigned px, unsigned py) const;
+
 public:
   /**
    * Determine the non-interpolated height at the specified pixel
@@ -282,6 +387,20 @@ public:
   gcc_pure
   short GetHeight(unsigned x, unsigned y) const;
 
+  /**
+   * Determine the non-interpolated heights at many pixel locations at
+   * once.  This is cheaper than calling GetHeight() for each of them:
+   * small batches remember the tile of the previous location, larger
+   * ones (at least #MIN_GROUPED_HEIGHTS) are grouped by tile first.
+   *
+   * @param locations the pixel locations within the map; may be out
+   * of range
+   * @param heights the destination buffer
+   * @param n the number of locations
+   */
+  void GetHeights(const RasterLocation *locations, short *heights,
+                  unsigned n) const;
+
   /**
    * Determine the interpolated height at the specified sub-pixel
    * location.
@@ -329,9 +448,12 @@ protected:
    * Get field (not interpolated) directly, without bringing tiles to front.
    * @param px X position/256
    * @param px Y position/256
-   * @param tile_index Remember position of active tile, or -1 for overview
+   * @param bits the coarsest pyramid level which may be used (0 means
+   * the caller wants full resolution); returns the level which was
+   * actually used (0 if the value was read from a tile)
    */
-  short GetFieldDirect(const unsigned px, const unsigned py, int &tile_index) const;
+  short GetFieldDirect(const unsigned px, const unsigned py,
+                       unsigned &bits) const;
 
 public:
   bool LoadOverview(const char *path, const TCHAR *world_file,
@@ -340,8 +462,46 @@ public:
   bool SaveCache(FILE *file) const;
   bool LoadCache(FILE *file);
 
+  /**
+   * Enable the on-disk store of decoded tiles.  Call this after the
+   * overview has been loaded (or restored from the cache).
+   *
+   * @param original_path the path of the terrain file, used to
+   * invalidate the store when the file changes
+   * @return true if the store is usable
+   */
+  bool OpenTileStore(FileCache &cache, const TCHAR *name,
+                     const TCHAR *original_path);
+
+  /**
+   * Load the tiles around the specified location.  This is a
+   * shortcut for PollTiles(), LoadTiles() and PublishTiles().
+   */
   void UpdateTiles(const char *path, int x, int y, unsigned radius);
 
+  /**
+   * Determine which tiles should be loaded for the specified view.
+   * Tiles which are out of range are disposed.  The caller must
+   * hold an exclusive lock.
+   *
+   * @return true if there are tiles to be loaded
+   */
+  bool PollTiles(int x, int y, unsigned radius);
+
+  /**
+   * Decode the tiles selected by PollTiles().  The results are not
+   * visible until PublishTiles() is called, therefore this method
+   * may run while other threads read from this object.  It must not
+   * run concurrently with any other non-const method.
+   */
+  void LoadTiles(const char *path);
+
+  /**
+   * Make the tiles loaded by LoadTiles() visible.  The caller must
+   * hold an exclusive lock.
+   */
+  void PublishTiles();
+
   /**
    * Determines if there are still tiles scheduled to be loaded.  Call
    * this after UpdateTiles() to determine if UpdateTiles() should be
@@ -351,6 +511,13 @@ public:
     return dirty;
   }
 
+  /**
+   * @see #serial
+   */
+  unsigned GetSerial() const {
+    return serial;
+  }
+
   bool GetInitialised() const {
     return initialised;
   }
@@ -364,6 +531,17 @@ public:
   }
 
 private:
+  void MakeCacheHeader(CacheHeader &header) const;
+
+  /**
+   * Copy requested tiles from the tile store to their #pending
+   * buffer, and clear their request flag.
+   *
+   * @return true if there are requested tiles left which must be
+   * decoded
+   */
+  bool LoadStoredTiles();
+
   gcc_pure
   const MarkerSegmentInfo *
   FindMarkerSegment(long file_offset) const;
@@ -376,8 +554,16 @@ public:
 
   bool TileRequest(unsigned index);
 
+  /**
+   * Returns the buffer of the finest pyramid level, which is filled by
+   * libjasper while scanning the file.
+   */
   short *GetOverview() {
-    return Overview.get_data();
+    return pyramid[0].get_data();
+  }
+
+  static unsigned GetOverviewBits() {
+    return PYRAMID_BITS;
   }
 
   void SetSize(unsigned width, unsigned height,
@@ -392,12 +578,9 @@ public:
     initialised = val;
   }
 
-protected:
-  bool PollTiles(int x, int y, unsigned radius);
-
 public:
   short GetMaxElevation() const {
-    return Overview.get_max();
+    return GetOverviewBuffer().get_max();
   }
 
   unsigned int GetWidth() const { return width; }
@@ -0,0 +1,196 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Terrain/RasterTileStore.hpp"
+#include "IO/FileCache.hpp"
+#include "OS/FileMapping.hpp"
+
+#include <windef.h> /* for MAX_PATH */
+
+#include <assert.h>
+#include <string.h>
+
+static size_t
+AlignToPage(size_t offset, size_t page_size)
+{
+  return (offset + page_size - 1) / page_size * page_size;
+}
+
+bool
+RasterTileStore::Create(FileCache &cache, const TCHAR *name,
+                        const TCHAR *original_path,
+                        const void *header, size_t header_size,
+                        unsigned num_slots, size_t slot_size)
+{
+  FILE *file = cache.save(name, original_path);
+  if (file == NULL)
+    return false;
+
+  if (fwrite(header, header_size, 1, file) != 1) {
+    cache.cancel(name, file);
+    return false;
+  }
+
+  /* all slots are empty */
+  for (unsigned i = 0; i < num_slots; ++i) {
+    if (fputc(0, file) == EOF) {
+      cache.cancel(name, file);
+      return false;
+    }
+  }
+
+  /* grow the file to its final size, so it can be mapped once; on
+     most file systems, this creates a sparse file */
+  const size_t slots_offset = AlignToPage(ftell(file), PAGE_SIZE);
+  const size_t file_size = slots_offset + num_slots * slot_size;
+  if (fseek(file, file_size - 1, SEEK_SET) != 0 ||
+      fputc(0, file) == EOF) {
+    cache.cancel(name, file);
+    return false;
+  }
+
+  return cache.commit(name, file);
+}
+
+bool
+RasterTileStore::OpenExisting(FileCache &cache, const TCHAR *name,
+                              const TCHAR *original_path,
+                              const void *header, size_t header_size,
+                              unsigned num_slots)
+{
+  assert(file == NULL);
+  assert(mapping == NULL);
+
+  file = cache.update(name, original_path);
+  if (file == NULL)
+    return false;
+
+  AllocatedArray<char> old_header(header_size);
+  if (fread(old_header.begin(), header_size, 1, file) != 1 ||
+      memcmp(old_header.begin(), header, header_size) != 0) {
+    Close();
+    cache.flush(name);
+    return false;
+  }
+
+  flags_offset = ftell(file);
+  present.resize_discard(num_slots);
+  for (unsigned i = 0; i < num_slots; ++i) {
+    int ch = fgetc(file);
+    if (ch == EOF) {
+      Close();
+      cache.flush(name);
+      return false;
+    }
+
+    present[i] = ch != 0;
+  }
+
+  slots_offset = AlignToPage(flags_offset + num_slots, PAGE_SIZE);
+
+  TCHAR path[MAX_PATH];
+  if (cache.path_buffer_size(name) > MAX_PATH) {
+    Close();
+    return false;
+  }
+
+  mapping = new FileMapping(cache.make_cache_path(path, name));
+  if (mapping->error() ||
+      mapping->size() < slots_offset + num_slots * slot_size) {
+    Close();
+    cache.flush(name);
+    return false;
+  }
+
+  return true;
+}
+
+bool
+RasterTileStore::Open(FileCache &cache, const TCHAR *name,
+                      const TCHAR *original_path,
+                      const void *header, size_t header_size,
+                      unsigned num_slots, size_t slot_bytes)
+{
+  Close();
+
+  if (num_slots == 0 || slot_bytes == 0)
+    return false;
+
+  slot_size = AlignToPage(slot_bytes, PAGE_SIZE);
+  if (num_slots * slot_size > MAX_FILE_SIZE)
+    return false;
+
+  return OpenExisting(cache, name, original_path, header, header_size,
+                      num_slots) ||
+    (Create(cache, name, original_path, header, header_size,
+            num_slots, slot_size) &&
+     OpenExisting(cache, name, original_path, header, header_size,
+                  num_slots));
+}
+
+void
+RasterTileStore::Close()
+{
+  delete mapping;
+  mapping = NULL;
+
+  if (file != NULL) {
+    fclose(file);
+    file = NULL;
+  }
+
+  present.resize_discard(0);
+}
+
+bool
+RasterTileStore::Load(unsigned index, short *dest, size_t n) const
+{
+  if (!IsPresent(index))
+    return false;
+
+  assert(n * sizeof(*dest) <= slot_size);
+
+  memcpy(dest, mapping->at(slots_offset + index * slot_size),
+         n * sizeof(*dest));
+  return true;
+}
+
+void
+RasterTileStore::Store(unsigned index, const short *src, size_t n)
+{
+  if (!IsOpen() || index >= present.size() || present[index])
+    return;
+
+  assert(n * sizeof(*src) <= slot_size);
+
+  /* write the pixels first, and mark the slot as valid only after
+     that succeeded */
+  if (fseek(file, slots_offset + index * slot_size, SEEK_SET) != 0 ||
+      fwrite(src, sizeof(*src), n, file) != n ||
+      fseek(file, flags_offset + index, SEEK_SET) != 0 ||
+      fputc(1, file) == EOF ||
+      fflush(file) != 0)
+    return;
+
+  present[index] = true;
+}
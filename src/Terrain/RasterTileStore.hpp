@@ -0,0 +1,144 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_RASTER_TILE_STORE_HPP
+#define XCSOAR_RASTER_TILE_STORE_HPP
+
+#include "Util/NonCopyable.hpp"
+#include "Util/AllocatedArray.hpp"
+#include "Compiler.h"
+
+#include <tchar.h>
+#include <stddef.h>
+#include <stdio.h>
+
+class FileCache;
+class FileMapping;
+
+/**
+ * An on-disk store for decoded terrain tiles.  Each tile gets a
+ * page-aligned slot in a cache file which is mapped into memory, so
+ * reactivating a tile which has been decoded before costs a page
+ * fault instead of a JPEG2000 decoder run.
+ *
+ * The file begins with a caller-supplied header (usually the
+ * RasterTileCache::CacheHeader); if it does not match, the file is
+ * discarded and recreated.
+ */
+class RasterTileStore : private NonCopyable {
+  /**
+   * Slots are aligned to this size, so each tile occupies whole
+   * pages in the mapping.
+   */
+  static const size_t PAGE_SIZE = 4096;
+
+  /**
+   * Don't create stores larger than this; the disk space is better
+   * spent elsewhere, and FileMapping refuses files beyond 1 GB.
+   */
+  static const size_t MAX_FILE_SIZE = 256 * 1024 * 1024;
+
+  FILE *file;
+  FileMapping *mapping;
+
+  /**
+   * The file offset of the "present" flag array.
+   */
+  long flags_offset;
+
+  /**
+   * The file offset of the first slot.
+   */
+  size_t slots_offset;
+
+  size_t slot_size;
+
+  /**
+   * Which slots contain a valid tile?  This is a copy of the flag
+   * array in the file.
+   */
+  AllocatedArray<bool> present;
+
+public:
+  RasterTileStore():file(NULL), mapping(NULL) {}
+
+  ~RasterTileStore() {
+    Close();
+  }
+
+  bool IsOpen() const {
+    return mapping != NULL;
+  }
+
+  /**
+   * Open (or create) the store file.
+   *
+   * @param header identifies the terrain file; a cache file with a
+   * different header is discarded
+   * @param num_slots the number of tiles
+   * @param slot_bytes the maximum size of one tile in bytes
+   * @return true on success
+   */
+  bool Open(FileCache &cache, const TCHAR *name, const TCHAR *original_path,
+            const void *header, size_t header_size,
+            unsigned num_slots, size_t slot_bytes);
+
+  void Close();
+
+  /**
+   * Does the store contain the specified tile?
+   */
+  gcc_pure
+  bool IsPresent(unsigned index) const {
+    return IsOpen() && index < present.size() && present[index];
+  }
+
+  /**
+   * Copy a tile from the store.
+   *
+   * @param n the number of height values
+   * @return false if the tile is not in the store
+   */
+  bool Load(unsigned index, short *dest, size_t n) const;
+
+  /**
+   * Write a decoded tile to the store.  Errors are ignored; the tile
+   * will simply be decoded again the next time.
+   *
+   * @param n the number of height values
+   */
+  void Store(unsigned index, const short *src, size_t n);
+
+private:
+  bool OpenExisting(FileCache &cache, const TCHAR *name,
+                    const TCHAR *original_path,
+                    const void *header, size_t header_size,
+                    unsigned num_slots);
+
+  static bool Create(FileCache &cache, const TCHAR *name,
+                     const TCHAR *original_path,
+                     const void *header, size_t header_size,
+                     unsigned num_slots, size_t slot_size);
+};
+
+#endif
@@ -0,0 +1,304 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Terrain/SlopeShading.hpp"
+#include "Terrain/RasterBuffer.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+gcc_const
+static inline bool
+IsSpecial(short h)
+{
+  return RasterBuffer::is_special(h);
+}
+
+static inline int8_t
+SlopeShadingPixel(const short *src,
+                  unsigned row_minus_offset, unsigned row_plus_offset,
+                  unsigned column_offset, unsigned p31,
+                  unsigned height_slope_factor,
+                  int sx, int sy, int sz, int contrast)
+{
+  const short h_above = src[-(int)row_minus_offset];
+  const short h_below = src[row_plus_offset];
+  const short h_left = src[-(int)column_offset];
+  const short h_right = src[column_offset];
+
+  if (gcc_unlikely(IsSpecial(h_above) || IsSpecial(h_below) ||
+                   IsSpecial(h_left) || IsSpecial(h_right)))
+    return 0;
+
+  return SlopeShadingIndex(h_right - h_left, h_above - h_below,
+                           column_offset * 2, p31, height_slope_factor,
+                           sx, sy, sz, contrast);
+}
+
+#ifdef __SSE2__
+
+/**
+ * Per-row constants for the SSE2 kernel.
+ */
+struct SlopeShadingConstants {
+  __m128 p20, p31, sx, sy, dd2_sz, dd2_square, contrast;
+  __m128i sz, threshold;
+
+  SlopeShadingConstants(unsigned _p20, unsigned _p31,
+                        unsigned height_slope_factor,
+                        int _sx, int _sy, int _sz, int _contrast) {
+    const float dd2 = (float)(_p20 * _p31 * height_slope_factor);
+
+    p20 = _mm_set1_ps((float)_p20);
+    p31 = _mm_set1_ps((float)_p31);
+    sx = _mm_set1_ps((float)_sx);
+    sy = _mm_set1_ps((float)_sy);
+    dd2_sz = _mm_set1_ps(dd2 * _sz);
+    dd2_square = _mm_set1_ps(dd2 * dd2);
+    contrast = _mm_set1_ps(_contrast / 128.f);
+    sz = _mm_set1_epi32(_sz);
+    threshold = _mm_set1_epi16(RasterBuffer::TERRAIN_WATER_THRESHOLD + 1);
+  }
+};
+
+/**
+ * Sign-extend the lower four 16 bit integers to 32 bit.
+ */
+static inline __m128i
+LowToInt32(__m128i x)
+{
+  return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+}
+
+/**
+ * Sign-extend the upper four 16 bit integers to 32 bit.
+ */
+static inline __m128i
+HighToInt32(__m128i x)
+{
+  return _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+}
+
+/**
+ * SIMD version of SlopeShadingIndex() for four pixels, without
+ * clipping.
+ */
+static inline __m128i
+SlopeShading4(__m128i p22, __m128i p32, const SlopeShadingConstants &c)
+{
+  const __m128 dd0 = _mm_mul_ps(_mm_cvtepi32_ps(p22), c.p31);
+  const __m128 dd1 = _mm_mul_ps(_mm_cvtepi32_ps(p32), c.p20);
+
+  const __m128 num = _mm_add_ps(c.dd2_sz,
+                                _mm_add_ps(_mm_mul_ps(dd0, c.sx),
+                                           _mm_mul_ps(dd1, c.sy)));
+  const __m128 mag = _mm_add_ps(c.dd2_square,
+                                _mm_add_ps(_mm_mul_ps(dd0, dd0),
+                                           _mm_mul_ps(dd1, dd1)));
+
+  /* truncate the square root like the integer implementation */
+  const __m128 root = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_sqrt_ps(mag)));
+  const __m128i sval = _mm_cvttps_epi32(_mm_div_ps(num, root));
+
+  return _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(sval, c.sz)),
+                                     c.contrast));
+}
+
+static inline void
+SlopeShading8(int8_t *dest, const short *src,
+              unsigned row_minus_offset, unsigned row_plus_offset,
+              unsigned column_offset, const SlopeShadingConstants &c)
+{
+  const __m128i h_above = _mm_loadu_si128((const __m128i *)
+                                          (src - row_minus_offset));
+  const __m128i h_below = _mm_loadu_si128((const __m128i *)
+                                          (src + row_plus_offset));
+  const __m128i h_left = _mm_loadu_si128((const __m128i *)
+                                         (src - column_offset));
+  const __m128i h_right = _mm_loadu_si128((const __m128i *)
+                                          (src + column_offset));
+
+  const __m128i special =
+    _mm_or_si128(_mm_or_si128(_mm_cmplt_epi16(h_above, c.threshold),
+                              _mm_cmplt_epi16(h_below, c.threshold)),
+                 _mm_or_si128(_mm_cmplt_epi16(h_left, c.threshold),
+                              _mm_cmplt_epi16(h_right, c.threshold)));
+
+  /* calculate the differences in 32 bit, they may overflow 16 bit */
+  const __m128i low =
+    SlopeShading4(_mm_sub_epi32(LowToInt32(h_right), LowToInt32(h_left)),
+                  _mm_sub_epi32(LowToInt32(h_above), LowToInt32(h_below)),
+                  c);
+  const __m128i high =
+    SlopeShading4(_mm_sub_epi32(HighToInt32(h_right), HighToInt32(h_left)),
+                  _mm_sub_epi32(HighToInt32(h_above), HighToInt32(h_below)),
+                  c);
+
+  __m128i sindex = _mm_packs_epi32(low, high);
+  sindex = _mm_min_epi16(_mm_max_epi16(sindex, _mm_set1_epi16(-64)),
+                         _mm_set1_epi16(63));
+  sindex = _mm_andnot_si128(special, sindex);
+
+  _mm_storel_epi64((__m128i *)dest, _mm_packs_epi16(sindex, sindex));
+}
+
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+
+/**
+ * Per-row constants for the NEON kernel.
+ */
+struct SlopeShadingConstants {
+  float32x4_t p20, p31, dd2_sz, dd2_square, contrast;
+  float sx, sy;
+  int32x4_t sz;
+  int16x8_t threshold;
+
+  SlopeShadingConstants(unsigned _p20, unsigned _p31,
+                        unsigned height_slope_factor,
+                        int _sx, int _sy, int _sz, int _contrast)
+    :sx((float)_sx), sy((float)_sy) {
+    const float dd2 = (float)(_p20 * _p31 * height_slope_factor);
+
+    p20 = vdupq_n_f32((float)_p20);
+    p31 = vdupq_n_f32((float)_p31);
+    dd2_sz = vdupq_n_f32(dd2 * _sz);
+    dd2_square = vdupq_n_f32(dd2 * dd2);
+    contrast = vdupq_n_f32(_contrast / 128.f);
+    sz = vdupq_n_s32(_sz);
+    threshold = vdupq_n_s16(RasterBuffer::TERRAIN_WATER_THRESHOLD + 1);
+  }
+};
+
+static inline float32x4_t
+Sqrt(float32x4_t x)
+{
+#ifdef __aarch64__
+  return vsqrtq_f32(x);
+#else
+  /* ARMv7 has only an estimate of the reciprocal square root; refine
+     it with two Newton-Raphson steps */
+  float32x4_t e = vrsqrteq_f32(x);
+  e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(x, e), e));
+  e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(x, e), e));
+  return vmulq_f32(x, e);
+#endif
+}
+
+static inline float32x4_t
+Divide(float32x4_t a, float32x4_t b)
+{
+#ifdef __aarch64__
+  return vdivq_f32(a, b);
+#else
+  float32x4_t r = vrecpeq_f32(b);
+  r = vmulq_f32(vrecpsq_f32(b, r), r);
+  r = vmulq_f32(vrecpsq_f32(b, r), r);
+  return vmulq_f32(a, r);
+#endif
+}
+
+/**
+ * SIMD version of SlopeShadingIndex() for four pixels, without
+ * clipping.
+ */
+static inline int32x4_t
+SlopeShading4(int32x4_t p22, int32x4_t p32, const SlopeShadingConstants &c)
+{
+  const float32x4_t dd0 = vmulq_f32(vcvtq_f32_s32(p22), c.p31);
+  const float32x4_t dd1 = vmulq_f32(vcvtq_f32_s32(p32), c.p20);
+
+  const float32x4_t num =
+    vaddq_f32(c.dd2_sz, vaddq_f32(vmulq_n_f32(dd0, c.sx),
+                                  vmulq_n_f32(dd1, c.sy)));
+  const float32x4_t mag =
+    vaddq_f32(c.dd2_square, vaddq_f32(vmulq_f32(dd0, dd0),
+                                      vmulq_f32(dd1, dd1)));
+
+  /* truncate the square root like the integer implementation */
+  const float32x4_t root = vcvtq_f32_s32(vcvtq_s32_f32(Sqrt(mag)));
+  const int32x4_t sval = vcvtq_s32_f32(Divide(num, root));
+
+  return vcvtq_s32_f32(vmulq_f32(vcvtq_f32_s32(vsubq_s32(sval, c.sz)),
+                                 c.contrast));
+}
+
+static inline void
+SlopeShading8(int8_t *dest, const short *src,
+              unsigned row_minus_offset, unsigned row_plus_offset,
+              unsigned column_offset, const SlopeShadingConstants &c)
+{
+  const int16x8_t h_above = vld1q_s16(src - row_minus_offset);
+  const int16x8_t h_below = vld1q_s16(src + row_plus_offset);
+  const int16x8_t h_left = vld1q_s16(src - column_offset);
+  const int16x8_t h_right = vld1q_s16(src + column_offset);
+
+  const uint16x8_t special =
+    vorrq_u16(vorrq_u16(vcltq_s16(h_above, c.threshold),
+                        vcltq_s16(h_below, c.threshold)),
+              vorrq_u16(vcltq_s16(h_left, c.threshold),
+                        vcltq_s16(h_right, c.threshold)));
+
+  /* calculate the differences in 32 bit, they may overflow 16 bit */
+  const int32x4_t low =
+    SlopeShading4(vsubl_s16(vget_low_s16(h_right), vget_low_s16(h_left)),
+                  vsubl_s16(vget_low_s16(h_above), vget_low_s16(h_below)),
+                  c);
+  const int32x4_t high =
+    SlopeShading4(vsubl_s16(vget_high_s16(h_right), vget_high_s16(h_left)),
+                  vsubl_s16(vget_high_s16(h_above), vget_high_s16(h_below)),
+                  c);
+
+  int16x8_t sindex = vcombine_s16(vqmovn_s32(low), vqmovn_s32(high));
+  sindex = vminq_s16(vmaxq_s16(sindex, vdupq_n_s16(-64)), vdupq_n_s16(63));
+  sindex = vbicq_s16(sindex, vreinterpretq_s16_u16(special));
+
+  vst1_s8(dest, vqmovn_s16(sindex));
+}
+
+#endif
+
+void
+SlopeShadingRow(int8_t *dest, const short *src, unsigned length,
+                unsigned row_minus_offset, unsigned row_plus_offset,
+                unsigned column_offset, unsigned p31,
+                unsigned height_slope_factor,
+                int sx, int sy, int sz, int contrast)
+{
+#ifdef HAVE_SLOPE_SHADING_SIMD
+  const SlopeShadingConstants c(column_offset * 2, p31, height_slope_factor,
+                                sx, sy, sz, contrast);
+
+  for (; length >= 8; length -= 8, src += 8, dest += 8)
+    SlopeShading8(dest, src, row_minus_offset, row_plus_offset,
+                  column_offset, c);
+#endif
+
+  /* the remaining pixels */
+  for (; length > 0; --length)
+    *dest++ = SlopeShadingPixel(src++, row_minus_offset, row_plus_offset,
+                                column_offset, p31, height_slope_factor,
+                                sx, sy, sz, contrast);
+}
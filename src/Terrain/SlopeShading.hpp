@@ -0,0 +1,105 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_SLOPE_SHADING_HPP
+#define XCSOAR_TERRAIN_SLOPE_SHADING_HPP
+
+#include "Math/fixed.hpp"
+#include "Math/FastMath.h"
+#include "Compiler.h"
+
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(__ARM_NEON__) || defined(__ARM_NEON)
+/**
+ * Is a vectorized implementation of SlopeShadingRow() available on
+ * this platform?
+ */
+#define HAVE_SLOPE_SHADING_SIMD
+#endif
+
+/**
+ * Calculate the slope shading index for one pixel.
+ *
+ * @param p22 the height difference in X direction (right minus left)
+ * @param p32 the height difference in Y direction (above minus below)
+ * @param p20 the horizontal distance of the two X samples
+ * @param p31 the vertical distance of the two Y samples
+ * @return the shading index, -64..63
+ */
+gcc_const
+static inline int
+SlopeShadingIndex(int p22, int p32, unsigned p20, unsigned p31,
+                  unsigned height_slope_factor,
+                  int sx, int sy, int sz, int contrast)
+{
+  const int dd0 = p22 * (int)p31;
+  const int dd1 = (int)p20 * p32;
+  const int dd2 = (int)(p20 * p31 * height_slope_factor);
+#ifdef FIXED_MATH
+  const int num = (dd2 * sz + dd0 * sx + dd1 * sy);
+  const int mag = (dd0 * dd0 + dd1 * dd1 + dd2 * dd2);
+  const int sval = num / (int)isqrt4(mag);
+#else
+  /* 64 bit, because the squares overflow 32 bit on steep slopes */
+  const int64_t num = ((int64_t)dd2 * sz + (int64_t)dd0 * sx +
+                       (int64_t)dd1 * sy);
+  const int64_t mag = ((int64_t)dd0 * dd0 + (int64_t)dd1 * dd1 +
+                       (int64_t)dd2 * dd2);
+  const int sval = (int)(num / (int64_t)sqrt((fixed)mag));
+#endif
+  int sindex = (sval - sz) * contrast / 128;
+  if (gcc_unlikely(sindex < -64))
+    sindex = -64;
+  if (gcc_unlikely(sindex > 63))
+    sindex = 63;
+  return sindex;
+}
+
+/**
+ * Calculate the slope shading indexes for a span of pixels which is
+ * at least #column_offset pixels away from the left and right
+ * borders of the height matrix.  Pixels next to a "special" height
+ * (water or invalid) get the index 0; the result for pixels which
+ * are special themselves is undefined.
+ *
+ * Where available, this uses SSE2 or NEON to process 8 pixels at a
+ * time.  Due to different rounding, the result may differ from
+ * SlopeShadingIndex() by 1.
+ *
+ * @param dest the destination buffer, one index (-64..63) per pixel
+ * @param src the first pixel of the span in the height matrix
+ * @param length the number of pixels in the span
+ * @param row_minus_offset the offset of the row above, in pixels
+ * @param row_plus_offset the offset of the row below, in pixels
+ * @param column_offset the horizontal distance of the X samples from
+ * the pixel
+ */
+void
+SlopeShadingRow(int8_t *dest, const short *src, unsigned length,
+                unsigned row_minus_offset, unsigned row_plus_offset,
+                unsigned column_offset, unsigned p31,
+                unsigned height_slope_factor,
+                int sx, int sy, int sz, int contrast);
+
+#endif
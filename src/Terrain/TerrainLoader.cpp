@@ -0,0 +1,61 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Terrain/TerrainLoader.hpp"
+#include "Terrain/RasterTerrain.hpp"
+
+TerrainLoader::TerrainLoader(RasterTerrain &_terrain)
+  :terrain(_terrain), radius(fixed_zero) {}
+
+void
+TerrainLoader::SetViewCenter(const GeoPoint &_location, fixed _radius)
+{
+  mutex.Lock();
+  location = _location;
+  radius = _radius;
+  mutex.Unlock();
+
+  Trigger();
+}
+
+void
+TerrainLoader::Tick()
+{
+  do {
+    mutex.Lock();
+    const GeoPoint _location = location;
+    const fixed _radius = radius;
+    mutex.Unlock();
+
+    if (!positive(_radius))
+      /* no view yet */
+      return;
+
+    if (terrain.UpdateTiles(_location, _radius))
+      OnTilesLoaded();
+
+    /* loading is limited to a few tiles per call to reduce latency;
+       continue until all tiles are loaded, unless we're asked to
+       stop */
+  } while (terrain.IsDirty() && !IsCommandPending());
+}
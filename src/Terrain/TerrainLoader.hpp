@@ -0,0 +1,78 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_LOADER_HPP
+#define XCSOAR_TERRAIN_LOADER_HPP
+
+#include "Thread/WorkerThread.hpp"
+#include "Thread/Mutex.hpp"
+#include "Navigation/GeoPoint.hpp"
+#include "Math/fixed.hpp"
+
+class RasterTerrain;
+
+/**
+ * A thread which loads terrain tiles in background, so the threads
+ * which read the terrain (map drawing, route planner, glide
+ * computer) never wait for the JPEG2000 decoder.  Until a tile
+ * arrives, readers fall back to the overview.
+ */
+class TerrainLoader : public WorkerThread {
+  RasterTerrain &terrain;
+
+  /**
+   * Protects #location and #radius.
+   */
+  Mutex mutex;
+
+  GeoPoint location;
+  fixed radius;
+
+public:
+  TerrainLoader(RasterTerrain &_terrain);
+
+  bool Start(bool suspended=false) {
+    if (!WorkerThread::Start(suspended))
+      return false;
+
+    SetLowPriority();
+    return true;
+  }
+
+  /**
+   * Schedule loading the tiles around the specified location.  This
+   * method returns immediately, and may be called from any thread.
+   */
+  void SetViewCenter(const GeoPoint &location, fixed radius);
+
+protected:
+  virtual void Tick();
+
+  /**
+   * Called by the loader thread after new tiles have been made
+   * available.  The default implementation does nothing.
+   */
+  virtual void OnTilesLoaded() {}
+};
+
+#endif
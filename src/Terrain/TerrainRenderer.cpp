@@ -164,6 +164,7 @@ const ColorRamp terrain_colors[8][NUM_COLOR_RAMP_LEVELS] = {
 // this is for TerrainInfo.StepSize = 0.0025;
 TerrainRenderer::TerrainRenderer(const RasterTerrain *_terrain)
   :terrain(_terrain),
+   last_serial(0),
    last_color_ramp(NULL)
 {
   assert(terrain != NULL);
@@ -203,18 +204,23 @@ TerrainRenderer::ScanSpotHeights()
     }
   }
 
-  spot_max_pt.x *= quantisation_pixels;
-  spot_max_pt.y *= quantisation_pixels;
-  spot_min_pt.x *= quantisation_pixels;
-  spot_min_pt.y *= quantisation_pixels;
+  const RasterPoint &offset = raster_renderer.GetScreenOffset();
+  spot_max_pt.x = spot_max_pt.x * quantisation_pixels + offset.x;
+  spot_max_pt.y = spot_max_pt.y * quantisation_pixels + offset.y;
+  spot_min_pt.x = spot_min_pt.x * quantisation_pixels + offset.x;
+  spot_min_pt.y = spot_min_pt.y * quantisation_pixels + offset.y;
 }
 
 void
 TerrainRenderer::CopyTo(Canvas &canvas, unsigned width, unsigned height) const
 {
+  /* after a pan by a fraction of a cell, the image is drawn slightly
+     off the screen origin; the exposed strip at the opposite border
+     is at most half a cell wide */
+  const RasterPoint &offset = raster_renderer.GetScreenOffset();
   raster_renderer.GetImage().stretch_to(raster_renderer.get_width(),
                                         raster_renderer.get_height(), canvas,
-                                        width, height);
+                                        offset.x, offset.y, width, height);
 }
 
 void
@@ -231,12 +237,16 @@ void
 TerrainRenderer::Generate(const WindowProjection &map_projection,
                           const Angle sunazimuth)
 {
+  const unsigned serial = terrain->GetSerial();
+
   if (compare_projection.CompareAndUpdate(map_projection) &&
-      last_sun_azimuth == sunazimuth)
+      last_sun_azimuth == sunazimuth &&
+      last_serial == serial)
     /* no change since previous frame */
     return;
 
   last_sun_azimuth = sunazimuth;
+  last_serial = serial;
 
   const bool do_water = true;
   const unsigned height_scale = 4;
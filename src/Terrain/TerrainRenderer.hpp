@@ -44,6 +44,12 @@ protected:
 
   Angle last_sun_azimuth;
 
+  /**
+   * The RasterMap::GetSerial() value of the previous frame.  It
+   * changes when new terrain tiles have been loaded.
+   */
+  unsigned last_serial;
+
   const ColorRamp *last_color_ramp;
 
   RasterRenderer raster_renderer;
@@ -0,0 +1,219 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Thread/ThreadPool.hpp"
+#include "Thread/Thread.hpp"
+#include "Util/PerfCounters.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+class ThreadPool::Worker : public Thread {
+  ThreadPool &pool;
+
+public:
+  /**
+   * Signalled when a new job arrives, or when the thread shall quit.
+   */
+  Trigger trigger;
+
+  /**
+   * This thread's performance counters, added to
+   * PerfCounters::CONTEXT_POOL after each job.
+   */
+  PerfCounters::Block counters;
+
+  Worker(ThreadPool &_pool):pool(_pool), trigger(false) {
+    counters.Clear();
+  }
+
+protected:
+  virtual void Run() {
+    PerfCounters::SetBlock(&counters);
+    pool.WorkerLoop(trigger, counters);
+  }
+};
+
+Mutex ThreadPool::merge_mutex;
+
+ThreadPool::ThreadPool()
+  :job(NULL), n_parts(0), next_part(0), n_finished(0),
+   stopping(false), finished(false) {}
+
+ThreadPool::~ThreadPool()
+{
+  StopWorkers();
+}
+
+void
+ThreadPool::StopWorkers()
+{
+  if (workers.empty())
+    return;
+
+  mutex.Lock();
+  stopping = true;
+  mutex.Unlock();
+
+  for (Worker **i = workers.begin(); i != workers.end(); ++i)
+    (*i)->trigger.Signal();
+
+  for (Worker **i = workers.begin(); i != workers.end(); ++i) {
+    (*i)->Join();
+    delete *i;
+  }
+
+  workers.clear();
+  stopping = false;
+}
+
+void
+ThreadPool::SetConcurrency(unsigned concurrency)
+{
+  assert(job == NULL);
+
+  if (concurrency < 1)
+    concurrency = 1;
+  else if (concurrency > MAX_WORKERS + 1)
+    concurrency = MAX_WORKERS + 1;
+
+  if (concurrency == GetConcurrency())
+    return;
+
+  StopWorkers();
+
+  while (GetConcurrency() < concurrency) {
+    Worker *worker = new Worker(*this);
+    if (!worker->Start()) {
+      /* out of resources: continue with the threads we have */
+      delete worker;
+      break;
+    }
+
+    workers.append(worker);
+  }
+}
+
+void
+ThreadPool::Run(Job &_job, unsigned _n_parts)
+{
+  if (workers.empty()) {
+    /* single-threaded mode */
+    for (unsigned i = 0; i < _n_parts; ++i)
+      _job.RunPart(i);
+    return;
+  }
+
+  if (_n_parts == 0)
+    return;
+
+  mutex.Lock();
+  assert(job == NULL);
+  job = &_job;
+  n_parts = _n_parts;
+  next_part = 0;
+  n_finished = 0;
+  mutex.Unlock();
+
+  /* don't wake up more workers than there are parts left for them */
+  const unsigned n_wake = std::min(_n_parts - 1, (unsigned)workers.size());
+  for (unsigned i = 0; i < n_wake; ++i)
+    workers[i]->trigger.Signal();
+
+  RunParts();
+
+  mutex.Lock();
+  while (n_finished < n_parts) {
+    /* check again after waking up, the Trigger may wake up
+       spuriously */
+    mutex.Unlock();
+    finished.Wait();
+    mutex.Lock();
+  }
+
+  job = NULL;
+  mutex.Unlock();
+}
+
+void
+ThreadPool::RunParts()
+{
+  mutex.Lock();
+
+  while (job != NULL && next_part < n_parts) {
+    Job &current = *job;
+    const unsigned part = next_part++;
+
+    mutex.Unlock();
+    current.RunPart(part);
+    mutex.Lock();
+
+    if (++n_finished == n_parts)
+      finished.Signal();
+  }
+
+  mutex.Unlock();
+}
+
+void
+ThreadPool::WorkerLoop(Trigger &trigger, PerfCounters::Block &counters)
+{
+  while (true) {
+    trigger.Wait();
+
+    mutex.Lock();
+    const bool _stopping = stopping;
+    mutex.Unlock();
+
+    if (_stopping)
+      return;
+
+    RunParts();
+
+    /* the merge is serialised by a mutex shared by all pools */
+    merge_mutex.Lock();
+    PerfCounters::Merge(PerfCounters::CONTEXT_POOL, counters);
+    merge_mutex.Unlock();
+    counters.Clear();
+  }
+}
+
+unsigned
+ThreadPool::GetProcessorCount()
+{
+#ifdef HAVE_POSIX
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (unsigned)n : 1;
+#else
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? info.dwNumberOfProcessors : 1;
+#endif
+}
@@ -0,0 +1,145 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_THREAD_POOL_HPP
+#define XCSOAR_THREAD_POOL_HPP
+
+#include "Util/NonCopyable.hpp"
+#include "Util/StaticArray.hpp"
+#include "Thread/Mutex.hpp"
+#include "Thread/Trigger.hpp"
+#include "Compiler.h"
+
+namespace PerfCounters { struct Block; }
+
+/**
+ * A small set of worker threads which run a job that has been split
+ * into independent parts.  The calling thread works on the job, too,
+ * and Run() returns after all parts are finished.
+ *
+ * With a concurrency of 1 (the default), no threads are created and
+ * all parts are run in the calling thread, in ascending order.
+ * This mode is deterministic and is meant for tests and for
+ * single-core machines.
+ */
+class ThreadPool : private NonCopyable {
+public:
+  enum {
+    /**
+     * The maximum number of worker threads, not counting the
+     * calling thread.
+     */
+    MAX_WORKERS = 7,
+  };
+
+  class Job {
+  public:
+    /**
+     * Run one part of the job.  This may be called in any thread of
+     * the pool, and concurrently with other parts.
+     */
+    virtual void RunPart(unsigned part) = 0;
+  };
+
+private:
+  class Worker;
+
+  StaticArray<Worker *, MAX_WORKERS> workers;
+
+  /**
+   * Serialises PerfCounters::Merge() calls of the workers of all
+   * pools.
+   */
+  static Mutex merge_mutex;
+
+  /**
+   * Protects all attributes below.
+   */
+  Mutex mutex;
+
+  /**
+   * The job currently being run, or NULL.
+   */
+  Job *job;
+
+  unsigned n_parts, next_part, n_finished;
+
+  bool stopping;
+
+  /**
+   * Signalled by the thread which has finished the last part.
+   */
+  Trigger finished;
+
+public:
+  ThreadPool();
+  ~ThreadPool();
+
+  /**
+   * Returns the number of threads which work on a job, including the
+   * calling thread.
+   */
+  unsigned GetConcurrency() const {
+    return workers.size() + 1;
+  }
+
+  /**
+   * Start or stop worker threads.  Must not be called while a job is
+   * running.
+   *
+   * @param concurrency the number of threads which work on a job,
+   * including the calling thread; 1 disables the worker threads
+   */
+  void SetConcurrency(unsigned concurrency);
+
+  /**
+   * Run all parts of the job, and return after they are finished.
+   * Must not be called by more than one thread at a time.
+   */
+  void Run(Job &job, unsigned n_parts);
+
+  /**
+   * Determine the number of processors available to this process.
+   */
+  gcc_const
+  static unsigned GetProcessorCount();
+
+private:
+  void StopWorkers();
+
+  /**
+   * Work on parts of the current job until there are none left.
+   */
+  void RunParts();
+
+  /**
+   * The main loop of a worker thread.
+   *
+   * @param trigger the worker's trigger, which is signalled when a
+   * new job arrives or when the worker shall quit
+   * @param counters the worker's performance counters
+   */
+  void WorkerLoop(Trigger &trigger, PerfCounters::Block &counters);
+};
+
+#endif
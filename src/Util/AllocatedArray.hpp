@@ -75,6 +75,14 @@ public:
     return *this;
   }
 
+  /**
+   * Exchanges the contents of two arrays without copying elements.
+   */
+  void swap(AllocatedArray &other) {
+    std::swap(the_size, other.the_size);
+    std::swap(data, other.data);
+  }
+
   /**
    * Returns the number of allocated elements.
    */
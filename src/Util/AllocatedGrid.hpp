@@ -120,6 +120,15 @@ public:
     width = _width;
     height = _height;
   }
+
+  /**
+   * Exchanges the contents of two grids without copying elements.
+   */
+  void Swap(AllocatedGrid &other) {
+    array.swap(other.array);
+    std::swap(width, other.width);
+    std::swap(height, other.height);
+  }
 };
 
 #endif
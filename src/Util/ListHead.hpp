@@ -34,6 +34,7 @@
 
 #include <iterator>
 #include <cassert>
+#include <stddef.h>
 
 /**
  * A doubly linked list implementation, similar to linux/list.h.  It
@@ -49,6 +49,7 @@ template<typename T, unsigned size>
 class SliceAllocator {
 public:
   typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
   typedef T value_type;
   typedef T *pointer;
   typedef const T *const_pointer;
@@ -217,6 +218,7 @@ class GlobalSliceAllocator {
 
 public:
   typedef size_t size_type;
+  typedef std::ptrdiff_t difference_type;
   typedef T value_type;
   typedef T *pointer;
   typedef const T *const_pointer;
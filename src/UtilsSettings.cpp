@@ -133,7 +133,7 @@ SettingsLeave()
 
   if (WaypointFileChanged || AirfieldFileChanged) {
     // re-load waypoints
-    WaypointGlue::LoadWaypoints(way_points, terrain, operation);
+    WaypointGlue::LoadWaypoints(way_points, terrain, file_cache, operation);
     WaypointDetails::ReadFileFromProfile(way_points, operation);
   }
 
@@ -176,7 +176,7 @@ SettingsLeave()
     airspace_database.clear();
     ReadAirspace(airspace_database, terrain,
                  CommonInterface::SettingsComputer().pressure,
-                 operation);
+                 file_cache, operation);
   }
 
   if (DevicePortChanged)
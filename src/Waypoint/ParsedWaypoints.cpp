@@ -0,0 +1,113 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Waypoint/ParsedWaypoints.hpp"
+#include "Waypoint/Waypoints.hpp"
+#include "Terrain/RasterTerrain.hpp"
+
+#include <algorithm>
+
+void
+ParsedWaypoints::CopyTo(Waypoints &way_points) const
+{
+  for (std::vector<Waypoint>::const_iterator i = waypoints.begin();
+       i != waypoints.end(); ++i)
+    way_points.append(*i);
+}
+
+/**
+ * Interleave the lower 16 bits of the parameter with zero bits.
+ */
+static unsigned
+SpreadBits(unsigned x)
+{
+  x &= 0xffff;
+  x = (x | (x << 8)) & 0x00ff00ff;
+  x = (x | (x << 4)) & 0x0f0f0f0f;
+  x = (x | (x << 2)) & 0x33333333;
+  x = (x | (x << 1)) & 0x55555555;
+  return x;
+}
+
+/**
+ * Calculates the position of the location on a Z-order curve with a
+ * resolution of 1/65536 of the globe.
+ */
+static unsigned
+ZOrderKey(const GeoPoint &location)
+{
+  const fixed longitude = location.Longitude.as_delta().value_degrees();
+  const fixed latitude = location.Latitude.value_degrees();
+
+  const unsigned x = (unsigned)((longitude + fixed(180)) * 65535 / 360);
+  const unsigned y = (unsigned)((fixed(90) - latitude) * 65535 / 180);
+  return SpreadBits(x) | (SpreadBits(y) << 1);
+}
+
+struct AltitudeRequest {
+  unsigned key;
+  Waypoint *waypoint;
+
+  bool operator<(const AltitudeRequest &other) const {
+    return key < other.key;
+  }
+};
+
+void
+LookupAltitudes(ParsedWaypoints *files, unsigned n,
+                const RasterTerrain &terrain)
+{
+  std::vector<AltitudeRequest> requests;
+  for (ParsedWaypoints *file = files, *end = files + n; file != end; ++file) {
+    for (std::vector<unsigned>::const_iterator i =
+           file->missing_altitudes.begin();
+         i != file->missing_altitudes.end(); ++i) {
+      AltitudeRequest request;
+      request.waypoint = &file->waypoints[*i];
+      request.key = ZOrderKey(request.waypoint->location);
+      requests.push_back(request);
+    }
+
+    file->missing_altitudes.clear();
+  }
+
+  if (requests.empty())
+    return;
+
+  std::sort(requests.begin(), requests.end());
+
+  std::vector<GeoPoint> locations;
+  locations.reserve(requests.size());
+  for (std::vector<AltitudeRequest>::const_iterator i = requests.begin();
+       i != requests.end(); ++i)
+    locations.push_back(i->waypoint->location);
+
+  std::vector<short> heights(requests.size());
+  terrain.GetTerrainHeights(&locations[0], &heights[0], locations.size());
+
+  for (unsigned i = 0; i < requests.size(); ++i) {
+    const short height = heights[i];
+    requests[i].waypoint->altitude = RasterBuffer::is_special(height)
+      ? fixed_zero
+      : fixed(height);
+  }
+}
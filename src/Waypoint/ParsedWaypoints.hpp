@@ -0,0 +1,81 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_PARSED_WAYPOINTS_HPP
+#define XCSOAR_PARSED_WAYPOINTS_HPP
+
+#include "Waypoint/Waypoint.hpp"
+
+#include <vector>
+
+class Waypoints;
+class RasterTerrain;
+
+/**
+ * The waypoints of one file, parsed but not yet added to a
+ * #Waypoints database.  This allows parsing several files in
+ * parallel, and looking up all missing altitudes in one terrain
+ * query (see LookupAltitudes()).
+ */
+struct ParsedWaypoints {
+  std::vector<Waypoint> waypoints;
+
+  /**
+   * Indices into #waypoints whose altitude was missing in the file
+   * and shall be looked up in the terrain.
+   */
+  std::vector<unsigned> missing_altitudes;
+
+  void clear() {
+    waypoints.clear();
+    missing_altitudes.clear();
+  }
+
+  void Append(const Waypoint &wp, bool missing_altitude) {
+    if (missing_altitude)
+      missing_altitudes.push_back(waypoints.size());
+
+    waypoints.push_back(wp);
+  }
+
+  /**
+   * Add all waypoints to the database, in the order they were
+   * parsed.  The caller is responsible for calling
+   * Waypoints::optimise() afterwards.
+   */
+  void CopyTo(Waypoints &way_points) const;
+};
+
+/**
+ * Look up the missing altitudes of all files at once.  The lookups
+ * are sorted along a Z-order curve, so consecutive locations are
+ * likely to be in the same terrain tile, and the terrain is locked
+ * only once.  Locations without valid terrain get altitude zero.
+ *
+ * @param files an array of parsed files
+ * @param n the number of elements in the array
+ */
+void
+LookupAltitudes(ParsedWaypoints *files, unsigned n,
+                const RasterTerrain &terrain);
+
+#endif
@@ -0,0 +1,188 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Waypoint/WaypointCache.hpp"
+#include "Waypoint/Waypoint.hpp"
+#include "Terrain/RasterTerrain.hpp"
+#include "IO/CacheBuffer.hpp"
+#include "Geo/GeoBounds.hpp"
+
+#include <stdint.h>
+#include <string.h>
+
+struct WaypointCacheHeader {
+  enum {
+    VERSION = 2,
+  };
+
+  uint32_t version;
+
+  /** Detects a cache file written by an incompatible build */
+  uint8_t tchar_size, fixed_size, runway_size, radio_size, flags_size;
+
+  /** Was a terrain used for missing altitudes? */
+  uint8_t have_terrain;
+
+  /**
+   * Identifies the terrain, see #have_terrain: its bounds and the
+   * size of its raster [pixels], i.e. its resolution
+   */
+  GeoBounds terrain_bounds;
+  uint32_t terrain_width, terrain_height;
+
+  /** The number of waypoints */
+  uint32_t count;
+
+  /** The size of the data following the header [bytes] */
+  uint32_t size;
+};
+
+static void
+MakeHeader(WaypointCacheHeader &header, const RasterTerrain *terrain)
+{
+  /* clear the padding, the header is compared byte by byte */
+  memset((void *)&header, 0, sizeof(header));
+
+  header.version = WaypointCacheHeader::VERSION;
+  header.tchar_size = sizeof(TCHAR);
+  header.fixed_size = sizeof(fixed);
+  header.runway_size = sizeof(Runway);
+  header.radio_size = sizeof(RadioFrequency);
+  header.flags_size = sizeof(Waypoint::Flags);
+
+  header.have_terrain = terrain != NULL;
+  if (terrain != NULL) {
+    header.terrain_bounds = terrain->GetTerrainBounds();
+    header.terrain_width = terrain->GetRasterWidth();
+    header.terrain_height = terrain->GetRasterHeight();
+  }
+}
+
+/**
+ * The size of the smallest record written by WriteCachedWaypoint(): a
+ * waypoint with empty strings.
+ */
+static const size_t MIN_CACHED_WAYPOINT_SIZE =
+  sizeof(unsigned) + sizeof(GeoPoint) + sizeof(fixed) + sizeof(Runway) +
+  sizeof(RadioFrequency) + sizeof(uint8_t) + sizeof(Waypoint::Flags) +
+  sizeof(int8_t) + 3 * sizeof(uint16_t);
+
+static void
+WriteCachedWaypoint(CacheWriter &writer, const Waypoint &wp)
+{
+  writer.Write(wp.original_id);
+  writer.Write(wp.location);
+  writer.Write(wp.altitude);
+  writer.Write(wp.runway);
+  writer.Write(wp.radio_frequency);
+  writer.Write((uint8_t)wp.type);
+  writer.Write(wp.flags);
+  writer.Write(wp.file_num);
+  writer.WriteString(wp.name);
+  writer.WriteString(wp.comment);
+  writer.WriteString(wp.details);
+}
+
+static bool
+ReadCachedWaypoint(CacheReader &reader, Waypoint &wp)
+{
+  uint8_t type;
+  if (!reader.Read(wp.original_id) || !reader.Read(wp.location) ||
+      !reader.Read(wp.altitude) || !reader.Read(wp.runway) ||
+      !reader.Read(wp.radio_frequency) || !reader.Read(type) ||
+      type > Waypoint::TYPE_OBSTACLE ||
+      !reader.Read(wp.flags) || !reader.Read(wp.file_num) ||
+      !reader.ReadString(wp.name) || !reader.ReadString(wp.comment) ||
+      !reader.ReadString(wp.details))
+    return false;
+
+  wp.type = (Waypoint::Type)type;
+  return true;
+}
+
+bool
+SaveWaypointCache(FILE *file, const std::vector<Waypoint> &waypoints,
+                  const RasterTerrain *terrain)
+{
+  std::vector<uint8_t> buffer;
+  CacheWriter writer(buffer);
+  for (std::vector<Waypoint>::const_iterator i = waypoints.begin();
+       i != waypoints.end(); ++i)
+    WriteCachedWaypoint(writer, *i);
+
+  WaypointCacheHeader header;
+  MakeHeader(header, terrain);
+  header.count = waypoints.size();
+  header.size = buffer.size();
+
+  return fwrite(&header, sizeof(header), 1, file) == 1 &&
+    (buffer.empty() ||
+     fwrite(&buffer[0], 1, buffer.size(), file) == buffer.size());
+}
+
+bool
+LoadWaypointCache(FILE *file, std::vector<Waypoint> &waypoints,
+                  const RasterTerrain *terrain)
+{
+  WaypointCacheHeader header, expected;
+  MakeHeader(expected, terrain);
+  if (fread(&header, sizeof(header), 1, file) != 1)
+    return false;
+
+  /* compare everything but the count and the size */
+  const uint32_t count = header.count, size = header.size;
+  header.count = expected.count;
+  header.size = expected.size;
+  if (memcmp(&header, &expected, sizeof(header)) != 0)
+    return false;
+
+  if (count == 0)
+    /* the waypoint file was empty */
+    return size == 0;
+
+  /* don't trust the count with an allocation before the records have
+     been read */
+  if (count > size / MIN_CACHED_WAYPOINT_SIZE)
+    return false;
+
+  /* read everything at once */
+  std::vector<uint8_t> buffer(size);
+  if (fread(&buffer[0], 1, buffer.size(), file) != buffer.size())
+    return false;
+
+  CacheReader reader(buffer);
+  std::vector<Waypoint> result;
+  result.reserve(count);
+  Waypoint wp(GeoPoint(Angle::zero(), Angle::zero()));
+  while (!reader.IsEnd()) {
+    if (!ReadCachedWaypoint(reader, wp))
+      return false;
+
+    result.push_back(wp);
+  }
+
+  if (result.size() != count)
+    return false;
+
+  waypoints.insert(waypoints.end(), result.begin(), result.end());
+  return true;
+}
@@ -0,0 +1,57 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef XCSOAR_WAYPOINT_CACHE_HPP
+#define XCSOAR_WAYPOINT_CACHE_HPP
+
+#include <vector>
+
+#include <stdio.h>
+
+struct Waypoint;
+class RasterTerrain;
+
+/**
+ * Writes the waypoints of one file, as they were parsed (including
+ * altitudes looked up in the terrain), to a binary cache file.
+ *
+ * The waypoints are stored in the given order; the caller adds them
+ * to the #Waypoints database in this order, too, so loading the
+ * cache assigns the same ids again.
+ *
+ * @param terrain the terrain which was used for missing altitudes
+ */
+bool
+SaveWaypointCache(FILE *file, const std::vector<Waypoint> &waypoints,
+                  const RasterTerrain *terrain);
+
+/**
+ * Loads waypoints from a cache file created by SaveWaypointCache()
+ * and appends them to the list.  Nothing is appended if the file
+ * is malformed, was written by an incompatible version or with a
+ * different terrain.
+ */
+bool
+LoadWaypointCache(FILE *file, std::vector<Waypoint> &waypoints,
+                  const RasterTerrain *terrain);
+
+#endif
@@ -37,8 +37,17 @@ Copyright_License {
 #include "Airspace/ProtectedAirspaceWarningManager.hpp"
 #include "IO/TextWriter.hpp"
 #include "Waypoint/WaypointWriter.hpp"
+#include "WaypointCache.hpp"
+#include "ParsedWaypoints.hpp"
+#include "IO/FileCache.hpp"
+#include "Thread/ThreadPool.hpp"
 #include "Operation.hpp"
 
+#include <algorithm>
+#include <vector>
+
+#include <stdio.h>
+
 #include <windef.h> /* for MAX_PATH */
 
 namespace WaypointGlue {
@@ -145,102 +154,210 @@ WaypointGlue::SetHome(Waypoints &way_points, const RasterTerrain *terrain,
   Profile::Set(szProfileTeamcodeRefWaypoint,settings.TeamCodeRefWaypoint);
 }
 
-bool
-WaypointGlue::LoadWaypointFile(int num, Waypoints &way_points,
-                               const RasterTerrain *terrain,
-                               OperationEnvironment &operation)
+static bool
+LoadWaypointFileCache(FileCache *cache, int num, const TCHAR *path,
+                      std::vector<Waypoint> &waypoints,
+                      const RasterTerrain *terrain)
 {
-  // Get waypoint filename
-  TCHAR szFile[MAX_PATH];
-  if (!GetPath(num, szFile))
+  if (cache == NULL)
     return false;
 
-  WaypointReader reader(szFile, num);
+  TCHAR name[32];
+  _stprintf(name, _T("waypoints%d"), num);
 
-  // If waypoint file exists
-  if (!reader.Error()) {
-    // parse the file
-    reader.SetTerrain(terrain);
+  FILE *file = cache->load(name, path);
+  if (file == NULL)
+    return false;
 
-    if (reader.Parse(way_points, operation))
-      return true;
+  const bool loaded = LoadWaypointCache(file, waypoints, terrain);
+  fclose(file);
+  return loaded;
+}
 
-    LogStartUp(_T("Parse error in waypoint file %d"), num);
-  } else {
-    LogStartUp(_T("No waypoint file %d"), num);
-  }
+static void
+SaveWaypointFileCache(FileCache *cache, int num, const TCHAR *path,
+                      const std::vector<Waypoint> &waypoints,
+                      const RasterTerrain *terrain)
+{
+  if (cache == NULL)
+    return;
+
+  TCHAR name[32];
+  _stprintf(name, _T("waypoints%d"), num);
 
-  return false;
+  FILE *file = cache->save(name, path);
+  if (file == NULL)
+    return;
+
+  if (SaveWaypointCache(file, waypoints, terrain))
+    cache->commit(name, file);
+  else
+    cache->cancel(name, file);
 }
 
-bool
-WaypointGlue::LoadMapFileWaypoints(int num, const TCHAR* key,
-                                   Waypoints &way_points,
-                                   const RasterTerrain *terrain,
-                                   OperationEnvironment &operation)
+/**
+ * A waypoint file which is being loaded by LoadWaypointFiles().
+ */
+struct WaypointFile {
+  int num;
+  TCHAR path[MAX_PATH];
+  WaypointReader reader;
+
+  /** Was the file loaded from the cache? */
+  bool cached;
+
+  /** Was the file loaded successfully? */
+  bool success;
+};
+
+/**
+ * Parses waypoint files (or loads them from the cache), one file per
+ * #ThreadPool part.  Terrain altitudes are not looked up here.
+ */
+class WaypointFileParser : public ThreadPool::Job {
+  WaypointFile *files;
+  ParsedWaypoints *parsed;
+  const RasterTerrain *terrain;
+  FileCache *cache;
+
+public:
+  WaypointFileParser(WaypointFile *_files, ParsedWaypoints *_parsed,
+                     const RasterTerrain *_terrain, FileCache *_cache)
+    :files(_files), parsed(_parsed), terrain(_terrain), cache(_cache) {}
+
+  virtual void RunPart(unsigned part) {
+    WaypointFile &file = files[part];
+
+    file.cached = LoadWaypointFileCache(cache, file.num, file.path,
+                                        parsed[part].waypoints, terrain);
+    if (file.cached) {
+      file.success = true;
+      return;
+    }
+
+    /* the caller's OperationEnvironment must not be used by worker
+       threads */
+    NullOperationEnvironment operation;
+    file.success = file.reader.Parse(parsed[part], operation);
+  }
+};
+
+/**
+ * Loads the specified waypoint files into the database.  The files
+ * are parsed concurrently, then the missing altitudes of all files
+ * are looked up in one terrain query, and finally the waypoints are
+ * added to the database in the order of the files.
+ *
+ * @return true if at least one file was loaded
+ */
+static bool
+LoadWaypointFiles(WaypointFile *files, unsigned n, Waypoints &way_points,
+                  const RasterTerrain *terrain, FileCache *cache)
 {
-  TCHAR szFile[MAX_PATH];
+  if (n == 0)
+    return false;
 
-  // Get the map filename
-  Profile::GetPath(key, szFile);
-  _tcscat(szFile, _T("/"));
-  _tcscat(szFile, _T("waypoints.xcw"));
+  std::vector<ParsedWaypoints> parsed(n);
 
-  WaypointReader reader(szFile, num);
+  ThreadPool pool;
+  pool.SetConcurrency(std::min(ThreadPool::GetProcessorCount(), n));
 
-  // Test if waypoints.xcw can be loaded, otherwise try waypoints.cup
-  if (reader.Error()) {
-    // Get the map filename
-    Profile::GetPath(key, szFile);
-    _tcscat(szFile, _T("/"));
-    _tcscat(szFile, _T("waypoints.cup"));
+  WaypointFileParser parser(files, &parsed[0], terrain, cache);
+  pool.Run(parser, n);
+
+  if (terrain != NULL)
+    LookupAltitudes(&parsed[0], n, *terrain);
 
-    reader.Open(szFile, num);
+  bool found = false;
+  for (unsigned i = 0; i < n; ++i) {
+    const WaypointFile &file = files[i];
+    if (!file.success) {
+      LogStartUp(_T("Parse error in waypoint file %d"), file.num);
+      continue;
+    }
+
+    if (!file.cached)
+      SaveWaypointFileCache(cache, file.num, file.path, parsed[i].waypoints,
+                            terrain);
+
+    parsed[i].CopyTo(way_points);
+    found = true;
   }
 
-  // If waypoint file inside map file exists
-  if (!reader.Error()) {
-    // parse the file
-    reader.SetTerrain(terrain);
-    if (reader.Parse(way_points, operation))
-      return true;
+  return found;
+}
+
+/**
+ * Opens the waypoint file inside the map file.
+ *
+ * @return false if there is no waypoint file in the map file
+ */
+static bool
+OpenMapFileWaypoints(WaypointFile &file, const TCHAR *key)
+{
+  // Get the map filename
+  Profile::GetPath(key, file.path);
+  _tcscat(file.path, _T("/"));
+  _tcscat(file.path, _T("waypoints.xcw"));
 
-    LogStartUp(_T("Parse error in map waypoint file"));
-  } else {
-    LogStartUp(_T("No waypoint file in the map file"));
+  file.reader.Open(file.path, file.num);
+
+  // Test if waypoints.xcw can be loaded, otherwise try waypoints.cup
+  if (file.reader.Error()) {
+    // Get the map filename
+    Profile::GetPath(key, file.path);
+    _tcscat(file.path, _T("/"));
+    _tcscat(file.path, _T("waypoints.cup"));
+
+    file.reader.Open(file.path, file.num);
   }
 
-  return false;
+  return !file.reader.Error();
 }
 
 bool
 WaypointGlue::LoadWaypoints(Waypoints &way_points,
                             const RasterTerrain *terrain,
+                            FileCache *cache,
                             OperationEnvironment &operation)
 {
   LogStartUp(_T("ReadWaypoints"));
   operation.SetText(_("Loading Waypoints..."));
 
-  bool found = false;
-
   // Delete old waypoints
   way_points.clear();
 
-  // ### FIRST FILE ###
-  found |= LoadWaypointFile(1, way_points, terrain, operation);
-
-  // ### SECOND FILE ###
-  found |= LoadWaypointFile(2, way_points, terrain, operation);
+  // ### FIRST, SECOND AND WATCHED WAYPOINT/THIRD FILE ###
+  WaypointFile files[3];
+  unsigned n = 0;
+  for (int num = 1; num <= 3; ++num) {
+    WaypointFile &file = files[n];
+    if (!GetPath(num, file.path))
+      continue;
+
+    file.num = num;
+    file.reader.Open(file.path, num);
+    if (file.reader.Error()) {
+      LogStartUp(_T("No waypoint file %d"), num);
+      continue;
+    }
+
+    ++n;
+  }
 
-  // ### WATCHED WAYPOINT/THIRD FILE ###
-  found |= LoadWaypointFile(3, way_points, terrain, operation);
+  bool found = LoadWaypointFiles(files, n, way_points, terrain, cache);
 
   // ### MAP/FOURTH FILE ###
 
   // If no waypoint file found yet
-  if (!found)
-    found = LoadMapFileWaypoints(0, szProfileMapFile, way_points, terrain,
-                                 operation);
+  if (!found) {
+    WaypointFile map_file;
+    map_file.num = 0;
+    if (OpenMapFileWaypoints(map_file, szProfileMapFile))
+      found = LoadWaypointFiles(&map_file, 1, way_points, terrain, cache);
+    else
+      LogStartUp(_T("No waypoint file in the map file"));
+  }
 
   // Optimise the waypoint list after attaching new waypoints
   way_points.optimise();
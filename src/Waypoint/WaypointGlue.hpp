@@ -29,6 +29,7 @@ Copyright_License {
 class Waypoints;
 class RasterTerrain;
 class OperationEnvironment;
+class FileCache;
 struct SETTINGS_COMPUTER;
 
 class WaypointReaderBase;
@@ -41,20 +42,18 @@ namespace WaypointGlue {
                SETTINGS_COMPUTER &settings, const bool reset);
 
   /**
-   * Reads the waypoints out of the two waypoint files and appends them to the
-   * specified waypoint list
+   * Reads the waypoints out of all configured waypoint files and
+   * appends them to the specified waypoint list.  The files are
+   * parsed concurrently.
+   *
    * @param way_points The waypoint list to fill
    * @param terrain RasterTerrain (for automatic waypoint height)
+   * @param cache an optional cache for the parsed waypoint files
    */
   bool LoadWaypoints(Waypoints &way_points,
                      const RasterTerrain *terrain,
+                     FileCache *cache,
                      OperationEnvironment &operation);
-  bool LoadWaypointFile(int num, Waypoints &way_points,
-                        const RasterTerrain *terrain,
-                        OperationEnvironment &operation);
-  bool LoadMapFileWaypoints(int num, const TCHAR* key,
-                            Waypoints &way_points, const RasterTerrain *terrain,
-                            OperationEnvironment &operation);
   bool SaveWaypoints(const Waypoints &way_points);
   bool SaveWaypointFile(const Waypoints &way_points, int num);
 };
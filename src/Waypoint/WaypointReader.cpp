@@ -44,6 +44,16 @@ WaypointReader::Parse(Waypoints &way_points, OperationEnvironment &operation)
   return reader->Parse(way_points, operation);
 }
 
+bool
+WaypointReader::Parse(ParsedWaypoints &parsed,
+                      OperationEnvironment &operation)
+{
+  if (reader == NULL)
+    return false;
+
+  return reader->Parse(parsed, operation);
+}
+
 void
 WaypointReader::SetTerrain(const RasterTerrain* _terrain)
 {
@@ -30,6 +30,7 @@ Copyright_License {
 #include <tchar.h>
 
 class Waypoints;
+struct ParsedWaypoints;
 class RasterTerrain;
 class OperationEnvironment;
 
@@ -64,6 +65,14 @@ public:
    */
   bool Parse(Waypoints &way_points, OperationEnvironment &operation);
 
+  /**
+   * Parses the waypoint file into a buffer, without looking up
+   * missing altitudes.
+   *
+   * @see WaypointReaderBase::Parse(ParsedWaypoints &, OperationEnvironment &)
+   */
+  bool Parse(ParsedWaypoints &parsed, OperationEnvironment &operation);
+
   /**
    * Returns whether there is a valid internal reader
    * that can be used for parsing the waypoint file.
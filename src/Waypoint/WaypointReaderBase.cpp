@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "WaypointReaderBase.hpp"
+#include "ParsedWaypoints.hpp"
 
 #include "Terrain/RasterTerrain.hpp"
 #include "Waypoint/Waypoint.hpp"
@@ -140,22 +141,7 @@ WaypointReaderBase::ExtractParameters(const TCHAR *src, TCHAR *dst,
 }
 
 void
-WaypointReaderBase::CheckAltitude(Waypoint &new_waypoint) const
-{
-  if (terrain == NULL)
-    return;
-
-  // Load waypoint altitude from terrain
-  const short t_alt = terrain->GetTerrainHeight(new_waypoint.location);
-  if (RasterBuffer::is_special(t_alt))
-    new_waypoint.altitude = fixed_zero;
-  else
-    // TERRAIN_VALID
-    new_waypoint.altitude = (fixed)t_alt;
-}
-
-void
-WaypointReaderBase::Parse(Waypoints &way_points, TLineReader &reader,
+WaypointReaderBase::Parse(ParsedWaypoints &parsed, TLineReader &reader,
                           OperationEnvironment &operation)
 {
   long filesize = std::max(reader.size(), 1l);
@@ -165,7 +151,7 @@ WaypointReaderBase::Parse(Waypoints &way_points, TLineReader &reader,
   TCHAR *line;
   for (unsigned i = 0; (line = reader.read()) != NULL; i++) {
     // and parse them
-    ParseLine(line, i, way_points);
+    ParseLine(line, i, parsed);
 
     if ((i & 0x3f) == 0)
       operation.SetProgressPosition(reader.tell() * 100 / filesize);
@@ -175,6 +161,21 @@ WaypointReaderBase::Parse(Waypoints &way_points, TLineReader &reader,
 bool
 WaypointReaderBase::Parse(Waypoints &way_points,
                           OperationEnvironment &operation)
+{
+  ParsedWaypoints parsed;
+  if (!Parse(parsed, operation))
+    return false;
+
+  if (terrain != NULL)
+    LookupAltitudes(&parsed, 1, *terrain);
+
+  parsed.CopyTo(way_points);
+  return true;
+}
+
+bool
+WaypointReaderBase::Parse(ParsedWaypoints &parsed,
+                          OperationEnvironment &operation)
 {
   // If no file loaded yet -> return false
   if (file[0] == 0)
@@ -186,14 +187,14 @@ WaypointReaderBase::Parse(Waypoints &way_points,
     if (reader.error())
       return false;
 
-    Parse(way_points, reader, operation);
+    Parse(parsed, reader, operation);
   } else {
     // convert path to ascii
     ZipLineReader reader(file, ConvertLineReader::AUTO);
     if (reader.error())
       return false;
 
-    Parse(way_points, reader, operation);
+    Parse(parsed, reader, operation);
   }
 
   return true;
@@ -28,6 +28,7 @@ Copyright_License {
 #include <tchar.h>
 
 struct Waypoint;
+struct ParsedWaypoints;
 class Waypoints;
 class RasterTerrain;
 class TLineReader;
@@ -57,7 +58,17 @@ public:
    * @return True if the waypoint file parsing was okay, False otherwise
    */
   bool Parse(Waypoints &way_points, OperationEnvironment &operation);
-  void Parse(Waypoints &way_points, TLineReader &reader,
+
+  /**
+   * Parses the waypoint file into a buffer.  Missing altitudes are
+   * not looked up in the terrain, they are only recorded in
+   * ParsedWaypoints::missing_altitudes.  Different readers may call
+   * this method concurrently.
+   *
+   * @return True if the waypoint file parsing was okay, False otherwise
+   */
+  bool Parse(ParsedWaypoints &parsed, OperationEnvironment &operation);
+  void Parse(ParsedWaypoints &parsed, TLineReader &reader,
              OperationEnvironment &operation);
 
   bool VerifyFormat() const;
@@ -70,19 +81,17 @@ public:
   }
 
 protected:
-  void CheckAltitude(Waypoint &new_waypoint) const;
-
   /**
    * Parse a file line
    * @param line The line to parse
    * @param linenum The line number in the file
-   * @param way_points The waypoint list to fill
-   * @param terrain RasterTerrain (for automatic waypoint height)
+   * @param parsed The waypoint list to fill; waypoints without an
+   * altitude are appended with missing_altitude=true
    * @return True if the line was parsed correctly or ignored, False if
    * parsing error occured
    */
   virtual bool ParseLine(const TCHAR* line, unsigned linenum,
-                         Waypoints &way_points) = 0;
+                         ParsedWaypoints &parsed) = 0;
 
 public:
   // Helper functions
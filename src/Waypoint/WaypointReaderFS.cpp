@@ -23,7 +23,7 @@ Copyright_License {
 
 #include "WaypointReaderFS.hpp"
 #include "Units/Units.hpp"
-#include "Waypoint/Waypoints.hpp"
+#include "ParsedWaypoints.hpp"
 #include "Geo/UTM.hpp"
 #include "IO/LineReader.hpp"
 
@@ -147,7 +147,7 @@ ParseString(const TCHAR *src, tstring &dest, unsigned len = 0)
 
 bool
 WaypointReaderFS::ParseLine(const TCHAR* line, const unsigned linenum,
-                              Waypoints &way_points)
+                              ParsedWaypoints &parsed)
 {
   //$FormatGEO
   //ACONCAGU  S 32 39 12.00    W 070 00 42.00  6962  Aconcagua
@@ -193,14 +193,14 @@ WaypointReaderFS::ParseLine(const TCHAR* line, const unsigned linenum,
   if (!ParseString(line, new_waypoint.name, 8))
     return false;
 
-  if (!ParseAltitude(line + (is_utm ? 32 : 41), new_waypoint.altitude))
-    CheckAltitude(new_waypoint);
+  const bool missing_altitude =
+    !ParseAltitude(line + (is_utm ? 32 : 41), new_waypoint.altitude);
 
   // Description (Characters 35-44)
   if (len > (is_utm ? 38 : 47))
     ParseString(line + (is_utm ? 38 : 47), new_waypoint.comment);
 
-  way_points.append(new_waypoint);
+  parsed.Append(new_waypoint, missing_altitude);
   return true;
 }
 
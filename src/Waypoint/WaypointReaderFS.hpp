@@ -44,7 +44,7 @@ public:
 
 protected:
   bool ParseLine(const TCHAR* line, const unsigned linenum,
-                 Waypoints &way_points);
+                 ParsedWaypoints &parsed);
 };
 
 #endif
@@ -22,7 +22,7 @@ Copyright_License {
 */
 
 #include "WaypointReaderOzi.hpp"
-#include "Waypoint/Waypoints.hpp"
+#include "ParsedWaypoints.hpp"
 #include "IO/LineReader.hpp"
 #include "Units/Units.hpp"
 #include "Util/Macros.hpp"
@@ -67,7 +67,7 @@ ParseString(const TCHAR *src, tstring &dest)
 
 bool
 WaypointReaderOzi::ParseLine(const TCHAR* line, const unsigned linenum,
-                              Waypoints &way_points)
+                              ParsedWaypoints &parsed)
 {
   if (line[0] == '\0')
     return true;
@@ -112,15 +112,15 @@ WaypointReaderOzi::ParseLine(const TCHAR* line, const unsigned linenum,
   if (!ParseString(params[1], new_waypoint.name))
     return false;
 
-  if (ParseNumber(params[14], value) && value != -777)
+  const bool missing_altitude =
+    !ParseNumber(params[14], value) || value == -777;
+  if (!missing_altitude)
     new_waypoint.altitude = Units::ToSysUnit(fixed(value), unFeet);
-  else
-    CheckAltitude(new_waypoint);
 
   // Description (Characters 35-44)
   ParseString(params[11], new_waypoint.comment);
 
-  way_points.append(new_waypoint);
+  parsed.Append(new_waypoint, missing_altitude);
   return true;
 }
 
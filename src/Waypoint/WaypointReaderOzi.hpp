@@ -42,7 +42,7 @@ public:
 
 protected:
   bool ParseLine(const TCHAR* line, const unsigned linenum,
-                 Waypoints &way_points);
+                 ParsedWaypoints &parsed);
 };
 
 #endif
@@ -23,14 +23,14 @@ Copyright_License {
 
 #include "WaypointReaderSeeYou.hpp"
 #include "Units/Units.hpp"
-#include "Waypoint/Waypoints.hpp"
+#include "ParsedWaypoints.hpp"
 #include "Util/Macros.hpp"
 
 #include <stdio.h>
 
 bool
 WaypointReaderSeeYou::ParseLine(const TCHAR* line, const unsigned linenum,
-                              Waypoints &way_points)
+                              ParsedWaypoints &parsed)
 {
   TCHAR ctemp[4096];
   const TCHAR *params[20];
@@ -102,9 +102,8 @@ WaypointReaderSeeYou::ParseLine(const TCHAR* line, const unsigned linenum,
 
   // Elevation (e.g. 458.0m)
   /// @todo configurable behaviour
-  if (iElevation >= n_params ||
-      !parseAltitude(params[iElevation], new_waypoint.altitude))
-    CheckAltitude(new_waypoint);
+  const bool missing_altitude = iElevation >= n_params ||
+    !parseAltitude(params[iElevation], new_waypoint.altitude);
 
   // Style (e.g. 5)
   /// @todo include peaks with peak symbols etc.
@@ -139,7 +138,7 @@ WaypointReaderSeeYou::ParseLine(const TCHAR* line, const unsigned linenum,
   if (iDescription < n_params)
     new_waypoint.comment = params[iDescription];
 
-  way_points.append(new_waypoint);
+  parsed.Append(new_waypoint, missing_altitude);
   return true;
 }
 
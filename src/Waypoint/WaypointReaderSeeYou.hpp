@@ -46,7 +46,7 @@ protected:
    * @see http://data.naviter.si/docs/cup_format.pdf
    */
   bool ParseLine(const TCHAR* line, const unsigned linenum,
-                 Waypoints &way_points);
+                 ParsedWaypoints &parsed);
 
 private:
   static bool parseAngle(const TCHAR* src, Angle& dest, const bool lat);
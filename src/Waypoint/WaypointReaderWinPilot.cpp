@@ -23,7 +23,7 @@ Copyright_License {
 
 #include "WaypointReaderWinPilot.hpp"
 #include "Units/Units.hpp"
-#include "Waypoint/Waypoints.hpp"
+#include "ParsedWaypoints.hpp"
 #include "IO/TextWriter.hpp"
 #include "Util/Macros.hpp"
 
@@ -31,7 +31,7 @@ Copyright_License {
 
 bool
 WaypointReaderWinPilot::ParseLine(const TCHAR* line, const unsigned linenum,
-                                Waypoints &way_points)
+                                ParsedWaypoints &parsed)
 {
   TCHAR ctemp[4096];
   const TCHAR *params[20];
@@ -86,8 +86,8 @@ WaypointReaderWinPilot::ParseLine(const TCHAR* line, const unsigned linenum,
 
   // Altitude (e.g. 458M)
   /// @todo configurable behaviour
-  if (!parseAltitude(params[3], new_waypoint.altitude))
-    CheckAltitude(new_waypoint);
+  const bool missing_altitude =
+    !parseAltitude(params[3], new_waypoint.altitude);
 
   if (n_params > 6) {
     // Description (e.g. 119.750 Airport)
@@ -99,7 +99,7 @@ WaypointReaderWinPilot::ParseLine(const TCHAR* line, const unsigned linenum,
   // Waypoint Flags (e.g. AT)
   parseFlags(params[4], new_waypoint);
 
-  way_points.append(new_waypoint);
+  parsed.Append(new_waypoint, missing_altitude);
   return true;
 }
 
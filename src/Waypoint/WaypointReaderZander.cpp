@@ -23,13 +23,13 @@ Copyright_License {
 
 #include "WaypointReaderZander.hpp"
 #include "Units/Units.hpp"
-#include "Waypoint/Waypoints.hpp"
+#include "ParsedWaypoints.hpp"
 
 #include <stdio.h>
 
 bool
 WaypointReaderZander::ParseLine(const TCHAR* line, const unsigned linenum,
-                              Waypoints &way_points)
+                              ParsedWaypoints &parsed)
 {
   // If (end-of-file or comment)
   if (line[0] == '\0' || line[0] == 0x1a ||
@@ -66,8 +66,8 @@ WaypointReaderZander::ParseLine(const TCHAR* line, const unsigned linenum,
 
   // Altitude (Characters 30-34 // e.g. 1561 (in meters))
   /// @todo configurable behaviour
-  if (!parseAltitude(line + 30, new_waypoint.altitude))
-    CheckAltitude(new_waypoint);
+  const bool missing_altitude =
+    !parseAltitude(line + 30, new_waypoint.altitude);
 
   // Description (Characters 35-44)
   if (len > 35)
@@ -78,7 +78,7 @@ WaypointReaderZander::ParseLine(const TCHAR* line, const unsigned linenum,
     if (len < 36 || !parseFlagsFromDescription(line + 35, new_waypoint))
       new_waypoint.flags.turn_point = true;
 
-  way_points.append(new_waypoint);
+  parsed.Append(new_waypoint, missing_altitude);
   return true;
 }
 
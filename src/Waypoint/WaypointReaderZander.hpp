@@ -40,7 +40,7 @@ public:
 
 protected:
   bool ParseLine(const TCHAR* line, const unsigned linenum,
-                 Waypoints &way_points);
+                 ParsedWaypoints &parsed);
 
 private:
   static bool parseString(const TCHAR* src, tstring& dest, unsigned len);
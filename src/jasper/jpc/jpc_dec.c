@@ -1232,20 +1232,24 @@ static int jpc_dec_tiledecode(jpc_dec_t *dec, jpc_dec_tile_t *tile)
 	for (compno = 0, tcomp = tile->tcomps, cmpt = dec->cmpts; compno <
 	  dec->numcomps; ++compno, ++tcomp, ++cmpt) {
 		int x, y, xx, yy, iw, ih;
+		unsigned bits;
+		int step;
 		x = tcomp->xstart - JPC_CEILDIV(dec->xstart, cmpt->hstep);
 		y = tcomp->ystart - JPC_CEILDIV(dec->ystart, cmpt->vstep);
 
 		switch (dec->xcsoar) {
 		case 2:
 			dptr = jas_rtc_GetOverview();
-			iw = dec->cmpts->width/16;
-			ih = dec->cmpts->height/16;
+			bits = jas_rtc_GetOverviewBits();
+			step = 1 << bits;
+			iw = dec->cmpts->width >> bits;
+			ih = dec->cmpts->height >> bits;
 			if (dptr) {
-				for (i = 0; i < jas_matrix_numrows(tcomp->data); i+= 16) {
-					for (j = 0; j < jas_matrix_numcols(tcomp->data); j+= 16) {
+				for (i = 0; i < jas_matrix_numrows(tcomp->data); i+= step) {
+					for (j = 0; j < jas_matrix_numcols(tcomp->data); j+= step) {
 						short d = jas_matrix_get(tcomp->data, i, j);
-						xx = (j+tcomp->xstart)/16;
-						yy = (i+tcomp->ystart)/16;
+						xx = (j+tcomp->xstart) >> bits;
+						yy = (i+tcomp->ystart) >> bits;
 						if ((xx<iw)&&(yy<ih)) {
 							dptr[xx+iw*yy]= d;
 						}
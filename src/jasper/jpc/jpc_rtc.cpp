@@ -43,4 +43,8 @@ extern "C" {
   short* jas_rtc_GetOverview(void) {
     return raster_tile_current->GetOverview();
   }
+
+  unsigned jas_rtc_GetOverviewBits(void) {
+    return RasterTileCache::GetOverviewBits();
+  }
 };
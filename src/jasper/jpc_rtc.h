@@ -28,6 +28,13 @@ extern "C" {
   gcc_const
   short* jas_rtc_GetOverview(void);
 
+  /**
+   * The width and height of the image are shifted by this number of
+   * bits to determine the size of the overview buffer.
+   */
+  gcc_const
+  unsigned jas_rtc_GetOverviewBits(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,237 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+/*
+ * Compares the packed R-tree airspace index with the kd-tree it
+ * replaced, on the envelopes of the airspaces loaded from an OpenAir
+ * file.  Both indexes must return the same range query results.
+ *
+ * The kd-tree's nearest search used a metric which compares
+ * corresponding corners of the boxes instead of their gap, so its
+ * nearest results are only timed; the R-tree's are checked against a
+ * linear scan.
+ */
+
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Navigation/Flat/PackedRTree.hpp"
+#include "IO/FileLineReader.hpp"
+#include "Operation.hpp"
+
+#include <kdtree++/kdtree.hpp>
+
+#include <algorithm>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef KDTree::KDTree<4,
+                       Airspace,
+                       FlatBoundingBox::kd_get_bounds,
+                       FlatBoundingBox::kd_distance,
+                       std::less<FlatBoundingBox::kd_get_bounds::result_type>
+                       > OldTree;
+
+typedef PackedRTree<Airspace> NewTree;
+
+typedef std::vector<Airspace> AirspaceVector;
+typedef std::vector<const AbstractAirspace *> AirspacePointerVector;
+
+struct Query {
+  GeoPoint location;
+  fixed range;
+};
+
+struct AlwaysTrue {
+  bool operator()(const Airspace &as) const {
+    return true;
+  }
+};
+
+static double
+ToMilliseconds(clock_t duration)
+{
+  return duration * 1000. / CLOCKS_PER_SEC;
+}
+
+static AirspacePointerVector
+ToPointers(const AirspaceVector &v)
+{
+  AirspacePointerVector result;
+  for (AirspaceVector::const_iterator i = v.begin(); i != v.end(); ++i)
+    result.push_back(i->get_airspace());
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "Usage: %s PATH [QUERIES]\n", argv[0]);
+    return 1;
+  }
+
+  const unsigned n_queries = argc > 2 ? atoi(argv[2]) : 100000;
+
+  FileLineReader reader(argv[1], ConvertLineReader::AUTO);
+  if (reader.error()) {
+    fprintf(stderr, "Failed to open input file\n");
+    return 1;
+  }
+
+  Airspaces airspaces;
+  AirspaceParser parser(airspaces);
+
+  NullOperationEnvironment operation;
+  if (!parser.Parse(reader, operation)) {
+    fprintf(stderr, "Failed to parse input file\n");
+    return 1;
+  }
+
+  airspaces.optimise();
+
+  if (airspaces.empty()) {
+    fprintf(stderr, "No airspaces\n");
+    return 1;
+  }
+
+  const TaskProjection &projection = airspaces.get_task_projection();
+  const AirspaceVector envelopes(airspaces.begin(), airspaces.end());
+
+  /* build both indexes */
+
+  clock_t start = clock();
+  OldTree old_tree;
+  for (AirspaceVector::const_iterator i = envelopes.begin();
+       i != envelopes.end(); ++i)
+    old_tree.insert(*i);
+  old_tree.optimise();
+  const clock_t old_build = clock() - start;
+
+  start = clock();
+  NewTree new_tree;
+  for (AirspaceVector::const_iterator i = envelopes.begin();
+       i != envelopes.end(); ++i)
+    new_tree.insert(*i);
+  new_tree.optimise();
+  const clock_t new_build = clock() - start;
+
+  /* random queries in the area of the airspaces */
+
+  const FlatBoundingBox::kd_get_bounds bounds;
+  int x_min = bounds(envelopes.front(), 0), y_min = bounds(envelopes.front(), 1);
+  int x_max = bounds(envelopes.front(), 2), y_max = bounds(envelopes.front(), 3);
+  for (AirspaceVector::const_iterator i = envelopes.begin();
+       i != envelopes.end(); ++i) {
+    x_min = std::min(x_min, bounds(*i, 0));
+    y_min = std::min(y_min, bounds(*i, 1));
+    x_max = std::max(x_max, bounds(*i, 2));
+    y_max = std::max(y_max, bounds(*i, 3));
+  }
+
+  /* include some area around the airspaces for the nearest queries */
+  const int x_margin = (x_max - x_min) / 4, y_margin = (y_max - y_min) / 4;
+  x_min -= x_margin;
+  x_max += x_margin;
+  y_min -= y_margin;
+  y_max += y_margin;
+
+  srand(42);
+  std::vector<Query> queries(n_queries);
+  for (std::vector<Query>::iterator q = queries.begin(); q != queries.end(); ++q) {
+    const FlatGeoPoint p(x_min + rand() % (x_max - x_min + 1),
+                         y_min + rand() % (y_max - y_min + 1));
+    q->location = projection.unproject(p);
+    /* half of the queries are point queries */
+    q->range = rand() % 2 ? fixed(rand() % 20000) : fixed_zero;
+  }
+
+  /* range queries */
+
+  unsigned old_found = 0, new_found = 0, mismatches = 0;
+  clock_t old_range = 0, new_range = 0;
+  for (std::vector<Query>::const_iterator q = queries.begin();
+       q != queries.end(); ++q) {
+    AirspaceVector old_result, new_result;
+
+    start = clock();
+    const Airspace old_target(q->location, projection);
+    const int mrange = projection.project_range(q->location, q->range);
+    old_tree.find_within_range(old_target, -mrange,
+                               std::back_inserter(old_result));
+    old_range += clock() - start;
+
+    start = clock();
+    const Airspace new_target(q->location, projection, q->range);
+    new_tree.find_overlapping(new_target, std::back_inserter(new_result));
+    new_range += clock() - start;
+
+    old_found += old_result.size();
+    new_found += new_result.size();
+    if (ToPointers(old_result) != ToPointers(new_result))
+      ++mismatches;
+  }
+
+  /* nearest queries */
+
+  unsigned old_differs = 0;
+  clock_t old_nearest = 0, new_nearest = 0;
+  for (std::vector<Query>::const_iterator q = queries.begin();
+       q != queries.end(); ++q) {
+    const Airspace target(q->location, projection);
+
+    start = clock();
+    std::pair<OldTree::const_iterator, OldTree::distance_type> old_result =
+      old_tree.find_nearest(target);
+    old_nearest += clock() - start;
+
+    start = clock();
+    std::pair<NewTree::const_iterator, unsigned> new_result =
+      new_tree.find_nearest_if(target, 0 - 1, AlwaysTrue());
+    new_nearest += clock() - start;
+
+    unsigned nearest = 0 - 1;
+    for (AirspaceVector::const_iterator i = envelopes.begin();
+         i != envelopes.end(); ++i)
+      nearest = std::min(nearest, i->distance(target));
+
+    if (new_result.second != nearest)
+      ++mismatches;
+    if (old_result.first->distance(target) != nearest)
+      ++old_differs;
+  }
+
+  printf("%u airspaces, %u queries\n",
+         (unsigned)envelopes.size(), n_queries);
+  printf("%-8s build %8.3f ms  range %8.1f ms (%u found)  nearest %8.1f ms (%u not nearest)\n",
+         "kd-tree", ToMilliseconds(old_build),
+         ToMilliseconds(old_range), old_found,
+         ToMilliseconds(old_nearest), old_differs);
+  printf("%-8s build %8.3f ms  range %8.1f ms (%u found)  nearest %8.1f ms\n",
+         "R-tree", ToMilliseconds(new_build),
+         ToMilliseconds(new_range), new_found,
+         ToMilliseconds(new_nearest));
+  printf("%u mismatches\n", mismatches);
+
+  return mismatches != 0;
+}
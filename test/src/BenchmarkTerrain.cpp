@@ -0,0 +1,150 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2010 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * This program measures terrain height queries: GetHeight() for each
+ * location versus one GetHeights() call, for locations in random
+ * order (like a waypoint file) and along rings (like the reach fan).
+ * Build it with DEBUG=n, so the terrain code is optimised like in a
+ * release build.
+ */
+
+#include "Terrain/RasterMap.hpp"
+#include "OS/PathName.hpp"
+#include "Compatibility/path.h"
+#include "Operation.hpp"
+
+#include <vector>
+#include <algorithm>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <tchar.h>
+
+static const unsigned N_LOCATIONS = 20000;
+static const unsigned N_ROUNDS = 50;
+
+static void
+MakeRandom(const GeoBounds &bounds, std::vector<GeoPoint> &locations)
+{
+  locations.clear();
+  for (unsigned i = 0; i < N_LOCATIONS; ++i) {
+    const fixed fx = fixed(rand() % 10000) / 10000;
+    const fixed fy = fixed(rand() % 10000) / 10000;
+    locations.push_back(GeoPoint(bounds.west + (bounds.east - bounds.west) * fx,
+                                 bounds.south +
+                                 (bounds.north - bounds.south) * fy));
+  }
+}
+
+static void
+MakeRings(const GeoBounds &bounds, std::vector<GeoPoint> &locations)
+{
+  const GeoPoint center = bounds.center();
+  const unsigned n_rings = 50, n_points = N_LOCATIONS / n_rings;
+
+  locations.clear();
+  for (unsigned i = 0; i < n_rings; ++i) {
+    const fixed radius = fixed(i + 1) / (2 * n_rings);
+    for (unsigned j = 0; j < n_points; ++j) {
+      const Angle angle = Angle::degrees(fixed(j * 360) / n_points);
+      locations.push_back(GeoPoint(center.Longitude +
+                                   (bounds.east - bounds.west) *
+                                   (radius * angle.cos()),
+                                   center.Latitude +
+                                   (bounds.north - bounds.south) *
+                                   (radius * angle.sin())));
+    }
+  }
+}
+
+/**
+ * @param batch the number of locations per GetHeights() call
+ */
+static void
+Benchmark(const char *name, const RasterMap &map,
+          const std::vector<GeoPoint> &locations, unsigned batch)
+{
+  const unsigned n = locations.size();
+  std::vector<short> single(n), heights(n);
+
+  clock_t t = clock();
+  for (unsigned round = 0; round < N_ROUNDS; ++round)
+    for (unsigned i = 0; i < n; ++i)
+      single[i] = map.GetHeight(locations[i]);
+  const clock_t t_single = clock() - t;
+
+  t = clock();
+  for (unsigned round = 0; round < N_ROUNDS; ++round)
+    for (unsigned i = 0; i < n; i += batch)
+      map.GetHeights(&locations[i], &heights[i], std::min(batch, n - i));
+  const clock_t t_batch = clock() - t;
+
+  const double scale = 1e9 / CLOCKS_PER_SEC / N_ROUNDS / n;
+  printf("%-8s batch %5u  GetHeight %6.1f ns  GetHeights %6.1f ns  %s\n",
+         name, batch, t_single * scale, t_batch * scale,
+         single == heights ? "same" : "DIFFERENT");
+}
+
+int main(int argc, char **argv)
+{
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s PATH\n", argv[0]);
+    return 1;
+  }
+
+  const char *map_path = argv[1];
+
+  TCHAR jp2_path[4096];
+  _tcscpy(jp2_path, PathName(map_path));
+  _tcscat(jp2_path, _T(DIR_SEPARATOR_S) _T("terrain.jp2"));
+
+  TCHAR j2w_path[4096];
+  _tcscpy(j2w_path, PathName(map_path));
+  _tcscat(j2w_path, _T(DIR_SEPARATOR_S) _T("terrain.j2w"));
+
+  NullOperationEnvironment operation;
+  RasterMap map(jp2_path, j2w_path, NULL, operation);
+  if (!map.isMapLoaded()) {
+    fprintf(stderr, "Failed to load the terrain\n");
+    return EXIT_FAILURE;
+  }
+
+  do {
+    map.SetViewCenter(map.GetMapCenter(), fixed(100000));
+  } while (map.IsDirty());
+
+  srand(42);
+
+  std::vector<GeoPoint> locations;
+  MakeRandom(map.GetBounds(), locations);
+  Benchmark("random", map, locations, N_LOCATIONS);
+  Benchmark("random", map, locations, 64);
+
+  MakeRings(map.GetBounds(), locations);
+  Benchmark("rings", map, locations, N_LOCATIONS);
+  Benchmark("rings", map, locations, 64);
+
+  return EXIT_SUCCESS;
+}
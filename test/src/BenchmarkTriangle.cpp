@@ -0,0 +1,192 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+/*
+ * Compares the branch-and-bound triangle search in OLCTriangle with
+ * the Dijkstra search it replaced, both incrementally during the
+ * replay and exhaustively on the final trace.
+ */
+
+#include "Engine/Trace/Trace.hpp"
+#include "Contest/ContestSolvers/OLCTriangle.hpp"
+#include "Contest/ContestSolvers/TriangleSecondLeg.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "Args.hpp"
+#include "DebugReplay.hpp"
+#include "NMEA/Aircraft.hpp"
+
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * The former OLCTriangle search: the Dijkstra queue visits all pairs
+ * of turn points.
+ */
+class DijkstraTriangle : public OLCTriangle {
+public:
+  DijkstraTriangle(const Trace &_trace, bool _is_fai)
+    :OLCTriangle(_trace, _is_fai) {}
+
+  virtual bool Solve(bool exhaustive) {
+    return ContestDijkstra::Solve(exhaustive);
+  }
+
+  virtual bool IsBusy() const {
+    return ContestDijkstra::IsBusy();
+  }
+
+protected:
+  virtual void add_edges(const ScanTaskPoint &origin);
+
+private:
+  virtual void add_start_edges();
+};
+
+void
+DijkstraTriangle::add_start_edges()
+{
+  dijkstra.pop();
+  ScanTaskPoint destination(0, n_points-1);
+  dijkstra.link(destination, destination, 0);
+}
+
+void
+DijkstraTriangle::add_edges(const ScanTaskPoint &origin)
+{
+  ScanTaskPoint destination(origin.stage_number + 1, origin.point_index + 1);
+
+  switch (destination.stage_number) {
+  case 1:
+    for (destination.point_index = 0;
+         destination.point_index < origin.point_index;
+         ++destination.point_index) {
+      const unsigned d = distance(origin, destination);
+      if (!is_fai || (4*d >= best_d))
+        dijkstra.link(destination, origin,
+                      get_weighting(origin.stage_number) * d);
+    }
+    break;
+
+  case 2: {
+    ScanTaskPoint previous = dijkstra.get_predecessor(origin);
+    TriangleSecondLeg sl(is_fai, GetPointFast(previous), GetPointFast(origin));
+    for (; destination.point_index < n_points-1; ++destination.point_index) {
+      TriangleSecondLeg::Result result = sl.Calculate(GetPointFast(destination),
+                                                      best_d);
+      const unsigned d = result.leg_distance;
+      if (d) {
+        best_d = result.total_distance;
+        dijkstra.link(destination, origin,
+                      get_weighting(origin.stage_number) * d);
+        is_complete = true;
+        is_closed = false;
+        first_tp = origin.point_index;
+      }
+    }
+  }
+    break;
+
+  case 3:
+    destination.point_index = n_points - 1;
+    dijkstra.link(destination, origin, 0);
+    break;
+  }
+}
+
+struct Solver {
+  const char *name;
+  OLCTriangle &triangle;
+  ContestResult result;
+  clock_t duration;
+
+  Solver(const char *_name, OLCTriangle &_triangle)
+    :name(_name), triangle(_triangle), duration(0) {
+    result.Reset();
+  }
+
+  void Run(bool exhaustive) {
+    const clock_t start = clock();
+    if (triangle.Solve(exhaustive))
+      triangle.Score(result);
+    duration += clock() - start;
+  }
+
+  void Print() const {
+    printf("%-24s score %8.3f distance %8.3f km  %8.1f ms\n", name,
+           (double)result.score, (double)result.distance / 1000,
+           duration * 1000. / CLOCKS_PER_SEC);
+  }
+};
+
+static void
+BenchmarkTriangle(DebugReplay &replay)
+{
+  Trace trace(60);
+
+  DijkstraTriangle dijkstra_fai(trace, true), dijkstra_flat(trace, false);
+  OLCTriangle bnb_fai(trace, true), bnb_flat(trace, false);
+
+  Solver solvers[] = {
+    Solver("FAI dijkstra", dijkstra_fai),
+    Solver("FAI branch-and-bound", bnb_fai),
+    Solver("flat dijkstra", dijkstra_flat),
+    Solver("flat branch-and-bound", bnb_flat),
+  };
+  const unsigned n_solvers = sizeof(solvers) / sizeof(solvers[0]);
+
+  while (replay.Next()) {
+    trace.append(ToAircraftState(replay.Basic(), replay.Calculated()));
+    trace.optimise_if_old();
+
+    for (unsigned i = 0; i < n_solvers; ++i)
+      solvers[i].Run(false);
+  }
+
+  printf("incremental (%u trace points)\n", trace.size());
+  for (unsigned i = 0; i < n_solvers; ++i)
+    solvers[i].Print();
+
+  printf("exhaustive\n");
+  for (unsigned i = 0; i < n_solvers; ++i) {
+    solvers[i].triangle.Reset();
+    solvers[i].result.Reset();
+    solvers[i].duration = 0;
+    solvers[i].Run(true);
+    solvers[i].Print();
+  }
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "FILE.igc ...");
+
+  do {
+    DebugReplay *replay = CreateDebugReplay(args);
+    if (replay == NULL)
+      return EXIT_FAILURE;
+
+    BenchmarkTriangle(*replay);
+    delete replay;
+  } while (!args.IsEmpty());
+
+  return EXIT_SUCCESS;
+}
@@ -29,7 +29,8 @@ Copyright_License {
 #include "Device/NullPort.hpp"
 #include "Device/Parser.hpp"
 #include "Profile/DeviceConfig.hpp"
-#include "Replay/IGCParser.hpp"
+#include "Replay/IGCFixArray.hpp"
+#include "OS/PathName.hpp"
 
 static DeviceConfig config;
 static NullPort port;
@@ -118,10 +119,30 @@ DebugReplayNMEA::Next()
   return false;
 }
 
+/**
+ * Replays an IGC file.  The whole file is decoded by #IGCFixArray
+ * when it is opened, instead of line by line.
+ */
 class DebugReplayIGC : public DebugReplay {
+  IGCFixArray fixes;
+
+  unsigned next_fix;
+
 public:
-  DebugReplayIGC(NLineReader *reader)
-    :DebugReplay(reader) {}
+  DebugReplayIGC()
+    :DebugReplay(NULL), next_fix(0) {}
+
+  bool Load(const TCHAR *path) {
+    return fixes.Load(path);
+  }
+
+  virtual long Size() const {
+    return fixes.size();
+  }
+
+  virtual long Tell() const {
+    return next_fix;
+  }
 
   virtual bool Next();
 
@@ -132,23 +153,18 @@ protected:
 bool
 DebugReplayIGC::Next()
 {
+  if (next_fix >= fixes.size())
+    return false;
+
   last_basic = basic;
   last_calculated = calculated;
 
-  const char *line;
-  while ((line = reader->read()) != NULL) {
-    if (line[0] == 'B') {
-      IGCFix fix;
-      if (IGCParseFix(line, fix)) {
-        CopyFromFix(fix);
-
-        Compute();
-        return true;
-      }
-    }
-  }
+  IGCFix fix;
+  fixes.Get(next_fix++, fix);
+  CopyFromFix(fix);
 
-  return false;
+  Compute();
+  return true;
 }
 
 void
@@ -156,9 +172,18 @@ DebugReplayIGC::CopyFromFix(const IGCFix &fix)
 {
   basic.clock = basic.time = fixed(fix.time.GetSecondOfDay());
   basic.time_available.Update(basic.clock);
-  basic.date_time_utc.year = 2011;
-  basic.date_time_utc.month = 6;
-  basic.date_time_utc.day = 5;
+
+  const BrokenDate *date = fixes.GetDate();
+  if (date != NULL) {
+    basic.date_time_utc.year = date->year;
+    basic.date_time_utc.month = date->month;
+    basic.date_time_utc.day = date->day;
+  } else {
+    basic.date_time_utc.year = 2011;
+    basic.date_time_utc.month = 6;
+    basic.date_time_utc.day = 5;
+  }
+
   basic.date_time_utc.hour = fix.time.hour;
   basic.date_time_utc.minute = fix.time.minute;
   basic.date_time_utc.second = fix.time.second;
@@ -170,34 +195,36 @@ DebugReplayIGC::CopyFromFix(const IGCFix &fix)
   basic.pressure_altitude = basic.baro_altitude = fix.pressure_altitude;
   basic.pressure_altitude_available.Update(basic.clock);
   basic.baro_altitude_available.Update(basic.clock);
-}
-
-DebugReplay *
-CreateDebugReplay(Args &args)
-{
-  if (!args.IsEmpty() && strstr(args.PeekNext(), ".igc") != NULL) {
-    const char *input_file = args.ExpectNext();
-
-    FileLineReaderA *reader = new FileLineReaderA(input_file);
-    if (reader->error()) {
-      delete reader;
-      fprintf(stderr, "Failed to open %s\n", input_file);
-      return NULL;
-    }
 
-    return new DebugReplayIGC(reader);
+  if (fix.enl >= 0) {
+    basic.engine_noise_level = fix.enl;
+    basic.engine_noise_level_available.Update(basic.clock);
   }
 
-  const tstring driver_name = args.ExpectNextT();
+  if (fix.siu >= 0)
+    basic.gps.satellites_used = fix.siu;
+}
 
-  const struct DeviceRegister *driver = FindDriverByName(driver_name.c_str());
-  if (driver == NULL) {
-    _ftprintf(stderr, _T("No such driver: %s\n"), driver_name.c_str());
+DebugReplay *
+CreateDebugReplayIGC(const char *input_file)
+{
+  DebugReplayIGC *replay = new DebugReplayIGC();
+#ifdef _UNICODE
+  if (!replay->Load(PathName(input_file))) {
+#else
+  if (!replay->Load(input_file)) {
+#endif
+    delete replay;
+    fprintf(stderr, "Failed to open %s\n", input_file);
     return NULL;
   }
 
-  const char *input_file = args.ExpectNext();
+  return replay;
+}
 
+DebugReplay *
+CreateDebugReplayNMEA(const char *input_file, const DeviceRegister *driver)
+{
   FileLineReaderA *reader = new FileLineReaderA(input_file);
   if (reader->error()) {
     delete reader;
@@ -207,3 +234,21 @@ CreateDebugReplay(Args &args)
 
   return new DebugReplayNMEA(reader, driver);
 }
+
+DebugReplay *
+CreateDebugReplay(Args &args)
+{
+  if (!args.IsEmpty() && strstr(args.PeekNext(), ".igc") != NULL)
+    return CreateDebugReplayIGC(args.ExpectNext());
+
+  const tstring driver_name = args.ExpectNextT();
+
+  const struct DeviceRegister *driver = FindDriverByName(driver_name.c_str());
+  if (driver == NULL) {
+    _ftprintf(stderr, _T("No such driver: %s\n"), driver_name.c_str());
+    return NULL;
+  }
+
+  const char *input_file = args.ExpectNext();
+  return CreateDebugReplayNMEA(input_file, driver);
+}
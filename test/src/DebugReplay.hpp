@@ -54,10 +54,10 @@ public:
   virtual ~DebugReplay();
 
   gcc_pure
-  long Size() const;
+  virtual long Size() const;
 
   gcc_pure
-  long Tell() const;
+  virtual long Tell() const;
 
   virtual bool Next() = 0;
 
@@ -92,4 +92,17 @@ protected:
 DebugReplay *
 CreateDebugReplay(Args &args);
 
+/**
+ * Opens an IGC file for replay.  Returns NULL on error.
+ */
+DebugReplay *
+CreateDebugReplayIGC(const char *input_file);
+
+/**
+ * Opens a NMEA file for replay, parsed by the given driver (and by
+ * the generic NMEA parser).  Returns NULL on error.
+ */
+DebugReplay *
+CreateDebugReplayNMEA(const char *input_file, const DeviceRegister *driver);
+
 #endif
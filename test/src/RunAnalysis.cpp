@@ -132,7 +132,7 @@ LoadFiles(Airspaces &airspace_database)
   terrain = RasterTerrain::OpenTerrain(NULL, operation);
 
   AtmosphericPressure pressure;
-  ReadAirspace(airspace_database, terrain, pressure, operation);
+  ReadAirspace(airspace_database, terrain, pressure, NULL, operation);
 }
 
 static void
@@ -0,0 +1,597 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+/*
+ * Runs the GlideComputer over a set of recorded flights (IGC or NMEA
+ * files, or directories containing them) and prints one line of
+ * statistics per flight.  The flights are independent of each other,
+ * and are replayed concurrently, as fast as the CPU allows.
+ */
+
+#include "DebugReplay.hpp"
+#include "Args.hpp"
+#include "Device/Register.hpp"
+#include "Airspace/AirspaceParser.hpp"
+#include "Airspace/ProtectedAirspaceWarningManager.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceWarningManager.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Computer/GlideComputer.hpp"
+#include "Computer/GlideComputerInterface.hpp"
+#include "Task/ProtectedTaskManager.hpp"
+#include "Util/Deserialiser.hpp"
+#include "Util/DataNodeXML.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/PathName.hpp"
+#include "OS/Clock.hpp"
+#include "Thread/ThreadPool.hpp"
+#include "Operation.hpp"
+#include "Util/tstring.hpp"
+
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* fake symbols: */
+
+#include "ConditionMonitor.hpp"
+#include "InputEvents.hpp"
+#include "Logger/Logger.hpp"
+#include "ThermalBase.hpp"
+#include "LocalTime.hpp"
+#include "Task/TaskFile.hpp"
+#include "LocalPath.hpp"
+
+void
+LocalPath(TCHAR *buffer, const TCHAR *file)
+{
+  _tcscpy(buffer, file);
+}
+
+TaskFile*
+TaskFile::Create(const TCHAR* path)
+{
+  return NULL;
+}
+
+void ConditionMonitorsUpdate(const GlideComputer &cmp) {}
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+bool InputEvents::processNmea(unsigned key) { return true; }
+void Logger::LogStartEvent(const NMEAInfo &gps_info) {}
+void Logger::LogFinishEvent(const NMEAInfo &gps_info) {}
+void Logger::LogPoint(const NMEAInfo &gps_info) {}
+
+Waypoints way_points;
+
+int GetUTCOffset() { return 0; }
+
+void
+EstimateThermalBase(const GeoPoint Thermal_Location,
+                    const fixed altitude, const fixed wthermal,
+                    const SpeedVector wind,
+                    GeoPoint &ground_location, fixed &ground_alt) {}
+
+/* done with fake symbols. */
+
+/**
+ * The settings which are shared by all flights.
+ */
+struct BatchSettings {
+  SETTINGS_COMPUTER settings_computer;
+
+  /** Call ProcessIdle() after this number of GPS fixes */
+  unsigned idle_interval;
+
+  const DeviceRegister *driver;
+
+  const TCHAR *task_path;
+  const TCHAR *airspace_path;
+
+  const Waypoints *way_points;
+};
+
+/**
+ * One recorded flight, and the results of its analysis.
+ */
+struct BatchFlight {
+  std::string path;
+  long size;
+
+  bool success;
+
+  unsigned fixes, airspace_warnings;
+  unsigned duration_ms;
+
+  FlyingState flight;
+  CirclingInfo circling;
+  fixed last_thermal_average;
+  fixed max_thermal_height;
+
+  bool wind_available;
+  SpeedVector wind;
+
+  ContestResult contest;
+
+  bool task_valid, task_finished;
+  fixed task_distance, task_speed;
+
+  BatchFlight(const std::string &_path, long _size)
+    :path(_path), size(_size), success(false),
+     fixes(0), airspace_warnings(0), duration_ms(0) {}
+
+  bool operator<(const BatchFlight &other) const {
+    return path < other.path;
+  }
+
+  /**
+   * Ordering for the job queue: the largest file first, so a big
+   * flight that gets picked up last does not delay the whole batch.
+   */
+  static bool LargerThan(const BatchFlight &a, const BatchFlight &b) {
+    return a.size > b.size;
+  }
+
+  void Copy(const DerivedInfo &calculated) {
+    flight = calculated.flight;
+    circling = calculated;
+    last_thermal_average = calculated.last_thermal_average_smooth;
+    max_thermal_height = calculated.thermal_band.MaxThermalHeight;
+    wind_available = calculated.wind_available;
+    wind = calculated.wind;
+    contest = calculated.contest_stats.get_contest_result();
+    task_valid = calculated.task_stats.task_valid;
+    task_finished = calculated.task_stats.task_finished;
+    task_distance = calculated.task_stats.total.travelled.get_distance();
+    task_speed = calculated.task_stats.total.travelled.get_speed();
+  }
+};
+
+static bool
+HasExtension(const char *path, const char *extension)
+{
+  const size_t path_length = strlen(path);
+  const size_t extension_length = strlen(extension);
+  if (path_length < extension_length)
+    return false;
+
+  path += path_length - extension_length;
+  for (size_t i = 0; i < extension_length; ++i)
+    if (tolower((unsigned char)path[i]) != extension[i])
+      return false;
+
+  return true;
+}
+
+static DebugReplay *
+OpenReplay(const BatchFlight &flight, const DeviceRegister *driver)
+{
+  const char *path = flight.path.c_str();
+  return HasExtension(path, ".igc")
+    ? CreateDebugReplayIGC(path)
+    : CreateDebugReplayNMEA(path, driver);
+}
+
+static bool
+LoadAirspaces(Airspaces &airspaces, const TCHAR *path)
+{
+  FileLineReader reader(path, ConvertLineReader::AUTO);
+  if (reader.error())
+    return false;
+
+  AirspaceParser parser(airspaces);
+  NullOperationEnvironment operation;
+  if (!parser.Parse(reader, operation))
+    return false;
+
+  airspaces.optimise();
+  return true;
+}
+
+static bool
+LoadTask(ProtectedTaskManager &protected_task_manager, const TCHAR *path)
+{
+  DataNode *root = DataNodeXML::load(path);
+  if (root == NULL)
+    return false;
+
+  OrderedTask *task = protected_task_manager.task_blank();
+  Deserialiser des(*root);
+  des.deserialise(*task);
+  delete root;
+
+  const bool success = task->check_task() &&
+    protected_task_manager.task_commit(*task);
+  delete task;
+  return success;
+}
+
+/**
+ * Replays one flight through a private GlideComputer instance.
+ * Nothing is shared with the other flights except the read-only
+ * settings and waypoints; the airspace database is loaded per flight
+ * because the warning manager modifies it.
+ */
+static void
+AnalyseFlight(BatchFlight &flight, const BatchSettings &settings)
+{
+  const unsigned start_ms = MonotonicClockMS();
+
+  DebugReplay *replay = OpenReplay(flight, settings.driver);
+  if (replay == NULL)
+    return;
+
+  GlideComputerTaskEvents task_events;
+  TaskManager task_manager(task_events, *settings.way_points);
+  task_manager.set_glide_polar(settings.settings_computer.glide_polar_task);
+  Airspaces airspace_database;
+  AirspaceWarningManager airspace_warning(airspace_database, task_manager);
+  ProtectedAirspaceWarningManager airspace_warnings(airspace_warning);
+  ProtectedTaskManager protected_task_manager(task_manager,
+                                              settings.settings_computer.task,
+                                              task_events);
+
+  if (settings.airspace_path != NULL &&
+      !LoadAirspaces(airspace_database, settings.airspace_path))
+    _ftprintf(stderr, _T("Failed to load airspace file %s\n"),
+              settings.airspace_path);
+
+  if (settings.task_path != NULL &&
+      !LoadTask(protected_task_manager, settings.task_path))
+    _ftprintf(stderr, _T("Failed to load task file %s\n"),
+              settings.task_path);
+
+  GlideComputer glide_computer(*settings.way_points, airspace_database,
+                               protected_task_manager,
+                               airspace_warnings,
+                               task_events);
+  glide_computer.Initialise();
+  glide_computer.ReadSettingsComputer(settings.settings_computer);
+
+  Validity last_warning = glide_computer.Calculated().airspace_warnings.latest;
+
+  unsigned i = 0;
+  while (replay->Next()) {
+    glide_computer.ReadBlackboard(replay->Basic());
+    glide_computer.ProcessGPS();
+
+    if (++i >= settings.idle_interval) {
+      i = 0;
+      glide_computer.ProcessIdle();
+    }
+
+    const Validity &warning = glide_computer.Calculated().airspace_warnings.latest;
+    if (warning.Modified(last_warning)) {
+      last_warning = warning;
+      ++flight.airspace_warnings;
+    }
+
+    ++flight.fixes;
+  }
+
+  delete replay;
+
+  if (flight.fixes == 0) {
+    fprintf(stderr, "No GPS fixes in %s\n", flight.path.c_str());
+    return;
+  }
+
+  glide_computer.ProcessExhaustive();
+
+  flight.Copy(glide_computer.Calculated());
+  flight.success = true;
+  flight.duration_ms = MonotonicClockMS() - start_ms;
+}
+
+/**
+ * Analyses one flight per #ThreadPool part.
+ */
+class BatchJob : public ThreadPool::Job {
+  BatchFlight *flights;
+  const BatchSettings &settings;
+
+public:
+  BatchJob(BatchFlight *_flights, const BatchSettings &_settings)
+    :flights(_flights), settings(_settings) {}
+
+  virtual void RunPart(unsigned part) {
+    AnalyseFlight(flights[part], settings);
+  }
+};
+
+class FlightCollector : public File::Visitor {
+  std::vector<BatchFlight> &flights;
+
+public:
+  FlightCollector(std::vector<BatchFlight> &_flights)
+    :flights(_flights) {}
+
+  void Add(const char *path) {
+    FileLineReaderA reader(path);
+    if (reader.error()) {
+      fprintf(stderr, "Failed to open %s\n", path);
+      return;
+    }
+
+    flights.push_back(BatchFlight(path, reader.size()));
+  }
+
+  virtual void Visit(const TCHAR *path, gcc_unused const TCHAR *filename) {
+#ifdef _UNICODE
+    const NarrowPathName narrow(path);
+    const char *p = narrow;
+#else
+    const char *p = path;
+#endif
+
+    // match the extension case-insensitively, e.g. "FLIGHT.IGC"
+    if (p != NULL && (HasExtension(p, ".igc") || HasExtension(p, ".nmea")))
+      Add(p);
+  }
+};
+
+static tstring
+ToTString(const char *p)
+{
+#ifdef _UNICODE
+  return tstring(PathName(p));
+#else
+  return tstring(p);
+#endif
+}
+
+static void
+CollectFlights(std::vector<BatchFlight> &flights, const char *path)
+{
+  FlightCollector collector(flights);
+
+  const tstring tpath = ToTString(path);
+  if (Directory::Exists(tpath.c_str()))
+    Directory::VisitFiles(tpath.c_str(), collector, true);
+  else
+    collector.Add(path);
+}
+
+static void
+PrintString(const char *s)
+{
+  putchar('"');
+  for (; *s != 0; ++s) {
+    if (*s == '"' || *s == '\\')
+      putchar('\\');
+    putchar(*s);
+  }
+  putchar('"');
+}
+
+/**
+ * Print a quoted CSV field; quotes are escaped by doubling them.
+ */
+static void
+PrintCSVString(const char *s)
+{
+  putchar('"');
+  for (; *s != 0; ++s) {
+    if (*s == '"')
+      putchar('"');
+    putchar(*s);
+  }
+  putchar('"');
+}
+
+static void
+PrintCSVHeader()
+{
+  printf("file,fixes,takeoff_time,flight_time,"
+         "circling_percentage,time_climb,time_cruise,"
+         "last_thermal_average,total_height_gain,"
+         "max_thermal_height,"
+         "wind_speed,wind_bearing,"
+         "contest_score,contest_distance,contest_speed,"
+         "task_finished,task_distance,task_speed,"
+         "airspace_warnings,duration_ms\n");
+}
+
+static void
+PrintCSV(const BatchFlight &flight)
+{
+  PrintCSVString(flight.path.c_str());
+  printf(",%u,%.0f,%.0f,"
+         "%.1f,%.0f,%.0f,"
+         "%.2f,%.0f,"
+         "%.0f,"
+         "%.1f,%.0f,"
+         "%.2f,%.0f,%.2f,"
+         "%d,%.0f,%.2f,"
+         "%u,%u\n",
+         flight.fixes,
+         (double)flight.flight.takeoff_time,
+         (double)flight.flight.flight_time,
+         (double)flight.circling.circling_percentage,
+         (double)flight.circling.time_climb,
+         (double)flight.circling.time_cruise,
+         (double)flight.last_thermal_average,
+         (double)flight.circling.total_height_gain,
+         (double)flight.max_thermal_height,
+         flight.wind_available ? (double)flight.wind.norm : 0.,
+         flight.wind_available ? (double)flight.wind.bearing.value_degrees() : 0.,
+         (double)flight.contest.score,
+         (double)flight.contest.distance,
+         (double)flight.contest.speed,
+         flight.task_finished,
+         flight.task_valid ? (double)flight.task_distance : 0.,
+         flight.task_valid ? (double)flight.task_speed : 0.,
+         flight.airspace_warnings,
+         flight.duration_ms);
+}
+
+static void
+PrintJSON(const BatchFlight &flight, bool first)
+{
+  printf(first ? "  {" : ",\n  {");
+
+  printf("\"file\": ");
+  PrintString(flight.path.c_str());
+  printf(", \"fixes\": %u", flight.fixes);
+
+  printf(", \"flight\": {\"takeoff_time\": %.0f, \"flight_time\": %.0f}",
+         (double)flight.flight.takeoff_time,
+         (double)flight.flight.flight_time);
+
+  printf(", \"thermal\": {\"circling_percentage\": %.1f"
+         ", \"time_climb\": %.0f, \"time_cruise\": %.0f"
+         ", \"last_average\": %.2f, \"total_height_gain\": %.0f"
+         ", \"max_height\": %.0f}",
+         (double)flight.circling.circling_percentage,
+         (double)flight.circling.time_climb,
+         (double)flight.circling.time_cruise,
+         (double)flight.last_thermal_average,
+         (double)flight.circling.total_height_gain,
+         (double)flight.max_thermal_height);
+
+  if (flight.wind_available)
+    printf(", \"wind\": {\"speed\": %.1f, \"bearing\": %.0f}",
+           (double)flight.wind.norm,
+           (double)flight.wind.bearing.value_degrees());
+
+  printf(", \"contest\": {\"score\": %.2f, \"distance\": %.0f"
+         ", \"speed\": %.2f}",
+         (double)flight.contest.score,
+         (double)flight.contest.distance,
+         (double)flight.contest.speed);
+
+  if (flight.task_valid)
+    printf(", \"task\": {\"finished\": %s, \"distance\": %.0f"
+           ", \"speed\": %.2f}",
+           flight.task_finished ? "true" : "false",
+           (double)flight.task_distance,
+           (double)flight.task_speed);
+
+  printf(", \"airspace_warnings\": %u, \"duration_ms\": %u}",
+         flight.airspace_warnings, flight.duration_ms);
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv,
+            "[--jobs=N] [--json] [--idle=N] [--driver=NAME]\n"
+            "    [--task=FILE.tsk] [--airspace=FILE] PATH...");
+
+  BatchSettings settings;
+  settings.settings_computer.SetDefaults();
+  settings.settings_computer.glide_polar_task = GlidePolar(fixed_zero);
+  settings.idle_interval = 1;
+  settings.driver = FindDriverByName(_T("Generic"));
+  settings.task_path = NULL;
+  settings.airspace_path = NULL;
+  settings.way_points = &way_points;
+
+  unsigned jobs = ThreadPool::GetProcessorCount();
+  bool json = false;
+
+  tstring task_path, airspace_path;
+
+  std::vector<BatchFlight> flights;
+
+  while (!args.IsEmpty()) {
+    const char *arg = args.GetNext();
+
+    if (strncmp(arg, "--jobs=", 7) == 0)
+      jobs = std::max(atoi(arg + 7), 1);
+    else if (strncmp(arg, "--idle=", 7) == 0)
+      settings.idle_interval = std::max(atoi(arg + 7), 1);
+    else if (strcmp(arg, "--json") == 0)
+      json = true;
+    else if (strncmp(arg, "--driver=", 9) == 0) {
+      settings.driver = FindDriverByName(ToTString(arg + 9).c_str());
+      if (settings.driver == NULL) {
+        fprintf(stderr, "No such driver: %s\n", arg + 9);
+        return EXIT_FAILURE;
+      }
+    } else if (strncmp(arg, "--task=", 7) == 0)
+      task_path = ToTString(arg + 7);
+    else if (strncmp(arg, "--airspace=", 11) == 0)
+      airspace_path = ToTString(arg + 11);
+    else
+      CollectFlights(flights, arg);
+  }
+
+  if (!task_path.empty())
+    settings.task_path = task_path.c_str();
+  if (!airspace_path.empty())
+    settings.airspace_path = airspace_path.c_str();
+
+  if (flights.empty()) {
+    fprintf(stderr, "No flights found\n");
+    return EXIT_FAILURE;
+  }
+
+  std::stable_sort(flights.begin(), flights.end(), BatchFlight::LargerThan);
+
+  const unsigned n = flights.size();
+  const unsigned start_ms = MonotonicClockMS();
+
+  ThreadPool pool;
+  pool.SetConcurrency(std::min(jobs, n));
+
+  BatchJob job(&flights[0], settings);
+  pool.Run(job, n);
+
+  const unsigned duration_ms = MonotonicClockMS() - start_ms;
+
+  std::sort(flights.begin(), flights.end());
+
+  if (json)
+    printf("[\n");
+  else
+    PrintCSVHeader();
+
+  unsigned failed = 0, fixes = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    const BatchFlight &flight = flights[i];
+    if (!flight.success) {
+      ++failed;
+      continue;
+    }
+
+    if (json)
+      PrintJSON(flight, i == failed);
+    else
+      PrintCSV(flight);
+
+    fixes += flight.fixes;
+  }
+
+  if (json)
+    printf("\n]\n");
+
+  fprintf(stderr, "%u flights, %u fixes in %u ms, %u threads\n",
+          n - failed, fixes, duration_ms, pool.GetConcurrency());
+
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
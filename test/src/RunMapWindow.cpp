@@ -192,7 +192,7 @@ LoadFiles()
 
   terrain = RasterTerrain::OpenTerrain(NULL, operation);
 
-  WaypointGlue::LoadWaypoints(way_points, terrain, operation);
+  WaypointGlue::LoadWaypoints(way_points, terrain, NULL, operation);
 
   TLineReader *reader = OpenConfiguredTextFile(szProfileAirspaceFile);
   if (reader != NULL) {
@@ -0,0 +1,215 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Airspace/AirspaceCandidateSet.hpp"
+#include "Airspace/Airspaces.hpp"
+#include "Airspace/AirspaceCircle.hpp"
+#include "Airspace/AirspacePolygon.hpp"
+#include "Airspace/AirspaceIntersectionVisitor.hpp"
+#include "Airspace/AirspacePredicate.hpp"
+#include "Navigation/Geometry/GeoVector.hpp"
+#include "Navigation/Aircraft.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+
+typedef std::vector<const AbstractAirspace *> AirspaceList;
+
+static const GeoPoint center(Angle::degrees(fixed(7.7)),
+                             Angle::degrees(fixed(51.05)));
+
+class CollectVisitor : public AirspaceVisitor {
+public:
+  AirspaceList found;
+
+protected:
+  virtual void Visit(const AirspaceCircle &as) {
+    found.push_back(&as);
+  }
+
+  virtual void Visit(const AirspacePolygon &as) {
+    found.push_back(&as);
+  }
+};
+
+class CollectIntersectionVisitor : public AirspaceIntersectionVisitor {
+public:
+  AirspaceList found;
+  std::vector<unsigned> n_intersections;
+
+protected:
+  virtual void Visit(const AirspaceCircle &as) {
+    found.push_back(&as);
+    n_intersections.push_back(m_intersections.size());
+  }
+
+  virtual void Visit(const AirspacePolygon &as) {
+    found.push_back(&as);
+    n_intersections.push_back(m_intersections.size());
+  }
+};
+
+static AbstractAirspace *
+MakeCircle(const GeoPoint &location, fixed radius)
+{
+  AbstractAirspace *as = new AirspaceCircle(location, radius);
+
+  AirspaceAltitude base, top;
+  base.type = top.type = AirspaceAltitude::MSL;
+  top.altitude = fixed(3000);
+  as->SetProperties(_T("circle"), CLASSD, base, top);
+  return as;
+}
+
+/**
+ * Fill the store with a grid of circles, about 5 km apart.
+ */
+static void
+MakeGrid(Airspaces &airspaces)
+{
+  for (int x = -10; x <= 10; ++x) {
+    for (int y = -10; y <= 10; ++y) {
+      const GeoPoint location(center.Longitude + Angle::degrees(fixed(x) / 14),
+                              center.Latitude + Angle::degrees(fixed(y) / 20));
+      airspaces.insert(MakeCircle(location, fixed(1000 + 200 * ((x + y) & 7))));
+    }
+  }
+
+  airspaces.optimise();
+}
+
+static AirspaceList
+ToList(const Airspaces::AirspaceVector &v)
+{
+  AirspaceList list;
+  for (Airspaces::AirspaceVector::const_iterator i = v.begin();
+       i != v.end(); ++i)
+    list.push_back(i->get_airspace());
+  return list;
+}
+
+/**
+ * Run all queries of #AirspaceCandidateSet at the given location,
+ * and compare them with the same queries on the store.
+ */
+static bool
+Compare(const Airspaces &airspaces, const AirspaceCandidateSet &set,
+        const GeoPoint &location)
+{
+  CollectVisitor inside_store, inside_set;
+  airspaces.visit_inside(location, inside_store);
+  set.visit_inside(location, inside_set);
+  if (inside_store.found != inside_set.found)
+    return false;
+
+  AircraftState state;
+  state.location = location;
+  state.altitude = fixed(1000);
+  const AirspacePredicateTrue predicate;
+  if (ToList(airspaces.find_inside(state, predicate)) !=
+      ToList(set.find_inside(state, predicate)))
+    return false;
+
+  if (ToList(airspaces.find_inside(state, predicate)) != inside_store.found)
+    /* both methods must agree below the airspace tops */
+    return false;
+
+  const GeoVector vector(fixed(8000), Angle::degrees(fixed(100)));
+  CollectIntersectionVisitor intersecting_store, intersecting_set;
+  airspaces.visit_intersecting(location, vector, intersecting_store);
+  set.visit_intersecting(location, vector, intersecting_set);
+  return intersecting_store.found == intersecting_set.found &&
+    intersecting_store.n_intersections == intersecting_set.n_intersections;
+}
+
+static bool
+Contains(const AirspaceList &list, const AbstractAirspace *as)
+{
+  for (AirspaceList::const_iterator i = list.begin(); i != list.end(); ++i)
+    if (*i == as)
+      return true;
+  return false;
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(12);
+
+  Airspaces airspaces;
+  MakeGrid(airspaces);
+
+  AirspaceCandidateSet set(airspaces);
+  const fixed range(10000);
+
+  ok1(set.update(center, range));
+  ok1(set.size() > 0 && set.size() < airspaces.size());
+  ok1(!set.update(center, range));
+
+  /* move the query point out of the envelope (twice the range)
+     without updating the set */
+  const Angle bearing = Angle::degrees(fixed(50));
+  unsigned n_errors = 0;
+  for (unsigned d = 0; d <= 40000; d += 250)
+    if (!Compare(airspaces, set, GeoVector(fixed(d), bearing).end_point(center)))
+      ++n_errors;
+  ok1(n_errors == 0);
+
+  /* let the aircraft fly out of the envelope, updating the set on
+     the way */
+  n_errors = 0;
+  unsigned n_rebuilds = 0, n_steps = 0;
+  GeoPoint location = center;
+  for (unsigned d = 0; d <= 50000; d += 250, ++n_steps) {
+    location = GeoVector(fixed(d), bearing).end_point(center);
+    if (set.update(location, range))
+      ++n_rebuilds;
+    if (!Compare(airspaces, set, location))
+      ++n_errors;
+  }
+  ok1(n_errors == 0);
+  ok1(n_rebuilds > 0 && n_rebuilds < n_steps / 10);
+
+  /* add an airspace at the aircraft location; this changes the
+     serial, so the old candidates must not be used anymore */
+  const unsigned serial = airspaces.get_serial();
+  AbstractAirspace *added = MakeCircle(location, fixed(500));
+  airspaces.insert(added);
+  airspaces.optimise();
+  ok1(airspaces.get_serial() != serial);
+
+  CollectVisitor visitor;
+  set.visit_inside(location, visitor);
+  ok1(Contains(visitor.found, added));
+  ok1(Compare(airspaces, set, location));
+
+  ok1(set.update(location, range));
+  ok1(Compare(airspaces, set, location));
+
+  /* an empty store */
+  airspaces.clear();
+  set.update(location, range);
+  CollectVisitor empty;
+  set.visit_inside(location, empty);
+  ok1(empty.found.empty());
+
+  return exit_status();
+}
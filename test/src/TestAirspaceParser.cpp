@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Engine/Airspace/AbstractAirspace.hpp"
 #include "Engine/Airspace/AirspaceCircle.hpp"
 #include "Engine/Airspace/AirspacePolygon.hpp"
@@ -33,6 +34,8 @@ Copyright_License {
 #include "TestUtil.hpp"
 
 #include <tchar.h>
+#include <stdint.h>
+#include <stdio.h>
 
 struct AirspaceClassTestCouple
 {
@@ -61,14 +64,8 @@ ParseFile(const TCHAR *path, Airspaces &airspaces)
 }
 
 static void
-TestOpenAir()
+CheckOpenAir(const Airspaces &airspaces)
 {
-  Airspaces airspaces;
-  if (!ParseFile(_T("test/data/airspace/openair.txt"), airspaces)) {
-    skip(3, 0, "Failed to parse input file");
-    return;
-  }
-
   const AirspaceClassTestCouple classes[] = {
     { _T("Class-R-Test"), RESTRICT },
     { _T("Class-Q-Test"), DANGER },
@@ -167,6 +164,51 @@ TestOpenAir()
   }
 }
 
+/**
+ * Writes the airspaces to a cache file and loads them into another
+ * database.
+ */
+static bool
+SaveLoadCache(const Airspaces &airspaces, Airspaces &copy)
+{
+  std::vector<const AbstractAirspace *> list;
+  for (Airspaces::AirspaceTree::const_iterator it = airspaces.begin();
+       it != airspaces.end(); ++it)
+    list.push_back(it->get_airspace());
+
+  FILE *file = tmpfile();
+  if (file == NULL)
+    return false;
+
+  const bool success = SaveAirspaceCache(file, list) &&
+    fseek(file, 0, SEEK_SET) == 0 &&
+    LoadAirspaceCache(file, copy);
+  fclose(file);
+
+  if (success)
+    copy.optimise();
+
+  return success;
+}
+
+static void
+TestOpenAir()
+{
+  Airspaces airspaces;
+  if (!ParseFile(_T("test/data/airspace/openair.txt"), airspaces)) {
+    skip(3, 0, "Failed to parse input file");
+    return;
+  }
+
+  CheckOpenAir(airspaces);
+
+  Airspaces copy;
+  if (!ok1(SaveLoadCache(airspaces, copy)))
+    return;
+
+  CheckOpenAir(copy);
+}
+
 static void
 TestTNP()
 {
@@ -273,12 +315,69 @@ TestTNP()
   }
 }
 
+/**
+ * Loads a cache file after overwriting the airspace count in its
+ * header.
+ */
+static bool
+LoadCacheWithCount(const std::vector<const AbstractAirspace *> &list,
+                   uint32_t count, Airspaces &copy)
+{
+  FILE *file = tmpfile();
+  if (file == NULL)
+    return false;
+
+  /* the count follows the version and the four type sizes */
+  const bool success = SaveAirspaceCache(file, list) &&
+    fseek(file, 8, SEEK_SET) == 0 &&
+    fwrite(&count, sizeof(count), 1, file) == 1 &&
+    fseek(file, 0, SEEK_SET) == 0 &&
+    LoadAirspaceCache(file, copy);
+  fclose(file);
+  return success;
+}
+
+static void
+TestCacheHeader()
+{
+  const std::vector<const AbstractAirspace *> empty;
+
+  /* an empty airspace file gives an empty cache */
+  Airspaces copy;
+  ok1(LoadCacheWithCount(empty, 0, copy));
+  ok1(copy.empty());
+
+  /* a count which doesn't match the data */
+  ok1(!LoadCacheWithCount(empty, 1, copy));
+
+  Airspaces airspaces;
+  airspaces.insert(new AirspaceCircle(GeoPoint(Angle::degrees(fixed(7)),
+                                               Angle::degrees(fixed(51))),
+                                      fixed(5000)));
+  airspaces.optimise();
+  std::vector<const AbstractAirspace *> list;
+  list.push_back(airspaces.begin()->get_airspace());
+
+  ok1(LoadCacheWithCount(list, 1, copy));
+  copy.optimise();
+  ok1(copy.size() == 1);
+
+  ok1(!LoadCacheWithCount(list, 2, copy));
+  ok1(!LoadCacheWithCount(list, 0, copy));
+  ok1(!LoadCacheWithCount(list, 0xffffffff, copy));
+
+  /* nothing was added by the failed loads */
+  copy.optimise();
+  ok1(copy.size() == 1);
+}
+
 int main(int argc, char **argv)
 {
-  plan_tests(101);
+  plan_tests(151 + 9);
 
   TestOpenAir();
   TestTNP();
+  TestCacheHeader();
 
   return exit_status();
 }
@@ -0,0 +1,202 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+/*
+ * Compares the SearchPolygon kernels used by AirspacePolygon with
+ * PolygonInterior() and FlatRay::intersects_distinct() on the borders
+ * of real airspace files.
+ */
+
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Navigation/SearchPolygon.hpp"
+#include "Navigation/ConvexHull/PolygonInterior.hpp"
+#include "Navigation/TaskProjection.hpp"
+#include "Navigation/Flat/FlatRay.hpp"
+#include "IO/FileLineReader.hpp"
+#include "Operation.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <tchar.h>
+#include <stdlib.h>
+
+struct Counters {
+  unsigned n_points, n_inside, n_inside_errors;
+  unsigned n_rays, n_crossings, n_ray_errors;
+
+  Counters()
+    :n_points(0), n_inside(0), n_inside_errors(0),
+     n_rays(0), n_crossings(0), n_ray_errors(0) {}
+};
+
+static bool
+ParseFile(const TCHAR *path, Airspaces &airspaces)
+{
+  FileLineReader reader(path, ConvertLineReader::AUTO);
+
+  if (!ok1(!reader.error())) {
+    skip(1, 0, "Failed to read input file");
+    return false;
+  }
+
+  AirspaceParser parser(airspaces);
+  NullOperationEnvironment operation;
+
+  if (!ok1(parser.Parse(reader, operation)))
+    return false;
+
+  airspaces.optimise();
+  return true;
+}
+
+/** a random flat location in the given rectangle */
+static FlatGeoPoint
+RandomLocation(int x_min, int y_min, int x_max, int y_max)
+{
+  return FlatGeoPoint(x_min + rand() % (x_max - x_min + 1),
+                      y_min + rand() % (y_max - y_min + 1));
+}
+
+/**
+ * Compare all intersections found by SearchPolygon::NextIntersection()
+ * with a linear scan using FlatRay::intersects_distinct().
+ */
+static bool
+CheckIntersections(const SearchPolygon &polygon, const SearchPointVector &v,
+                   const FlatRay &ray, unsigned &n_crossings)
+{
+  const unsigned n = polygon.GetEdgeCount();
+  fixed t;
+  unsigned i = polygon.NextIntersection(ray, 0, t);
+
+  for (unsigned j = 0; j < n; ++j) {
+    const FlatRay edge(v[j].get_flatLocation(), v[j + 1].get_flatLocation());
+    fixed t_linear;
+    if (!ray.intersects_distinct(edge, t_linear))
+      continue;
+
+    if (i != j || t != t_linear)
+      return false;
+
+    ++n_crossings;
+    i = polygon.NextIntersection(ray, i + 1, t);
+  }
+
+  return i == n && t == -fixed_one;
+}
+
+static void
+CheckAirspace(const AbstractAirspace &as, const TaskProjection &projection,
+              Counters &c)
+{
+  const SearchPointVector &v = as.GetPoints();
+  if (v.size() < 2)
+    return;
+
+  SearchPolygon polygon;
+  polygon.SetLocations(v);
+  polygon.SetFlatLocations(v);
+
+  /* the projected bounds of the border, plus a margin on all sides */
+  int x_min = v.front().get_flatLocation().Longitude, x_max = x_min;
+  int y_min = v.front().get_flatLocation().Latitude, y_max = y_min;
+  for (SearchPointVector::const_iterator i = v.begin(); i != v.end(); ++i) {
+    x_min = std::min(x_min, i->get_flatLocation().Longitude);
+    x_max = std::max(x_max, i->get_flatLocation().Longitude);
+    y_min = std::min(y_min, i->get_flatLocation().Latitude);
+    y_max = std::max(y_max, i->get_flatLocation().Latitude);
+  }
+
+  const int x_margin = (x_max - x_min) / 4 + 1;
+  const int y_margin = (y_max - y_min) / 4 + 1;
+  x_min -= x_margin;
+  x_max += x_margin;
+  y_min -= y_margin;
+  y_max += y_margin;
+
+  for (unsigned i = 0; i < 200; ++i) {
+    const GeoPoint p =
+      projection.unproject(RandomLocation(x_min, y_min, x_max, y_max));
+    const bool inside = PolygonInterior(p, v);
+
+    ++c.n_points;
+    if (inside)
+      ++c.n_inside;
+
+    /* circles test their center distance, only polygons use the
+       SearchPolygon kernel */
+    if (polygon.IsInside(p) != inside ||
+        (as.shape == AbstractAirspace::POLYGON && as.Inside(p) != inside))
+      ++c.n_inside_errors;
+  }
+
+  /* rays through the area, and some through the vertices */
+  for (unsigned i = 0; i < 100; ++i) {
+    const FlatGeoPoint a = RandomLocation(x_min, y_min, x_max, y_max);
+    const FlatGeoPoint b = i % 4 == 0
+      ? v[rand() % v.size()].get_flatLocation()
+      : RandomLocation(x_min, y_min, x_max, y_max);
+
+    ++c.n_rays;
+    if (!CheckIntersections(polygon, v, FlatRay(a, b), c.n_crossings))
+      ++c.n_ray_errors;
+  }
+}
+
+static void
+TestFile(const TCHAR *path)
+{
+  Airspaces airspaces;
+  if (!ParseFile(path, airspaces)) {
+    skip(4, 0, "Failed to parse input file");
+    return;
+  }
+
+  const TaskProjection &projection = airspaces.get_task_projection();
+
+  Counters c;
+  for (Airspaces::AirspaceTree::const_iterator i = airspaces.begin();
+       i != airspaces.end(); ++i)
+    CheckAirspace(*i->get_airspace(), projection, c);
+
+  ok1(c.n_inside_errors == 0);
+  ok1(c.n_ray_errors == 0);
+
+  /* make sure the test covers both cases */
+  ok1(c.n_inside > 0 && c.n_inside < c.n_points);
+  ok1(c.n_crossings > 0);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(3 * 6);
+
+  srand(42);
+
+  TestFile(_T("test/data/airspace/openair.txt"));
+  TestFile(_T("test/data/airspace/tnp.sua"));
+  TestFile(_T("test/data/AirspaceAus-DAA.txt"));
+
+  return exit_status();
+}
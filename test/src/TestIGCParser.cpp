@@ -21,6 +21,7 @@
 */
 
 #include "Replay/IGCParser.hpp"
+#include "Replay/IGCFixArray.hpp"
 #include "DateTime.hpp"
 #include "TestUtil.hpp"
 
@@ -95,15 +96,106 @@ TestFix()
   ok1(equals(fix.location, -51.05195, -7.70611667));
   ok1(equals(fix.pressure_altitude, 10490));
   ok1(equals(fix.gps_altitude, 7));
+
+  ok1(IGCParseFix("B1122535103117S00742367WA-0012-0003", fix));
+  ok1(equals(fix.pressure_altitude, -12));
+  ok1(equals(fix.gps_altitude, -3));
+
+  /* invalid (2D) fixes are ignored */
+  ok1(!IGCParseFix("B1122385103117N00742367EV0049000487", fix));
+  ok1(!IGCParseFix("B1122385103117X00742367EA0049000487", fix));
+  ok1(!IGCParseFix("B11 2385103117N00742367EA0049000487", fix));
+}
+
+static void
+TestExtensions()
+{
+  IGCExtensions extensions;
+  ok1(!IGCParseExtensions("", extensions));
+  ok1(!IGCParseExtensions("B1122385103117N00742367EA0049000487", extensions));
+  ok1(!IGCParseExtensions("I033638FXA3940SIU41", extensions));
+
+  ok1(IGCParseExtensions("I033638FXA3940SIU4143ENL", extensions));
+  ok1(extensions.size() == 3);
+  ok1(extensions[0].start == 35);
+  ok1(extensions[0].length == 3);
+  ok1(strcmp(extensions[2].code, "ENL") == 0);
+  ok1(extensions.Find("SIU") == 1);
+  ok1(extensions.Find("TAS") == -1);
+
+  IGCFix fix;
+  ok1(IGCParseFix("B1122385103117N00742367EA004900048700512345", extensions,
+                  fix));
+  ok1(equals(fix.gps_altitude, 487));
+  ok1(fix.fxa == 5);
+  ok1(fix.siu == 12);
+  ok1(fix.enl == 345);
+  ok1(fix.tas == -1);
+
+  /* truncated record: the extensions are missing, the fix is not */
+  ok1(IGCParseFix("B1122385103117N00742367EA00490004870051", extensions,
+                  fix));
+  ok1(fix.fxa == 5);
+  ok1(fix.siu == -1);
+  ok1(fix.enl == -1);
+}
+
+static void
+TestFixArray()
+{
+  static const char data[] =
+    "AXCSfoo\r\n"
+    "HFDTE040910\r\n"
+    "I023638FXA3941ENL\r\n"
+    "B1122385103117N00742367EA0049000487005000\r\n"
+    "B1122395103117N00742367EV0049000487005000\r\n"
+    "LXCSsome comment\r\n"
+    "B1122405103118S00742368WA0049100488006012";
+
+  IGCFixArray fixes;
+  fixes.Parse(data, sizeof(data) - 1);
+
+  ok1(fixes.GetHeader() != NULL);
+  ok1(strcmp(fixes.GetHeader()->manufacturer, "XCS") == 0);
+  ok1(fixes.GetDate() != NULL);
+  ok1(fixes.GetDate()->year == 2010);
+  ok1(fixes.GetExtensions().size() == 2);
+
+  ok1(fixes.size() == 2);
+  ok1(fixes.GetTime(1) == 11 * 3600 + 22 * 60 + 40);
+  ok1(fixes.GetExtension(1, 1) == 12);
+
+  IGCFix fix;
+  fixes.Get(0, fix);
+  ok1(fix.time == BrokenTime(11, 22, 38));
+  ok1(equals(fix.location, 51.05195, 7.70611667));
+  ok1(fix.fxa == 5);
+  ok1(fix.enl == 0);
+
+  fixes.Get(1, fix);
+  ok1(equals(fix.location, -51.0519667, -7.70613333));
+  ok1(equals(fix.pressure_altitude, 491));
+  ok1(fix.enl == 12);
+
+  /* the results must be the same as the line parser's */
+  IGCFix fix2;
+  ok1(IGCParseFix("B1122405103118S00742368WA0049100488006012",
+                  fixes.GetExtensions(), fix2));
+  ok1(fix2.location.Latitude == fix.location.Latitude &&
+      fix2.location.Longitude == fix.location.Longitude &&
+      fix2.gps_altitude == fix.gps_altitude &&
+      fix2.enl == fix.enl);
 }
 
 int main(int argc, char **argv)
 {
-  plan_tests(46);
+  plan_tests(89);
 
   TestHeader();
   TestDate();
   TestFix();
+  TestExtensions();
+  TestFixArray();
 
   return exit_status();
 }
@@ -0,0 +1,98 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+/*
+ * Replays an IGC file into a trace and checks that the incremental
+ * triangle search reports the same triangle as a solver which
+ * searches every trace copy exhaustively.
+ */
+
+#include "Replay/IGCParser.hpp"
+#include "IO/FileLineReader.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "Contest/ContestSolvers/OLCTriangle.hpp"
+#include "TestUtil.hpp"
+
+static fixed
+GetScore(OLCTriangle &triangle)
+{
+  ContestResult result;
+  result.Reset();
+  triangle.Score(result);
+  return result.score;
+}
+
+static void
+TestIncremental(const char *path, bool is_fai)
+{
+  FileLineReaderA reader(path);
+  if (!ok1(!reader.error())) {
+    skip(2, 0, "Failed to open input file");
+    return;
+  }
+
+  /* a short trace keeps the exhaustive search of each copy cheap */
+  Trace trace(60, Trace::null_time, 256);
+  OLCTriangle incremental(trace, is_fai);
+  OLCTriangle exact(trace, is_fai);
+
+  unsigned n_checks = 0, n_different = 0;
+  char *line;
+  while ((line = reader.read()) != NULL) {
+    IGCFix fix;
+    if (!IGCParseFix(line, fix))
+      continue;
+
+    AircraftState state;
+    state.location = fix.location;
+    state.altitude = fix.gps_altitude;
+    state.time = fixed(fix.time.GetSecondOfDay());
+    trace.append(state);
+    trace.optimise_if_old();
+
+    incremental.Solve(false);
+    exact.Solve(true);
+
+    /* while the incremental search is running, it has not seen the
+       current trace copy yet */
+    if (incremental.IsBusy())
+      continue;
+
+    ++n_checks;
+    if (GetScore(incremental) != GetScore(exact))
+      ++n_different;
+  }
+
+  ok1(n_checks > 10);
+  ok1(n_different == 0);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(2 * 3);
+
+  TestIncremental("test/data/01lz1hq1.igc", true);
+  TestIncremental("test/data/01lz1hq1.igc", false);
+
+  return exit_status();
+}
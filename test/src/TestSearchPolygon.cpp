@@ -0,0 +1,167 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "Navigation/SearchPolygon.hpp"
+#include "Navigation/SearchPointVector.hpp"
+#include "Navigation/TaskProjection.hpp"
+#include "Navigation/Flat/FlatRay.hpp"
+#include "Navigation/Flat/FlatGeoPoint.hpp"
+#include "TestUtil.hpp"
+
+#include <stdlib.h>
+
+static const GeoPoint center(Angle::degrees(fixed(7.7)),
+                             Angle::degrees(fixed(51.05)));
+
+/** a random number in the range [min, max) */
+static int
+random(int min, int max)
+{
+  return min + rand() % (max - min);
+}
+
+/**
+ * Create a closed, star-shaped polygon with random radii around
+ * #center.
+ */
+static void
+MakeStar(SearchPointVector &v, unsigned n_vertices,
+         const TaskProjection &projection)
+{
+  v.clear();
+  for (unsigned i = 0; i < n_vertices; ++i) {
+    const Angle angle = Angle::degrees(fixed(i * 360) / n_vertices);
+    const fixed radius(random(100, 1000) / fixed(10000));
+    const GeoPoint p(center.Longitude + Angle::degrees(radius * angle.cos()),
+                     center.Latitude + Angle::degrees(radius * angle.sin()));
+    v.push_back(SearchPoint(p, projection));
+  }
+
+  v.push_back(v.front());
+}
+
+/** a random flat location near the polygon */
+static FlatGeoPoint
+RandomLocation(const FlatGeoPoint &origin, int range)
+{
+  return FlatGeoPoint(origin.Longitude + random(-range, range),
+                      origin.Latitude + random(-range, range));
+}
+
+/**
+ * Compare all intersections found by SearchPolygon::NextIntersection()
+ * with a linear scan using FlatRay::intersects_distinct().
+ */
+static bool
+CheckIntersections(const SearchPolygon &polygon, const SearchPointVector &v,
+                   const FlatRay &ray)
+{
+  const unsigned n = polygon.GetEdgeCount();
+  fixed t;
+  unsigned i = polygon.NextIntersection(ray, 0, t);
+
+  for (unsigned j = 0; j < n; ++j) {
+    const FlatRay edge(v[j].get_flatLocation(), v[j + 1].get_flatLocation());
+    fixed t_linear;
+    if (!ray.intersects_distinct(edge, t_linear))
+      continue;
+
+    if (i != j || t != t_linear)
+      return false;
+
+    i = polygon.NextIntersection(ray, i + 1, t);
+  }
+
+  return i == n && t == -fixed_one;
+}
+
+static void
+TestTree(unsigned n_vertices)
+{
+  TaskProjection projection;
+  projection.reset(center);
+  projection.update_fast();
+
+  SearchPointVector v;
+  MakeStar(v, n_vertices, projection);
+
+  SearchPolygon polygon;
+  polygon.SetLocations(v);
+  polygon.SetFlatLocations(v);
+  ok1(polygon.GetEdgeCount() == n_vertices);
+
+  const FlatGeoPoint origin = projection.project(center);
+  const int range = projection.project_range(center, fixed(15000));
+
+  /* rays of all lengths, starting inside and outside the polygon */
+  unsigned n_rays = 0, n_ray_errors = 0, n_crossings = 0;
+  for (unsigned i = 0; i < 2000; ++i) {
+    const FlatGeoPoint a = RandomLocation(origin, range);
+    const FlatGeoPoint b = i % 4 == 0
+      ? RandomLocation(a, range / 20)
+      : RandomLocation(origin, range);
+    const FlatRay ray(a, b);
+
+    ++n_rays;
+    if (!CheckIntersections(polygon, v, ray))
+      ++n_ray_errors;
+
+    fixed t;
+    if (polygon.NextIntersection(ray, 0, t) < polygon.GetEdgeCount())
+      ++n_crossings;
+  }
+
+  ok1(n_ray_errors == 0);
+  /* make sure the test covers both cases */
+  ok1(n_crossings > 0 && n_crossings < n_rays);
+
+  /* nearest points, inside and outside the polygon */
+  unsigned n_nearest_errors = 0;
+  for (unsigned i = 0; i < 2000; ++i) {
+    const FlatGeoPoint p = RandomLocation(origin, range);
+    if (!(polygon.NearestPoint(p) == v.NearestPoint(p)))
+      ++n_nearest_errors;
+  }
+
+  ok1(n_nearest_errors == 0);
+
+  /* a vertex is its own nearest point */
+  ok1(polygon.NearestPoint(v[n_vertices / 3].get_flatLocation()) ==
+      v[n_vertices / 3].get_flatLocation());
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(5 * 3);
+
+  srand(42);
+
+  /* below the threshold, no edge tree is built */
+  TestTree(40);
+
+  /* tree with partially filled leaves */
+  TestTree(201);
+
+  TestTree(1000);
+
+  return exit_status();
+}
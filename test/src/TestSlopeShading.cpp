@@ -0,0 +1,115 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Terrain/SlopeShading.hpp"
+#include "Terrain/RasterBuffer.hpp"
+#include "TestUtil.hpp"
+
+#include <stdlib.h>
+
+enum {
+  WIDTH = 67,
+  HEIGHT = 5,
+};
+
+static short heights[WIDTH * HEIGHT];
+
+static void
+FillHeights(int range, bool special)
+{
+  for (unsigned i = 0; i < WIDTH * HEIGHT; ++i) {
+    heights[i] = (short)(rand() % range);
+
+    if (special && rand() % 16 == 0)
+      heights[i] = rand() % 2 == 0
+        ? RasterBuffer::TERRAIN_INVALID
+        : RasterBuffer::TERRAIN_WATER_THRESHOLD;
+  }
+}
+
+/**
+ * Compare SlopeShadingRow() with SlopeShadingIndex() for the middle
+ * row.
+ */
+static bool
+CheckRow(unsigned q, unsigned height_slope_factor,
+         int sx, int sy, int sz, int contrast)
+{
+  const unsigned y = HEIGHT / 2;
+  const unsigned length = WIDTH - 2 * q;
+  const short *src = heights + y * WIDTH + q;
+
+  int8_t result[WIDTH];
+  SlopeShadingRow(result, src, length, WIDTH, WIDTH, q, 2,
+                  height_slope_factor, sx, sy, sz, contrast);
+
+  for (unsigned i = 0; i < length; ++i) {
+    const short *p = src + i;
+    const short h_above = p[-WIDTH], h_below = p[WIDTH];
+    const short h_left = p[-(int)q], h_right = p[q];
+
+    int expected;
+    if (RasterBuffer::is_special(h_above) ||
+        RasterBuffer::is_special(h_below) ||
+        RasterBuffer::is_special(h_left) ||
+        RasterBuffer::is_special(h_right))
+      expected = 0;
+    else
+      expected = SlopeShadingIndex(h_right - h_left, h_above - h_below,
+                                   2 * q, 2, height_slope_factor,
+                                   sx, sy, sz, contrast);
+
+    if (result[i] < -64 || result[i] > 63 ||
+        abs(result[i] - expected) > 1)
+      return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(4 * 3);
+
+  static const unsigned qs[] = { 1, 2, 3, 25 };
+
+  srand(42);
+
+  for (unsigned i = 0; i < 4; ++i) {
+    const unsigned q = qs[i];
+
+    /* flat terrain */
+    FillHeights(1, false);
+    ok1(CheckRow(q, 50, -150, 100, 150, 128));
+
+    /* hilly terrain */
+    FillHeights(3000, false);
+    ok1(CheckRow(q, 20, 150, -100, 180, 255));
+
+    /* with water and invalid pixels */
+    FillHeights(500, true);
+    ok1(CheckRow(q, 200, 0, 255, 64, 64));
+  }
+
+  return exit_status();
+}
@@ -0,0 +1,133 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Thread/ThreadPool.hpp"
+#include "Util/PerfCounters.hpp"
+#include "TestUtil.hpp"
+
+#include <string.h>
+
+enum {
+  N_PARTS = 100,
+};
+
+class CountJob : public ThreadPool::Job {
+public:
+  unsigned counts[N_PARTS];
+
+  /**
+   * The order in which the parts were run; only meaningful in
+   * single-threaded mode.
+   */
+  unsigned order[N_PARTS];
+  unsigned n;
+
+  CountJob():n(0) {
+    memset(counts, 0, sizeof(counts));
+  }
+
+  virtual void RunPart(unsigned part) {
+    ++counts[part];
+    PerfCounters::Increment(PerfCounters::COUNT_TASK_STAGES);
+
+    /* not thread-safe, but only checked in single-threaded mode */
+    if (n < N_PARTS)
+      order[n++] = part;
+  }
+
+  bool CheckCounts(unsigned n_parts, unsigned expected) const {
+    for (unsigned i = 0; i < n_parts; ++i)
+      if (counts[i] != expected)
+        return false;
+
+    for (unsigned i = n_parts; i < N_PARTS; ++i)
+      if (counts[i] != 0)
+        return false;
+
+    return true;
+  }
+};
+
+static void
+TestSingleThreaded()
+{
+  ThreadPool pool;
+  ok1(pool.GetConcurrency() == 1);
+
+  CountJob job;
+  pool.Run(job, N_PARTS);
+  ok1(job.CheckCounts(N_PARTS, 1));
+
+  bool ordered = job.n == N_PARTS;
+  for (unsigned i = 0; ordered && i < N_PARTS; ++i)
+    ordered = job.order[i] == i;
+  ok1(ordered);
+}
+
+static void
+TestMultiThreaded(unsigned concurrency)
+{
+  PerfCounters::Reset();
+
+  ThreadPool pool;
+  pool.SetConcurrency(concurrency);
+  ok1(pool.GetConcurrency() == concurrency);
+
+  CountJob job;
+  for (unsigned i = 0; i < 50; ++i)
+    pool.Run(job, N_PARTS);
+  ok1(job.CheckCounts(N_PARTS, 50));
+
+  /* fewer parts than threads */
+  CountJob job2;
+  pool.Run(job2, 1);
+  pool.Run(job2, 0);
+  ok1(job2.CheckCounts(1, 1));
+
+  /* back to single-threaded mode */
+  pool.SetConcurrency(1);
+  ok1(pool.GetConcurrency() == 1);
+
+  /* the workers have been joined, and each part was counted exactly
+     once, either by the calling thread or by a worker */
+  PerfCounters::Block calculation, workers;
+  PerfCounters::Collect(PerfCounters::CONTEXT_CALCULATION, calculation);
+  PerfCounters::Collect(PerfCounters::CONTEXT_POOL, workers);
+  ok1(calculation.counters[PerfCounters::COUNT_TASK_STAGES] +
+      workers.counters[PerfCounters::COUNT_TASK_STAGES] ==
+      50 * N_PARTS + 1);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(3 + 3 * 5);
+
+  PerfCounters::SetContext(PerfCounters::CONTEXT_CALCULATION);
+
+  TestSingleThreaded();
+  TestMultiThreaded(2);
+  TestMultiThreaded(4);
+  TestMultiThreaded(ThreadPool::MAX_WORKERS + 1);
+
+  return exit_status();
+}
@@ -0,0 +1,138 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2011 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+
+/*
+ * Checks when Trace thins itself: optimise_if_old() thins a full
+ * trace, and append() makes room in a full trace if optimise_if_old()
+ * has not been called since.
+ */
+
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+
+static const unsigned MAX_POINTS = 64;
+static const unsigned OPT_POINTS = (3 * MAX_POINTS) / 4;
+
+static void
+Append(Trace &trace, unsigned i)
+{
+  AircraftState state;
+  state.location = GeoPoint(Angle::degrees(fixed(7 + (i % 7) * 0.01)),
+                            Angle::degrees(fixed(51 + i * 0.001)));
+  state.altitude = fixed(1000);
+  state.time = fixed(10000 + 4 * i);
+  trace.append(state);
+}
+
+static unsigned
+GetFirstTime(const Trace &trace)
+{
+  TracePointVector v;
+  trace.get_trace_points(v);
+  return v.front().time;
+}
+
+static unsigned
+GetLastTime(const Trace &trace)
+{
+  TracePointVector v;
+  trace.get_trace_points(v);
+  return v.back().time;
+}
+
+/**
+ * The usual pattern: optimise_if_old() after each append().  The
+ * trace reaches #MAX_POINTS, and optimise_if_old() thins it to
+ * #OPT_POINTS; append() never needs to make room.
+ */
+static void
+TestOptimise()
+{
+  Trace trace(0, Trace::null_time, MAX_POINTS);
+
+  unsigned max_size = 0, n_thinned = 0;
+  bool thinned_to_opt = true;
+  for (unsigned i = 0; i < 4 * MAX_POINTS; ++i) {
+    Append(trace, i);
+    max_size = std::max(max_size, trace.size());
+
+    const unsigned size = trace.size();
+    if (trace.optimise_if_old()) {
+      ++n_thinned;
+      if (size != MAX_POINTS || trace.size() != OPT_POINTS)
+        thinned_to_opt = false;
+    }
+  }
+
+  ok1(max_size == MAX_POINTS);
+  ok1(n_thinned > 1);
+  ok1(thinned_to_opt);
+}
+
+/**
+ * Without optimise_if_old(), append() thins a full trace to
+ * #OPT_POINTS before adding the new point.
+ */
+static void
+TestAppend(unsigned no_thin_time)
+{
+  Trace trace(no_thin_time, Trace::null_time, MAX_POINTS);
+
+  for (unsigned i = 0; i < MAX_POINTS; ++i)
+    Append(trace, i);
+
+  ok1(trace.size() == MAX_POINTS);
+
+  Append(trace, MAX_POINTS);
+  ok1(trace.size() == OPT_POINTS + 1);
+
+  // the first and the new point are never removed
+  ok1(GetFirstTime(trace) == 10000);
+  ok1(GetLastTime(trace) == 10000 + 4 * MAX_POINTS);
+
+  unsigned max_size = 0;
+  for (unsigned i = MAX_POINTS + 1; i < 4 * MAX_POINTS; ++i) {
+    Append(trace, i);
+    max_size = std::max(max_size, trace.size());
+  }
+
+  ok1(max_size == MAX_POINTS);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(3 + 2 * 5);
+
+  TestOptimise();
+
+  TestAppend(0);
+
+  /* the "no thin" window covers the whole trace, and is ignored to
+     make room */
+  TestAppend(100000);
+
+  return exit_status();
+}
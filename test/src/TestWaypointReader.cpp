@@ -22,6 +22,8 @@
 
 #include "Waypoint/WaypointReader.hpp"
 #include "Waypoint/WaypointReaderBase.hpp"
+#include "Waypoint/WaypointCache.hpp"
+#include "Waypoint/ParsedWaypoints.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "Terrain/RasterMap.hpp"
 #include "Units/Units.hpp"
@@ -291,6 +293,108 @@ TestSeeYou(wp_vector org_wp)
   }
 }
 
+static void
+TestCache(wp_vector org_wp)
+{
+  WaypointReader f(_T("test/data/waypoints.cup"), 0);
+  ParsedWaypoints parsed;
+  NullOperationEnvironment operation;
+  if (!ok1(!f.Error() && f.Parse(parsed, operation))) {
+    skip(2 + 11 * org_wp.size(), 0, "parsing waypoint file failed");
+    return;
+  }
+
+  Waypoints way_points;
+  parsed.CopyTo(way_points);
+  way_points.optimise();
+
+  ParsedWaypoints loaded;
+  FILE *file = tmpfile();
+  const bool success = file != NULL &&
+    SaveWaypointCache(file, parsed.waypoints, NULL) &&
+    fseek(file, 0, SEEK_SET) == 0 &&
+    LoadWaypointCache(file, loaded.waypoints, NULL);
+  if (file != NULL)
+    fclose(file);
+
+  if (!ok1(success)) {
+    skip(1 + 11 * org_wp.size(), 0, "waypoint cache failed");
+    return;
+  }
+
+  Waypoints copy;
+  loaded.CopyTo(copy);
+  copy.optimise();
+  ok1(copy.size() == way_points.size());
+
+  wp_vector::iterator it;
+  for (it = org_wp.begin(); it < org_wp.end(); it++) {
+    const Waypoint *wp = GetWaypoint(*it, copy);
+    TestSeeYouWaypoint(*it, wp);
+
+    /* the cache preserves the ids */
+    const Waypoint *original = way_points.lookup_name(it->name);
+    ok1(wp != NULL && original != NULL && wp->id == original->id);
+  }
+}
+
+/**
+ * Save the waypoints to a cache file, replace the waypoint count in
+ * its header and load it again.
+ */
+static bool
+LoadCacheWithCount(const std::vector<Waypoint> &waypoints, uint32_t count,
+                   std::vector<Waypoint> &loaded)
+{
+  FILE *file = tmpfile();
+  if (file == NULL)
+    return false;
+
+  /* an empty list writes just the header, which ends with the count
+     and the size */
+  const std::vector<Waypoint> empty;
+  bool success = SaveWaypointCache(file, empty, NULL);
+  const long header_size = ftell(file);
+
+  success = success && fseek(file, 0, SEEK_SET) == 0 &&
+    SaveWaypointCache(file, waypoints, NULL) &&
+    fseek(file, header_size - 2 * sizeof(uint32_t), SEEK_SET) == 0 &&
+    fwrite(&count, sizeof(count), 1, file) == 1 &&
+    fseek(file, 0, SEEK_SET) == 0 &&
+    LoadWaypointCache(file, loaded, NULL);
+  fclose(file);
+  return success;
+}
+
+static void
+TestCacheHeader()
+{
+  const std::vector<Waypoint> empty;
+
+  /* an empty waypoint file gives an empty cache */
+  std::vector<Waypoint> loaded;
+  ok1(LoadCacheWithCount(empty, 0, loaded));
+  ok1(loaded.empty());
+
+  /* a count which doesn't match the data */
+  ok1(!LoadCacheWithCount(empty, 1, loaded));
+
+  std::vector<Waypoint> waypoints;
+  waypoints.push_back(Waypoint(GeoPoint(Angle::degrees(fixed(7)),
+                                        Angle::degrees(fixed(51)))));
+  waypoints.push_back(waypoints.front());
+
+  ok1(LoadCacheWithCount(waypoints, 2, loaded));
+  ok1(loaded.size() == 2);
+
+  ok1(!LoadCacheWithCount(waypoints, 3, loaded));
+  ok1(!LoadCacheWithCount(waypoints, 0, loaded));
+  ok1(!LoadCacheWithCount(waypoints, 0xffffffff, loaded));
+
+  /* nothing was added by the failed loads */
+  ok1(loaded.size() == 2);
+}
+
 static void
 TestZanderWaypoint(const Waypoint org_wp, const Waypoint *wp)
 {
@@ -479,12 +583,14 @@ int main(int argc, char **argv)
 {
   wp_vector org_wp = CreateOriginalWaypoints();
 
-  plan_tests(63 + 6 * 4 + (9 + 10 + 8 + 3 + 3 + 3) * org_wp.size());
+  plan_tests(63 + 6 * 4 + 3 + 9 + (9 + 10 + 11 + 8 + 3 + 3 + 3) * org_wp.size());
 
   TestExtractParameters();
 
   TestWinPilot(org_wp);
   TestSeeYou(org_wp);
+  TestCache(org_wp);
+  TestCacheHeader();
   TestZander(org_wp);
   TestFS(org_wp);
   TestFS_UTM(org_wp);
@@ -24,6 +24,7 @@
 #include "harness_task.hpp"
 #include "harness_flight.hpp"
 #include "Contest/ContestSolvers/ContestDijkstra.hpp"
+#include "Util/PerfCounters.hpp"
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -38,15 +39,6 @@ int terrain_height = 1;
 std::string replay_file = "test/data/0asljd01.igc";
 std::string task_file = "";
 
-#ifdef INSTRUMENT_TASK
-extern long count_mc;
-long count_intersections;
-long count_dijkstra_links = 0;
-long count_dijkstra_queries = 0;
-extern unsigned n_queries;
-extern unsigned count_distbearing;
-#endif
-
 #ifdef INSTRUMENT_ZERO
 extern unsigned long zero_skipped;
 extern unsigned long zero_total;
@@ -55,19 +47,30 @@ extern unsigned long zero_total;
 void distance_counts() {
   if (n_samples) {
     printf("# Instrumentation\n");
-#ifdef INSTRUMENT_TASK
-    printf("#     dist+bearing calcs/c %d\n",count_distbearing/n_samples); 
-    printf("#     mc calcs/c %d\n",(int)(count_mc/n_samples));
-    if (n_queries>0) {
-      printf("#     intersection tests/q %d\n",(unsigned)(count_intersections/n_queries));
-      printf("#    (total queries %d)\n\n",n_queries);
+    const PerfCounters::Block &counters = PerfCounters::Current();
+    const unsigned long *count = counters.counters;
+    printf("#     dist+bearing calcs/c %d\n",
+           (int)(count[PerfCounters::COUNT_DISTANCE_BEARING] / n_samples));
+    printf("#     mc calcs/c %d\n",
+           (int)(count[PerfCounters::COUNT_MACCREADY] / n_samples));
+    if (count[PerfCounters::COUNT_AIRSPACE_QUERIES] > 0) {
+      printf("#     intersection tests/q %d\n",
+             (int)(count[PerfCounters::COUNT_AIRSPACE_INTERSECTIONS] /
+                   count[PerfCounters::COUNT_AIRSPACE_QUERIES]));
+      printf("#    (total queries %d)\n\n",
+             (int)count[PerfCounters::COUNT_AIRSPACE_QUERIES]);
     }
-    if (count_dijkstra_queries>0) {
-      printf("#     dijkstra links/q %d\n", (unsigned)(count_dijkstra_links/count_dijkstra_queries));
+    if (count[PerfCounters::COUNT_DIJKSTRA_QUERIES] > 0) {
+      printf("#     dijkstra links/q %d\n",
+             (int)(count[PerfCounters::COUNT_DIJKSTRA_LINKS] /
+                   count[PerfCounters::COUNT_DIJKSTRA_QUERIES]));
     }
-#endif
-    printf("#     count_olc_solve %d\n", (int)ContestDijkstra::count_olc_solve);
-    printf("#     count_olc_trace %d\n", (int)ContestDijkstra::count_olc_trace);
+    printf("#     task stages/c %d\n",
+           (int)(count[PerfCounters::COUNT_TASK_STAGES] / n_samples));
+    printf("#     count_olc_solve %d\n",
+           (int)count[PerfCounters::COUNT_CONTEST_SOLVE]);
+    printf("#     count_olc_trace %d\n",
+           (int)count[PerfCounters::COUNT_CONTEST_TRACE]);
     printf("#     count_olc_size %d\n",ContestDijkstra::count_olc_size);
     printf("#    (total cycles %d)\n#\n",n_samples);
 #ifdef INSTRUMENT_ZERO
@@ -78,15 +81,7 @@ void distance_counts() {
 #endif
   }
   n_samples = 0;
-#ifdef INSTRUMENT_TASK
-  count_dijkstra_links = 0;
-  count_dijkstra_queries = 0;
-  count_intersections = 0;
-  n_queries = 0;
-  count_distbearing = 0;
-  count_mc = 0;
-  count_olc = 0;
-#endif
+  PerfCounters::Reset();
 #ifdef INSTRUMENT_ZERO
   zero_skipped = 0;
   zero_total = 0;
@@ -94,13 +89,16 @@ void distance_counts() {
 }
 
 void print_queries(unsigned n, std::ostream &fout) {
-#ifdef INSTRUMENT_TASK
-  if (n_queries>0) {
-    fout << n << " " << count_intersections/n_queries << "\n";
+  PerfCounters::Block &counters = PerfCounters::Current();
+  unsigned long *count = counters.counters;
+  if (count[PerfCounters::COUNT_AIRSPACE_QUERIES] > 0) {
+    fout << n << " "
+         << count[PerfCounters::COUNT_AIRSPACE_INTERSECTIONS] /
+            count[PerfCounters::COUNT_AIRSPACE_QUERIES]
+         << "\n";
   }
-  count_intersections = 0;
-  n_queries = 0;
-#endif
+  count[PerfCounters::COUNT_AIRSPACE_INTERSECTIONS] = 0;
+  count[PerfCounters::COUNT_AIRSPACE_QUERIES] = 0;
 }
 
 /** 
@@ -34,6 +34,8 @@
 #include "Navigation/Geometry/GeoVector.hpp"
 #include "Operation.hpp"
 
+#include <time.h>
+
 static void test_reach(const RasterMap& map, fixed mwind, fixed mc)
 {
   GlidePolar polar(mc);
@@ -87,6 +89,66 @@ static void test_reach(const RasterMap& map, fixed mwind, fixed mc)
   }
 }
 
+static bool
+same_reach(const TerrainRoute &a, const TerrainRoute &b, const RasterMap &map,
+           const GeoPoint &origin)
+{
+  const unsigned nx = 40, ny = 40;
+  for (unsigned i = 0; i < nx; ++i) {
+    for (unsigned j = 0; j < ny; ++j) {
+      fixed fx = (fixed)i/(nx-1)*fixed_two-fixed_one;
+      fixed fy = (fixed)j/(ny-1)*fixed_two-fixed_one;
+      GeoPoint x(origin.Longitude+Angle::degrees(fixed(0.3)*fx),
+                 origin.Latitude+Angle::degrees(fixed(0.3)*fy));
+      const AGeoPoint adest(x, map.GetInterpolatedHeight(x));
+      short ha, hd, hb, hdb;
+      a.find_positive_arrival(adest, ha, hd);
+      b.find_positive_arrival(adest, hb, hdb);
+      if (ha != hb || hd != hdb)
+        return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Solve the reach again with the same inputs, which must not change
+ * it, and with a different polar, which must.
+ */
+static void test_reach_repeat(const RasterMap& map, fixed mwind, fixed mc)
+{
+  GlidePolar polar(mc), polar2(mc + fixed(2));
+  SpeedVector wind(Angle::degrees(fixed(0)), mwind);
+  TerrainRoute route, route_full;
+  route.update_polar(polar, polar, wind);
+  route.set_terrain(&map);
+  route_full.update_polar(polar2, polar2, wind);
+  route_full.set_terrain(&map);
+
+  const GeoPoint origin(map.GetMapCenter());
+  const AGeoPoint aorigin(origin, map.GetHeight(origin)+1000);
+
+  clock_t t = clock();
+  route.solve_reach(aorigin);
+  const clock_t t_full = clock() - t;
+
+  const unsigned n = 10;
+  t = clock();
+  for (unsigned i = 0; i < n; ++i)
+    route.solve_reach(aorigin);
+  const clock_t t_repeat = (clock() - t) / n;
+
+  printf("# reach full solve %g ms, repeated %g ms\n",
+         (double)t_full * 1000 / CLOCKS_PER_SEC,
+         (double)t_repeat * 1000 / CLOCKS_PER_SEC);
+
+  route.update_polar(polar2, polar2, wind);
+  route.solve_reach(aorigin);
+  route_full.solve_reach(aorigin);
+  ok(same_reach(route, route_full, map, origin),
+     "reach solved again after polar change", 0);
+}
+
 int main(int argc, char** argv) {
 
   const char hc_path[] = "tmp/terrain";
@@ -111,8 +173,9 @@ int main(int argc, char** argv) {
     map.SetViewCenter(map.GetMapCenter(), fixed(100000));
   } while (map.IsDirty());
 
-  plan_tests(1);
+  plan_tests(2);
   test_reach(map, fixed_zero, fixed(0.1));
+  test_reach_repeat(map, fixed_zero, fixed(0.1));
 
   return exit_status();
 }
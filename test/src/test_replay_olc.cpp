@@ -8,6 +8,7 @@
 #include "SettingsComputer.hpp"
 
 #include <fstream>
+#include <string>
 
 ContestResult official_score_classic,
   official_score_sprint,
@@ -123,9 +124,14 @@ protected:
   }
 };
 
-static bool
-test_replay(const Contests olc_type, 
-            const ContestResult &official_score)
+/**
+ * Replay the flight, solving directly on the TraceComputer traces and
+ * on copies of them, and check both results against the official
+ * score.
+ */
+static void
+test_replay(const Contests olc_type,
+            const ContestResult &official_score, const char *name)
 {
   std::ofstream f("results/res-sample.txt");
 
@@ -186,6 +192,13 @@ test_replay(const Contests olc_type,
                                  trace_computer.GetSprint());
   contest_manager.SetHandicap(settings_computer.task.contest_handicap);
 
+  /* solve on copies as well, the way ContestThread does */
+  Trace full, sprint;
+  unsigned trace_serial = 0;
+
+  ContestManager copy_contest_manager(olc_type, full, sprint);
+  copy_contest_manager.SetHandicap(settings_computer.task.contest_handicap);
+
   while (sim.Update()) {
     if (sim.state.time>time_last) {
 
@@ -195,8 +208,10 @@ test_replay(const Contests olc_type,
 
       trace_computer.Update(settings_computer, sim.state);
       trace_computer.Idle(settings_computer, sim.state);
+      trace_computer.LockedCopyTo(full, sprint, trace_serial);
 
       contest_manager.UpdateIdle();
+      copy_contest_manager.UpdateIdle();
   
       state_last = sim.state;
 
@@ -214,12 +229,20 @@ test_replay(const Contests olc_type,
   sim.Stop();
 
   contest_manager.SolveExhaustive();
+  copy_contest_manager.SolveExhaustive();
 
   if (verbose) {
     distance_counts();
   }
-  return compare_scores(official_score, 
-                        contest_manager.GetStats().get_contest_result(0));
+
+  ok(compare_scores(official_score,
+                    contest_manager.GetStats().get_contest_result(0)),
+     name, 0);
+
+  const std::string copy_name = std::string(name) + " on trace copies";
+  ok(compare_scores(official_score,
+                    copy_contest_manager.GetStats().get_contest_result(0)),
+     copy_name.c_str(), 0);
 }
 
 
@@ -229,13 +252,13 @@ int main(int argc, char** argv)
     return 0;
   }
 
-  plan_tests(5);
+  plan_tests(2 * 5);
 
-  ok(test_replay(OLC_League, official_score_sprint),"replay league",0);
-  ok(test_replay(OLC_FAI, official_score_fai),"replay fai",0);
-  ok(test_replay(OLC_Classic, official_score_classic),"replay classic",0);
-  ok(test_replay(OLC_Sprint, official_score_sprint),"replay sprint",0);
-  ok(test_replay(OLC_Plus, official_score_plus),"replay plus",0);
+  test_replay(OLC_League, official_score_sprint, "replay league");
+  test_replay(OLC_FAI, official_score_fai, "replay fai");
+  test_replay(OLC_Classic, official_score_classic, "replay classic");
+  test_replay(OLC_Sprint, official_score_sprint, "replay sprint");
+  test_replay(OLC_Plus, official_score_plus, "replay plus");
 
   return exit_status();
 }
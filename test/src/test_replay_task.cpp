@@ -7,6 +7,7 @@
 #include "Computer/FlyingComputer.hpp"
 
 #include <fstream>
+#include <time.h>
 
 #include "Util/Deserialiser.hpp"
 #include "Util/DataNodeXML.hpp"
@@ -129,6 +130,9 @@ test_replay()
   FlyingComputer flying_computer;
   flying_computer.Reset();
 
+  /* CPU time spent in the task manager, for benchmarking */
+  clock_t update_time = 0;
+
   while (sim.Update()) {
     if (sim.state.time>time_last) {
 
@@ -136,8 +140,10 @@ test_replay()
 
       flying_computer.Compute(glide_polar, sim.state, sim.state);
 
+      const clock_t start = clock();
       task_manager.update(sim.state, state_last);
       task_manager.update_idle(sim.state);
+      update_time += clock() - start;
       task_manager.update_auto_mc(sim.state, fixed_zero);
       task_manager.get_task_advance().set_armed(true);
 
@@ -157,6 +163,10 @@ test_replay()
   sim.Stop();
 
   if (verbose) {
+    printf("# task update time %u (ms), %u (us/c)\n",
+           (unsigned)(update_time * 1000 / CLOCKS_PER_SEC),
+           (unsigned)(update_time * 1000000 / CLOCKS_PER_SEC /
+                      (n_samples > 0 ? n_samples : 1)));
     distance_counts();
     printf("# task elapsed %d (s)\n", (int)task_manager.get_stats().total.time_elapsed);
     printf("# task speed %3.1f (kph)\n", (int)task_manager.get_stats().total.travelled.get_speed()*3.6);